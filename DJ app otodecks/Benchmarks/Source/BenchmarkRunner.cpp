@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    BenchmarkRunner.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "BenchmarkRunner.h"
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+BenchmarkRunner::BenchmarkRunner(int _warmupIterations, int _measuredIterations)
+    : warmupIterations(_warmupIterations),
+    measuredIterations(_measuredIterations)
+{
+}
+
+void BenchmarkRunner::run(const String& name,
+                          const NamedValueSet& params,
+                          double itemsPerIteration,
+                          const String& itemUnit,
+                          double realtimeSecondsPerIteration,
+                          std::function<void()> body)
+{
+    runIterations(name, params, measuredIterations, itemsPerIteration,
+                  itemUnit, realtimeSecondsPerIteration, body);
+}
+
+void BenchmarkRunner::runIterations(const String& name,
+                                    const NamedValueSet& params,
+                                    int iterations,
+                                    double itemsPerIteration,
+                                    const String& itemUnit,
+                                    double realtimeSecondsPerIteration,
+                                    std::function<void()> body)
+{
+    for (int i = 0; i < jmin(warmupIterations, iterations); ++i)
+    {
+        body();
+    }
+
+    std::vector<double> timesNs;
+    timesNs.reserve((size_t) iterations);
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = Time::getHighResolutionTicks();
+        body();
+        auto end = Time::getHighResolutionTicks();
+        timesNs.push_back(Time::highResolutionTicksToSeconds(end - start) * 1.0e9);
+    }
+
+    std::sort(timesNs.begin(), timesNs.end());
+
+    Result result;
+    result.name = name;
+    result.params = params;
+    result.iterations = iterations;
+    result.itemsPerIteration = itemsPerIteration;
+    result.itemUnit = itemUnit;
+    result.realtimeSecondsPerIteration = realtimeSecondsPerIteration;
+
+    if (!timesNs.empty())
+    {
+        double total = 0;
+        for (double t : timesNs)
+        {
+            total += t;
+        }
+
+        result.minNs = timesNs.front();
+        result.maxNs = timesNs.back();
+        result.meanNs = total / (double) timesNs.size();
+        result.medianNs = timesNs[timesNs.size() / 2];
+    }
+
+    results.add(result);
+}
+
+void BenchmarkRunner::skip(const String& name, const NamedValueSet& params, const String& reason)
+{
+    Result result;
+    result.name = name;
+    result.params = params;
+    result.skippedReason = reason;
+    results.add(result);
+}
+
+var BenchmarkRunner::toJSON() const
+{
+    DynamicObject::Ptr root = new DynamicObject();
+    root->setProperty("suite", "OtoDecksBenchmarks");
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("timestamp", Time::getCurrentTime().toISO8601(true));
+
+    DynamicObject::Ptr system = new DynamicObject();
+    system->setProperty("os", SystemStats::getOperatingSystemName());
+    system->setProperty("cpuVendor", SystemStats::getCpuVendor());
+    system->setProperty("cpuMHz", SystemStats::getCpuSpeedInMegahertz());
+    system->setProperty("numCpus", SystemStats::getNumCpus());
+    system->setProperty("juce", SystemStats::getJUCEVersion());
+    root->setProperty("system", var(system.get()));
+
+    Array<var> resultList;
+    for (const Result& r : results)
+    {
+        DynamicObject::Ptr entry = new DynamicObject();
+        entry->setProperty("name", r.name);
+
+        DynamicObject::Ptr params = new DynamicObject();
+        for (const NamedValueSet::NamedValue& p : r.params)
+        {
+            params->setProperty(p.name, p.value);
+        }
+        entry->setProperty("params", var(params.get()));
+
+        if (r.skippedReason.isNotEmpty())
+        {
+            entry->setProperty("skipped", r.skippedReason);
+        }
+        else
+        {
+            entry->setProperty("iterations", r.iterations);
+            entry->setProperty("min_ns", r.minNs);
+            entry->setProperty("median_ns", r.medianNs);
+            entry->setProperty("mean_ns", r.meanNs);
+            entry->setProperty("max_ns", r.maxNs);
+
+            if (r.itemsPerIteration > 0 && r.medianNs > 0)
+            {
+                entry->setProperty("item_unit", r.itemUnit);
+                entry->setProperty("items_per_second", r.itemsPerIteration / (r.medianNs * 1.0e-9));
+            }
+
+            if (r.realtimeSecondsPerIteration > 0 && r.medianNs > 0)
+            {
+                entry->setProperty("realtime_factor", r.realtimeSecondsPerIteration / (r.medianNs * 1.0e-9));
+            }
+        }
+
+        resultList.add(var(entry.get()));
+    }
+    root->setProperty("results", resultList);
+
+    return var(root.get());
+}
+
+String BenchmarkRunner::getSummary() const
+{
+    String summary;
+
+    for (const Result& r : results)
+    {
+        String line = r.name;
+        for (const NamedValueSet::NamedValue& p : r.params)
+        {
+            line << " " << p.name.toString() << "=" << p.value.toString();
+        }
+
+        if (r.skippedReason.isNotEmpty())
+        {
+            line << "  skipped (" << r.skippedReason << ")";
+        }
+        else
+        {
+            line << "  median " << String(r.medianNs / 1000.0, 2) << " us"
+                 << "  min " << String(r.minNs / 1000.0, 2) << " us";
+
+            if (r.realtimeSecondsPerIteration > 0 && r.medianNs > 0)
+            {
+                line << "  " << String(r.realtimeSecondsPerIteration / (r.medianNs * 1.0e-9), 1) << "x realtime";
+            }
+        }
+
+        summary << line << newLine;
+    }
+
+    return summary;
+}
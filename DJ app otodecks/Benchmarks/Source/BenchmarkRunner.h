@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    BenchmarkRunner.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+//==============================================================================
+/*
+    Times small pieces of code and collects the results so they can be written
+    out as JSON. Every case is warmed up first, then timed one iteration at a
+    time so we can report min/median/mean/max instead of a single average.
+*/
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(int warmupIterations, int measuredIterations);
+
+    // time body() and record it under name.
+    // itemsPerIteration/itemUnit describe the work done by one call (e.g. 512 "samples")
+    // and realtimeSecondsPerIteration is the amount of audio produced, or 0 if not audio
+    void run(const String& name,
+             const NamedValueSet& params,
+             double itemsPerIteration,
+             const String& itemUnit,
+             double realtimeSecondsPerIteration,
+             std::function<void()> body);
+
+    // same as run() but with an explicit iteration count, for cases that are too
+    // slow to repeat the default number of times
+    void runIterations(const String& name,
+                       const NamedValueSet& params,
+                       int iterations,
+                       double itemsPerIteration,
+                       const String& itemUnit,
+                       double realtimeSecondsPerIteration,
+                       std::function<void()> body);
+
+    // record a case that was not run, with the reason
+    void skip(const String& name, const NamedValueSet& params, const String& reason);
+
+    // the whole run as a JSON object
+    var toJSON() const;
+
+    // a one-line-per-case summary for the console
+    String getSummary() const;
+
+private:
+    struct Result
+    {
+        String name;
+        NamedValueSet params;
+        int iterations = 0;
+        double minNs = 0, medianNs = 0, meanNs = 0, maxNs = 0;
+        double itemsPerIteration = 0;
+        String itemUnit;
+        double realtimeSecondsPerIteration = 0;
+        String skippedReason;
+    };
+
+    int warmupIterations;
+    int measuredIterations;
+    Array<Result> results;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkRunner)
+};
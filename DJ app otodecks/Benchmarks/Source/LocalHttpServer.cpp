@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    LocalHttpServer.cpp
+    Created: 19 Oct 2026 11:02:15pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LocalHttpServer.h"
+
+//==============================================================================
+LocalHttpServer::LocalHttpServer(const File& fileToServe, int maxBytesPerSecond)
+    : Thread("Local HTTP server"),
+      file(fileToServe),
+      bytesPerSecond(maxBytesPerSecond)
+{
+}
+
+LocalHttpServer::~LocalHttpServer()
+{
+    signalThreadShouldExit();
+    listener.close();
+    stopThread(2000);
+}
+
+bool LocalHttpServer::start()
+{
+    for (int candidate = firstPort; candidate < firstPort + 100; ++candidate)
+    {
+        if (listener.createListener(candidate, "127.0.0.1"))
+        {
+            port = candidate;
+            startThread();
+            return true;
+        }
+    }
+    return false;
+}
+
+URL LocalHttpServer::getURL(const String& path) const
+{
+    return URL("http://127.0.0.1:" + String(port) + "/" + path);
+}
+
+void LocalHttpServer::run()
+{
+    while (!threadShouldExit())
+    {
+        if (listener.waitUntilReady(true, 100) != 1)
+        {
+            continue;
+        }
+
+        std::unique_ptr<StreamingSocket> connection(listener.waitForNextConnection());
+        if (connection != nullptr)
+        {
+            serve(*connection);
+        }
+    }
+}
+
+void LocalHttpServer::serve(StreamingSocket& connection)
+{
+    // the request line and headers, up to the blank line
+    String request;
+    char buffer[1024];
+    while (!request.contains("\r\n\r\n"))
+    {
+        if (threadShouldExit() || connection.waitUntilReady(true, 2000) != 1)
+        {
+            return;
+        }
+
+        const int num = connection.read(buffer, (int) sizeof(buffer), false);
+        if (num <= 0)
+        {
+            return;
+        }
+        request += String(buffer, (size_t) num);
+    }
+    ++numRequests;
+
+    const int64 totalLength = file.getSize();
+    int64 start = 0;
+    int64 end = totalLength - 1;
+    bool partial = false;
+
+    for (const String& line : StringArray::fromLines(request))
+    {
+        if (line.startsWithIgnoreCase("Range: bytes="))
+        {
+            const String range = line.fromFirstOccurrenceOf("=", false, false);
+            const String last = range.fromFirstOccurrenceOf("-", false, false).trim();
+            start = jlimit((int64) 0, totalLength - 1, range.upToFirstOccurrenceOf("-", false, false).getLargeIntValue());
+            end = last.isEmpty() ? totalLength - 1 : jlimit(start, totalLength - 1, last.getLargeIntValue());
+            partial = true;
+        }
+    }
+
+    String header = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    if (partial)
+    {
+        header << "Content-Range: bytes " << start << "-" << end << "/" << totalLength << "\r\n";
+    }
+    header << "Content-Length: " << (end - start + 1) << "\r\n"
+           << "Accept-Ranges: bytes\r\n"
+           << "Connection: close\r\n\r\n";
+
+    if (connection.write(header.toRawUTF8(), (int) header.getNumBytesAsUTF8()) < 0)
+    {
+        return;
+    }
+
+    FileInputStream in(file);
+    if (in.failedToOpen() || !in.setPosition(start))
+    {
+        return;
+    }
+
+    HeapBlock<char> block((size_t) blockSize);
+    for (int64 left = end - start + 1; left > 0 && !threadShouldExit();)
+    {
+        const int num = in.read(block, (int) jmin((int64) blockSize, left));
+        if (num <= 0 || connection.write(block, num) != num)
+        {
+            return;
+        }
+        left -= num;
+
+        if (bytesPerSecond > 0)
+        {
+            Thread::sleep((int) ((int64) num * 1000 / bytesPerSecond));
+        }
+    }
+}
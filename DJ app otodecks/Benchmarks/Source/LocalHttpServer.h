@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    LocalHttpServer.h
+    Created: 19 Oct 2026 11:02:15pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Serves one file over HTTP on 127.0.0.1, with range requests, so remote
+    tracks can be benchmarked without a network. Whatever path is asked for
+    gets the same file, which lets every run use a URL the stream cache hasn't
+    seen. Connections are served one at a time and closed after each response,
+    at bytesPerSecond if it is above 0, like a slow link.
+*/
+class LocalHttpServer : private Thread
+{
+public:
+    LocalHttpServer(const File& fileToServe, int bytesPerSecond);
+    ~LocalHttpServer() override;
+
+    // false if no port could be opened
+    bool start();
+
+    // http://127.0.0.1:port/path
+    URL getURL(const String& path) const;
+
+    int getNumRequests() const { return numRequests.load(); }
+
+private:
+    void run() override;
+    void serve(StreamingSocket& connection);
+
+    static constexpr int firstPort = 18130;
+    static constexpr int blockSize = 16384;
+
+    File file;
+    int bytesPerSecond;
+    StreamingSocket listener;
+    int port = 0;
+    std::atomic<int> numRequests{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LocalHttpServer)
+};
@@ -0,0 +1,1063 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 9:10:02am
+    Author:  kavya
+
+    Console benchmarks for the OtoDecks hot paths. Results are written as JSON
+    so they can be compared between releases:
+
+        OtoDecksBenchmarks [--output results.json] [--quick]
+                           [--iterations N] [--import-budget SECONDS]
+
+    The glitch stress runs also need no sound card, so they work on headless CI.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BenchmarkRunner.h"
+#include "LocalHttpServer.h"
+#include "../../Source/DJAudioPlayer.h"
+#include "../../Source/PlaylistComponent.h"
+#include "../../Source/RealtimeLog.h"
+#include "../../Source/MasterLimiter.h"
+#include "../../Source/DeckMixer.h"
+#include "../../Source/VirtualAudioDevice.h"
+
+//==============================================================================
+namespace
+{
+    const double benchSampleRate = 44100.0;
+    const int benchBlockSize = 512;
+
+    // fill a buffer with a sine plus some noise so codecs have something real to chew on
+    void fillTestSignal(AudioBuffer<float>& buffer, double sampleRate)
+    {
+        Random random(1234);
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            float* data = buffer.getWritePointer(channel);
+            double phase = channel * 0.25;
+            const double delta = MathConstants<double>::twoPi * 220.0 / sampleRate;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                data[i] = 0.4f * (float) std::sin(phase) + 0.1f * (random.nextFloat() * 2.0f - 1.0f);
+                phase += delta;
+            }
+        }
+    }
+
+    // write a buffer to disk with the given format, returns false if the format can't write it
+    bool writeAudioFile(AudioFormat& format, const File& file, const AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+
+        auto* stream = new FileOutputStream(file);
+        std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream,
+                                                                         sampleRate,
+                                                                         (unsigned int) buffer.getNumChannels(),
+                                                                         16,
+                                                                         {},
+                                                                         0));
+        if (writer == nullptr)
+        {
+            delete stream;
+            return false;
+        }
+
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    // a 30 second stereo track in every format we can write
+    Array<File> createPlayerFixtures(const File& dir)
+    {
+        AudioBuffer<float> track(2, (int) (benchSampleRate * 30.0));
+        fillTestSignal(track, benchSampleRate);
+
+        WavAudioFormat wav;
+        AiffAudioFormat aiff;
+        FlacAudioFormat flac;
+        OggVorbisAudioFormat ogg;
+        AudioFormat* formats[] = { &wav, &aiff, &flac, &ogg };
+
+        Array<File> fixtures;
+        for (AudioFormat* format : formats)
+        {
+            File file = dir.getChildFile("fixture" + format->getFileExtensions()[0]);
+            if (writeAudioFile(*format, file, track, benchSampleRate))
+            {
+                fixtures.add(file);
+            }
+        }
+        return fixtures;
+    }
+
+    //==============================================================================
+    void benchmarkPlayer(BenchmarkRunner& runner, TrackDecoder& decoder, const Array<File>& fixtures)
+    {
+        AudioBuffer<float> buffer(2, benchBlockSize);
+        AudioSourceChannelInfo info(&buffer, 0, benchBlockSize);
+
+        for (const File& file : fixtures)
+        {
+            for (double speed : { 0.5, 1.0, 1.5, 3.0 })
+            {
+                DJAudioPlayer player{ decoder };
+                player.prepareToPlay(benchBlockSize, benchSampleRate);
+                player.loadURL(URL{ file });
+
+                // time the playback, not the background decode
+                if (auto track = decoder.open(URL{ file }))
+                {
+                    track->waitUntilDecoded(30000);
+                }
+                player.setSpeed(speed);
+                player.start();
+
+                NamedValueSet params;
+                params.set("format", file.getFileExtension().substring(1));
+                params.set("speed", speed);
+                params.set("block_size", benchBlockSize);
+
+                runner.run("DJAudioPlayer::getNextAudioBlock", params,
+                           benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                           [&]
+                           {
+                               // stay away from the end of the track so the transport keeps playing
+                               if (player.getPositionRelative() > 0.9)
+                               {
+                                   player.setPosition(0.0);
+                               }
+                               player.getNextAudioBlock(info);
+                           });
+
+                player.stop();
+                player.releaseResources();
+            }
+        }
+    }
+
+    // reading a block out of a track held as floats and as 16 bit, which is
+    // what the deck does every callback. The memory each takes goes in the params
+    void benchmarkTrackStorage(BenchmarkRunner& runner, AudioFormatManager& formatManager, const Array<File>& fixtures)
+    {
+        if (fixtures.isEmpty())
+        {
+            return;
+        }
+
+        AudioBuffer<float> buffer(2, benchBlockSize);
+
+        for (bool compact : { false, true })
+        {
+            // a decoder each, so the track isn't shared between the two
+            TrackDecoder decoder{ formatManager };
+            decoder.setCompactStorage(compact);
+
+            DecodedTrack::Ptr track = decoder.open(URL{ fixtures.getFirst() });
+            if (track == nullptr || !track->waitUntilDecoded(30000))
+            {
+                continue;
+            }
+
+            NamedValueSet params;
+            params.set("storage", compact ? "int16" : "float32");
+            params.set("block_size", benchBlockSize);
+            params.set("bytes_per_minute", (double) track->getMemoryUsage() / track->getLengthInSeconds() * 60.0);
+
+            int64 position = 0;
+            runner.run("DecodedTrack::read", params,
+                       benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                       [&]
+                       {
+                           if (position + benchBlockSize > track->getLengthInSamples())
+                           {
+                               position = 0;
+                           }
+                           track->read(buffer, 0, position, benchBlockSize);
+                           position += benchBlockSize;
+                       });
+        }
+    }
+
+    void benchmarkMixer(BenchmarkRunner& runner)
+    {
+        AudioBuffer<float> content(2, (int) benchSampleRate);
+        fillTestSignal(content, benchSampleRate);
+
+        AudioBuffer<float> buffer(2, benchBlockSize);
+        AudioSourceChannelInfo info(&buffer, 0, benchBlockSize);
+
+        for (int numInputs : { 2, 4, 8 })
+        {
+            MixerAudioSource mixer;
+            OwnedArray<MemoryAudioSource> inputs;
+
+            for (int i = 0; i < numInputs; ++i)
+            {
+                inputs.add(new MemoryAudioSource(content, false, true));
+                mixer.addInputSource(inputs.getLast(), false);
+            }
+            mixer.prepareToPlay(benchBlockSize, benchSampleRate);
+
+            NamedValueSet params;
+            params.set("inputs", numInputs);
+            params.set("block_size", benchBlockSize);
+
+            runner.run("MixerAudioSource::getNextAudioBlock", params,
+                       benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                       [&] { mixer.getNextAudioBlock(info); });
+
+            mixer.removeAllInputs();
+            mixer.releaseResources();
+        }
+    }
+
+    // both decks playing through the app's own mixer on a stereo device, then
+    // on a four channel one with the cue summed and routed to outputs 3/4 as
+    // well. The second should cost barely more than the first
+    void benchmarkDeckMixer(BenchmarkRunner& runner, TrackDecoder& decoder, const Array<File>& fixtures)
+    {
+        if (fixtures.isEmpty())
+        {
+            return;
+        }
+
+        const File fixture = fixtures.getFirst();
+        if (auto track = decoder.open(URL{ fixture }))
+        {
+            track->waitUntilDecoded(30000);
+        }
+
+        for (int numOutputs : { 2, 4 })
+        {
+            DJAudioPlayer player1{ decoder }, player2{ decoder };
+            DeckMixer mixer{ &player1, &player2 };
+            mixer.setCueMix(0.5f);
+
+            for (DJAudioPlayer* player : { &player1, &player2 })
+            {
+                player->prepareToPlay(benchBlockSize, benchSampleRate);
+                player->loadURL(URL{ fixture });
+                player->setCueEnabled(numOutputs > 2);
+                player->start();
+            }
+            mixer.prepareToPlay(benchBlockSize, benchSampleRate);
+
+            AudioBuffer<float> buffer(numOutputs, benchBlockSize);
+            AudioSourceChannelInfo info(&buffer, 0, benchBlockSize);
+
+            NamedValueSet params;
+            params.set("outputs", numOutputs);
+            params.set("cue", numOutputs > 2);
+            params.set("block_size", benchBlockSize);
+
+            runner.run("DeckMixer::getNextAudioBlock", params,
+                       benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                       [&]
+                       {
+                           for (DJAudioPlayer* player : { &player1, &player2 })
+                           {
+                               if (player->getPositionRelative() > 0.9)
+                               {
+                                   player->setPosition(0.0);
+                               }
+                           }
+                           mixer.getNextAudioBlock(info);
+                           mixer.routeCue(info);
+                       });
+
+            for (DJAudioPlayer* player : { &player1, &player2 })
+            {
+                player->stop();
+                player->releaseResources();
+            }
+        }
+    }
+
+    // a deck on its line input with the loop recorder running. An impulse on the
+    // input should come out in the same sample of the same block, so the
+    // latency that goes in the params has to be 0
+    void benchmarkLineInput(BenchmarkRunner& runner, TrackDecoder& decoder)
+    {
+        DJAudioPlayer player{ decoder };
+        DeckMixer mixer{ &player };
+        player.prepareToPlay(benchBlockSize, benchSampleRate);
+        mixer.prepareToPlay(benchBlockSize, benchSampleRate);
+        player.getLoopRecorder().setLength(20.0);
+        player.setLineInput(true);
+
+        AudioBuffer<float> input(2, benchBlockSize);
+        fillTestSignal(input, benchSampleRate);
+        AudioBuffer<float> buffer(2, benchBlockSize);
+        AudioSourceChannelInfo info(&buffer, 0, benchBlockSize);
+
+        // the device puts its inputs in the buffer it wants the output in
+        auto callback = [&]
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                buffer.copyFrom(channel, 0, input, channel, 0, benchBlockSize);
+            }
+            mixer.getNextAudioBlock(info);
+        };
+
+        // the block it is switched on crossfades from the track, the next is just the input
+        callback();
+        input.clear();
+        input.setSample(0, 100, 1.0f);
+        input.setSample(1, 100, 1.0f);
+        callback();
+
+        int latency = -1;
+        for (int i = 0; i < benchBlockSize && latency < 0; ++i)
+        {
+            if (buffer.getSample(0, i) > 0.5f)
+            {
+                latency = i - 100;
+            }
+        }
+
+        fillTestSignal(input, benchSampleRate);
+
+        NamedValueSet params;
+        params.set("block_size", benchBlockSize);
+        params.set("loop_recorder_seconds", player.getLoopRecorder().getLength());
+        params.set("latency_samples", latency);
+
+        runner.run("DJAudioPlayer line input", params,
+                   benchBlockSize, "samples", benchBlockSize / benchSampleRate, callback);
+
+        player.releaseResources();
+    }
+
+    // two decks, the mixer and the limiter, what the app plays on every callback
+    struct MasterChain : public AudioSource
+    {
+        MasterChain(TrackDecoder& decoder) : player1{ decoder }, player2{ decoder } {}
+
+        void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override
+        {
+            for (DJAudioPlayer* player : { &player1, &player2 })
+            {
+                player->prepareToPlay(samplesPerBlockExpected, sampleRate);
+            }
+            mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+            limiter.prepareToPlay(samplesPerBlockExpected, sampleRate);
+        }
+
+        void releaseResources() override
+        {
+            for (DJAudioPlayer* player : { &player1, &player2 })
+            {
+                player->releaseResources();
+            }
+            mixer.releaseResources();
+        }
+
+        void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override
+        {
+            mixer.getNextAudioBlock(bufferToFill);
+            limiter.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+        }
+
+        DJAudioPlayer player1, player2;
+        DeckMixer mixer{ &player1, &player2 };
+        MasterLimiter limiter;
+    };
+
+    // a clean sine on both decks through the master chain on the virtual device,
+    // with the device made worse each time. Anything the device finds goes in the
+    // params: the first case should have nothing, the spikes must be caught.
+    // Then one block of the chain is timed at that buffer size
+    void benchmarkGlitchStress(BenchmarkRunner& runner, TrackDecoder& decoder, const File& workDir, bool quick)
+    {
+        // 441 Hz fits exactly 100 samples, so the track has no click anywhere
+        AudioBuffer<float> sine(2, (int) (benchSampleRate * 30.0));
+        for (int channel = 0; channel < sine.getNumChannels(); ++channel)
+        {
+            for (int i = 0; i < sine.getNumSamples(); ++i)
+            {
+                sine.setSample(channel, i, 0.25f * (float) std::sin(MathConstants<double>::twoPi * 441.0 * i / benchSampleRate));
+            }
+        }
+
+        WavAudioFormat wav;
+        const File fixture = workDir.getChildFile("sine.wav");
+        if (!writeAudioFile(wav, fixture, sine, benchSampleRate))
+        {
+            return;
+        }
+        if (auto track = decoder.open(URL{ fixture }))
+        {
+            track->waitUntilDecoded(30000);
+        }
+
+        struct Scenario
+        {
+            int bufferSize;
+            double jitterMs, cpuLoad;
+            int spikeInterval;
+            double spikeLoad;
+        };
+        const Scenario scenarios[] = {
+            { 512, 0.0, 0.0, 0, 0.0 },
+            { 128, 1.0, 0.5, 0, 0.0 },
+            { 256, 0.5, 0.3, 50, 1.2 },
+        };
+        const double seconds = quick ? 5.0 : 20.0;
+
+        for (const Scenario& scenario : scenarios)
+        {
+            MasterChain chain{ decoder };
+            for (DJAudioPlayer* player : { &chain.player1, &chain.player2 })
+            {
+                player->loadURL(URL{ fixture });
+                player->start();
+            }
+
+            VirtualAudioDevice::Settings settings;
+            settings.sampleRate = benchSampleRate;
+            settings.bufferSize = scenario.bufferSize;
+            settings.jitterMs = scenario.jitterMs;
+            settings.cpuLoad = scenario.cpuLoad;
+            settings.spikeInterval = scenario.spikeInterval;
+            settings.spikeLoad = scenario.spikeLoad;
+            settings.numBlocks = (int64) (seconds * benchSampleRate / scenario.bufferSize);
+            settings.maxRecordSeconds = 0;
+
+            AudioSourcePlayer sourcePlayer;
+            sourcePlayer.setSource(&chain);
+
+            VirtualAudioDevice device(VirtualAudioDeviceType::deviceName, settings);
+            BigInteger outputs;
+            outputs.setRange(0, 2, true);
+            device.open({}, outputs, benchSampleRate, scenario.bufferSize);
+            device.start(&sourcePlayer);
+            device.waitUntilFinished(-1);
+            device.stop();
+            device.close();
+
+            const VirtualAudioDevice::Report report = device.getReport();
+
+            NamedValueSet params;
+            params.set("block_size", scenario.bufferSize);
+            params.set("jitter_ms", scenario.jitterMs);
+            params.set("cpu_load", scenario.cpuLoad);
+            params.set("spike_every", scenario.spikeInterval);
+            params.set("spike_load", scenario.spikeLoad);
+            params.set("blocks", report.blocks);
+            params.set("worst_callback_ms", report.worstCallbackMs);
+            params.set("missed_deadlines", report.missedDeadlines);
+            params.set("clicks", report.clicks);
+            params.set("silence_gaps", report.silenceGaps);
+
+            AudioBuffer<float> buffer(2, scenario.bufferSize);
+            AudioSourceChannelInfo info(&buffer, 0, scenario.bufferSize);
+            chain.prepareToPlay(scenario.bufferSize, benchSampleRate);
+
+            runner.run("VirtualAudioDevice glitch stress", params,
+                       scenario.bufferSize, "samples", scenario.bufferSize / benchSampleRate,
+                       [&]
+                       {
+                           for (DJAudioPlayer* player : { &chain.player1, &chain.player2 })
+                           {
+                               if (player->getPositionRelative() > 0.9)
+                               {
+                                   player->setPosition(0.0);
+                               }
+                           }
+                           chain.getNextAudioBlock(info);
+                       });
+
+            sourcePlayer.setSource(nullptr);
+            for (DJAudioPlayer* player : { &chain.player1, &chain.player2 })
+            {
+                player->stop();
+                player->releaseResources();
+            }
+        }
+    }
+
+    // metering is done for every deck and the master on every callback, so it
+    // has to be a small fraction of the mixer's cost
+    void benchmarkMeter(BenchmarkRunner& runner)
+    {
+        AudioBuffer<float> buffer(2, benchBlockSize);
+        fillTestSignal(buffer, benchSampleRate);
+
+        LevelMeter meter;
+        meter.prepareToPlay(benchSampleRate);
+
+        NamedValueSet params;
+        params.set("channels", buffer.getNumChannels());
+        params.set("block_size", benchBlockSize);
+
+        runner.run("LevelMeter::process", params,
+                   benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                   [&] { meter.process(buffer, 0, benchBlockSize); });
+    }
+
+    // the limiter on a mix that is well over the ceiling, down to the small blocks
+    // low latency devices use
+    void benchmarkLimiter(BenchmarkRunner& runner)
+    {
+        AudioBuffer<float> content(2, (int) benchSampleRate);
+        fillTestSignal(content, benchSampleRate);
+        content.applyGain(4.0f);
+
+        for (int blockSize : { 64, 512 })
+        {
+            MasterLimiter limiter;
+            limiter.prepareToPlay(blockSize, benchSampleRate);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            int position = 0;
+
+            NamedValueSet params;
+            params.set("block_size", blockSize);
+            params.set("latency_samples", limiter.getLatencyInSamples());
+
+            runner.run("MasterLimiter::process", params,
+                       blockSize, "samples", blockSize / benchSampleRate,
+                       [&]
+                       {
+                           if (position + blockSize > content.getNumSamples())
+                           {
+                               position = 0;
+                           }
+                           for (int channel = 0; channel < 2; ++channel)
+                           {
+                               buffer.copyFrom(channel, 0, content, channel, position, blockSize);
+                           }
+                           limiter.process(buffer, 0, blockSize);
+                           position += blockSize;
+                       });
+        }
+    }
+
+    // each deck effect on its own, and the whole rack bypassed, which should
+    // cost next to nothing
+    void benchmarkDeckEffects(BenchmarkRunner& runner)
+    {
+        AudioBuffer<float> content(2, benchBlockSize);
+        fillTestSignal(content, benchSampleRate);
+        AudioBuffer<float> buffer(2, benchBlockSize);
+
+        for (int enabled = -1; enabled < DeckEffectsRack::numEffects; ++enabled)
+        {
+            DeckEffectsRack rack;
+            rack.prepareToPlay(benchBlockSize, benchSampleRate);
+            if (enabled >= 0)
+            {
+                rack.getEffect(enabled).setEnabled(true);
+            }
+
+            NamedValueSet params;
+            params.set("effect", enabled >= 0 ? rack.getEffect(enabled).getName() : String("bypassed"));
+            params.set("block_size", benchBlockSize);
+
+            runner.run("DeckEffectsRack::process", params,
+                       benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                       [&]
+                       {
+                           buffer.makeCopyOf(content, true);
+                           rack.process(buffer, 0, benchBlockSize, 2.0);
+                       });
+        }
+    }
+
+    // a follower at 124 BPM locking onto a 128 BPM leader, over six minutes of
+    // blocks. The cost per block is timed, and the worst drift once locked
+    // (after 20 s) goes in the params, it should stay well under 1 ms
+    void benchmarkTempoSync(BenchmarkRunner& runner)
+    {
+        DeckScheduler::Timeline leader, follower;
+        leader.setBeatGrid({ 128.0, 0.05 });
+        follower.setBeatGrid({ 124.0, 0.31 });
+
+        TempoSync sync;
+        int64 time = 0;
+        double leaderPosition = 10.0, followerPosition = 3.0, followerSpeed = 1.0, maxDriftMs = 0;
+
+        auto step = [&]
+        {
+            leaderPosition += (double) benchBlockSize / benchSampleRate;
+            leader.publish(time + benchBlockSize, leaderPosition, 0.0, 1.0 / benchSampleRate, true);
+
+            followerSpeed = sync.process(follower, leader, time, benchBlockSize, benchSampleRate);
+            followerPosition += followerSpeed * benchBlockSize / benchSampleRate;
+            time += benchBlockSize;
+            follower.publish(time, followerPosition, 0.0, followerSpeed / benchSampleRate, true);
+        };
+
+        leader.publish(time, leaderPosition, 0.0, 1.0 / benchSampleRate, true);
+        follower.publish(time, followerPosition, 0.0, followerSpeed / benchSampleRate, true);
+        while (time < (int64) (benchSampleRate * 360.0))
+        {
+            step();
+            if (time > (int64) (benchSampleRate * 20.0))
+            {
+                maxDriftMs = jmax(maxDriftMs, std::abs(sync.getPhaseErrorMs()));
+            }
+        }
+
+        NamedValueSet params;
+        params.set("block_size", benchBlockSize);
+        params.set("max_drift_ms", maxDriftMs);
+
+        runner.run("TempoSync::process", params, 1, "blocks", benchBlockSize / benchSampleRate, step);
+    }
+
+    void benchmarkTimeStretch(BenchmarkRunner& runner)
+    {
+        AudioBuffer<float> content(2, (int) benchSampleRate * 10);
+        fillTestSignal(content, benchSampleRate);
+
+        AudioBuffer<float> buffer(2, benchBlockSize);
+        AudioSourceChannelInfo info(&buffer, 0, benchBlockSize);
+
+        // the key lock budget is 2% of a core per deck in high quality, i.e. a realtime factor of 50
+        for (auto quality : { TimeStretchSource::Quality::high, TimeStretchSource::Quality::eco })
+        {
+            for (double tempo : { 0.8, 1.0, 1.25 })
+            {
+                MemoryAudioSource memory(content, false, true);
+                TimeStretchSource stretch(&memory);
+                stretch.setQuality(quality);
+                stretch.setTempo(tempo);
+                stretch.prepareToPlay(benchBlockSize, benchSampleRate);
+
+                NamedValueSet params;
+                params.set("quality", quality == TimeStretchSource::Quality::high ? "high" : "eco");
+                params.set("tempo", tempo);
+                params.set("block_size", benchBlockSize);
+
+                runner.run("TimeStretchSource::getNextAudioBlock", params,
+                           benchBlockSize, "samples", benchBlockSize / benchSampleRate,
+                           [&] { stretch.getNextAudioBlock(info); });
+
+                stretch.releaseResources();
+            }
+        }
+    }
+
+    void benchmarkThumbnail(BenchmarkRunner& runner, AudioFormatManager& formatManager, const Array<File>& fixtures)
+    {
+        // the peak building itself, fed straight from memory
+        const double seconds = 300.0;
+        AudioBuffer<float> track(2, (int) (benchSampleRate * seconds));
+        fillTestSignal(track, benchSampleRate);
+
+        {
+            AudioThumbnailCache cache{ 1 };
+            AudioThumbnail thumb(1000, formatManager, cache); // what WaveformDisplay used before the coloured peaks
+            const int chunk = 4096;
+
+            NamedValueSet params;
+            params.set("seconds", seconds);
+            params.set("samples_per_thumb_sample", 1000);
+
+            runner.runIterations("AudioThumbnail::addBlock", params, 10,
+                                 track.getNumSamples(), "samples", seconds,
+                                 [&]
+                                 {
+                                     thumb.reset(track.getNumChannels(), benchSampleRate, track.getNumSamples());
+                                     for (int pos = 0; pos < track.getNumSamples(); pos += chunk)
+                                     {
+                                         thumb.addBlock(pos, track, pos, jmin(chunk, track.getNumSamples() - pos));
+                                     }
+                                 });
+        }
+
+        // the coloured peaks the decoder works out for WaveformDisplay, which should
+        // run well over 100x realtime
+        {
+            WaveformPeaks peaks(track.getNumSamples());
+            WaveformPeaks::Analyser analyser(benchSampleRate);
+
+            NamedValueSet params;
+            params.set("seconds", seconds);
+            params.set("samples_per_block", WaveformPeaks::samplesPerBlock);
+
+            runner.runIterations("WaveformPeaks::Analyser::process", params, 10,
+                                 track.getNumSamples(), "samples", seconds,
+                                 [&] { analyser.process(track, 0, 0, track.getNumSamples(), peaks); });
+        }
+
+        // the whole thing as WaveformDisplay::loadURL used to do it, decoding the file on the cache thread
+        for (const File& file : fixtures)
+        {
+            NamedValueSet params;
+            params.set("format", file.getFileExtension().substring(1));
+            params.set("seconds", 30.0);
+
+            runner.runIterations("AudioThumbnail::setSource", params, 5,
+                                 0, {}, 30.0,
+                                 [&]
+                                 {
+                                     // a fresh cache every time, otherwise the second run is a cache hit
+                                     AudioThumbnailCache cache{ 1 };
+                                     AudioThumbnail thumb(1000, formatManager, cache);
+                                     thumb.setSource(new FileInputSource(file));
+                                     while (!thumb.isFullyLoaded())
+                                     {
+                                         Thread::sleep(1);
+                                     }
+                                 });
+        }
+
+        // a whole track load through the shared decoder: one decode, which works out
+        // the peaks as it goes, and the length taken from it instead of reading the file again
+        for (const File& file : fixtures)
+        {
+            NamedValueSet params;
+            params.set("format", file.getFileExtension().substring(1));
+            params.set("seconds", 30.0);
+
+            runner.runIterations("TrackDecoder::open", params, 5,
+                                 0, {}, 30.0,
+                                 [&]
+                                 {
+                                     // a fresh decoder every time, otherwise the second run is a cache hit
+                                     TrackDecoder decoder{ formatManager };
+                                     DecodedTrack::Ptr track = decoder.open(URL{ file });
+                                     if (track == nullptr)
+                                     {
+                                         return;
+                                     }
+                                     track->waitUntilDecoded(30000);
+
+                                     TrackInfo info;
+                                     decoder.getInfo(URL{ file }, info);
+                                 });
+        }
+    }
+
+    //==============================================================================
+    // open() only starts a remote track connecting, it is there once the first buffer is in
+    DecodedTrack::Ptr openRemote(TrackDecoder& decoder, const URL& url)
+    {
+        const uint32 giveUpTime = Time::getMillisecondCounter() + 30000;
+        DecodedTrack::Ptr track;
+        while ((track = decoder.open(url)) == nullptr && Time::getMillisecondCounter() < giveUpTime)
+        {
+            Thread::sleep(1);
+        }
+        return track;
+    }
+
+    // the remote track against the same file decoded straight from disk
+    bool matchesLocalDecode(AudioFormatManager& formatManager, const File& file, const DecodedTrack& track)
+    {
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples != track.getLengthInSamples())
+        {
+            return false;
+        }
+
+        const int numSamples = (int) reader->lengthInSamples;
+        AudioBuffer<float> local(track.getNumChannels(), numSamples);
+        AudioBuffer<float> remote(track.getNumChannels(), numSamples);
+        reader->read(&local, 0, numSamples, 0, true, track.getNumChannels() > 1);
+        track.read(remote, 0, 0, numSamples);
+
+        for (int channel = 0; channel < remote.getNumChannels(); ++channel)
+        {
+            FloatVectorOperations::subtract(remote.getWritePointer(channel), local.getReadPointer(channel), numSamples);
+        }
+        return remote.getMagnitude(0, numSamples) < 1.0e-6f;
+    }
+
+    // a track streamed from a local HTTP server through the range cache, served at
+    // about four times the rate it plays at. Before the timed runs, one pass checks
+    // the remote decode against the local one and times a seek three quarters in,
+    // which the cache should fetch ahead of everything before it
+    void benchmarkRemoteTrack(BenchmarkRunner& runner, AudioFormatManager& formatManager, const Array<File>& fixtures)
+    {
+        for (const File& file : fixtures)
+        {
+            const String format = file.getFileExtension().substring(1);
+            if (format != "wav" && format != "flac")
+            {
+                continue;
+            }
+
+            const int bytesPerSecond = (int) jmax((int64) 65536, file.getSize() / 30 * 4);
+
+            NamedValueSet params;
+            params.set("format", format);
+            params.set("seconds", 30.0);
+            params.set("server_bytes_per_second", bytesPerSecond);
+
+            LocalHttpServer server(file, bytesPerSecond);
+            if (!server.start())
+            {
+                runner.skip("TrackDecoder::open remote", params, "no local port to serve from");
+                continue;
+            }
+
+            {
+                const URL url = server.getURL("check/" + file.getFileName());
+                RangeCache::forget(url);
+
+                double firstBufferMs = -1;
+                double seekMs = -1;
+                bool matches = false;
+                {
+                    TrackDecoder decoder{ formatManager };
+                    const double startMs = Time::getMillisecondCounterHiRes();
+                    if (DecodedTrack::Ptr track = openRemote(decoder, url))
+                    {
+                        firstBufferMs = Time::getMillisecondCounterHiRes() - startMs;
+
+                        const int64 seekSample = track->getLengthInSamples() * 3 / 4;
+                        const double seekStartMs = Time::getMillisecondCounterHiRes();
+                        track->requestDecodeAt(seekSample);
+                        while (!track->isSampleDecoded(seekSample)
+                               && Time::getMillisecondCounterHiRes() - seekStartMs < 30000)
+                        {
+                            Thread::sleep(1);
+                        }
+                        seekMs = Time::getMillisecondCounterHiRes() - seekStartMs;
+
+                        matches = track->waitUntilDecoded(60000) && matchesLocalDecode(formatManager, file, *track);
+                    }
+                }
+                RangeCache::forget(url);
+
+                params.set("first_buffer_ms", firstBufferMs);
+                params.set("seek_ms", seekMs);
+                params.set("matches_local_decode", matches);
+            }
+
+            // every run from a URL the cache hasn't seen, which is thrown away after it
+            int run = 0;
+            runner.runIterations("TrackDecoder::open remote", params, 3,
+                                 0, {}, 30.0,
+                                 [&]
+                                 {
+                                     const URL url = server.getURL("run" + String(run++) + "/" + file.getFileName());
+                                     {
+                                         TrackDecoder decoder{ formatManager };
+                                         if (DecodedTrack::Ptr track = openRemote(decoder, url))
+                                         {
+                                             track->waitUntilDecoded(60000);
+                                         }
+                                     }
+                                     RangeCache::forget(url);
+                                 });
+        }
+    }
+
+    //==============================================================================
+    File getTinyTrackFile(const File& dir, int index)
+    {
+        return dir.getChildFile("track_" + String(index).paddedLeft('0', 6) + ".wav");
+    }
+
+    // make sure dir holds at least numTracks tiny wav files
+    void createTinyTracks(const File& dir, int numTracks)
+    {
+        dir.createDirectory();
+
+        WavAudioFormat wav;
+        AudioBuffer<float> silence(1, 64);
+        silence.clear();
+
+        for (int i = 0; i < numTracks; ++i)
+        {
+            File file = getTinyTrackFile(dir, i);
+            if (!file.existsAsFile())
+            {
+                writeAudioFile(wav, file, silence, 8000.0);
+            }
+        }
+    }
+
+    void writePlaylistFile(const File& playlistFile, const File& trackDir, int numTracks)
+    {
+        XmlElement playlist("PLAYLIST");
+        for (int i = 0; i < numTracks; ++i)
+        {
+            File file = getTinyTrackFile(trackDir, i);
+            auto* track = playlist.createNewChildElement("TRACK");
+            track->setAttribute("title", file.getFileNameWithoutExtension());
+            track->setAttribute("url", URL(file).toString(false));
+            track->setAttribute("length", String(180.0 + i % 120));
+        }
+        playlist.writeToFile(playlistFile, "");
+    }
+
+    void benchmarkPlaylist(BenchmarkRunner& runner,
+                           TrackDecoder& decoder,
+                           const File& workDir,
+                           const Array<int>& sizes,
+                           double importBudgetSeconds)
+    {
+        AudioThumbnailCache cache{ 1 };
+        File trackDir = workDir.getChildFile("tracks");
+
+        // parsing a saved playlist
+        File savedPlaylist = workDir.getChildFile("SavedPlaylist.xml");
+        for (int numTracks : sizes)
+        {
+            writePlaylistFile(savedPlaylist, trackDir, numTracks);
+
+            PlaylistComponent playlist{ nullptr, nullptr, nullptr, nullptr, decoder, cache, savedPlaylist };
+
+            NamedValueSet params;
+            params.set("tracks", numTracks);
+
+            runner.runIterations("PlaylistComponent::loadPlaylist", params, numTracks >= 100000 ? 3 : 10,
+                                 numTracks, "tracks", 0,
+                                 [&] { playlist.loadPlaylist(); });
+        }
+
+        // importing files one by one, as drag and drop does. This is expected to grow
+        // faster than linearly, so each size is only run if the previous one suggests
+        // it will finish inside the budget
+        File importPlaylist = workDir.getChildFile("ImportPlaylist.xml");
+        double lastSeconds = 0;
+        int lastSize = 0;
+
+        for (int numTracks : sizes)
+        {
+            NamedValueSet params;
+            params.set("tracks", numTracks);
+
+            if (lastSize > 0)
+            {
+                double growth = (double) numTracks / (double) lastSize;
+                double projectedSeconds = lastSeconds * growth * growth;
+                if (projectedSeconds > importBudgetSeconds)
+                {
+                    runner.skip("PlaylistComponent::addToPlaylist", params,
+                                "projected " + String(projectedSeconds, 1) + " s exceeds the import budget");
+                    continue;
+                }
+            }
+
+            createTinyTracks(trackDir, numTracks);
+            importPlaylist.deleteFile();
+
+            auto start = Time::getHighResolutionTicks();
+            {
+                PlaylistComponent playlist{ nullptr, nullptr, nullptr, nullptr, decoder, cache, importPlaylist };
+
+                runner.runIterations("PlaylistComponent::addToPlaylist", params, 1,
+                                     numTracks, "tracks", 0,
+                                     [&]
+                                     {
+                                         // no playlist file yet, so this just empties the table
+                                         playlist.loadPlaylist();
+                                         for (int i = 0; i < numTracks; ++i)
+                                         {
+                                             playlist.addToPlaylist(getTinyTrackFile(trackDir, i));
+                                         }
+                                     });
+            }
+            lastSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+            lastSize = numTracks;
+            importPlaylist.deleteFile();
+        }
+    }
+
+    //==============================================================================
+    // what a warning from the audio thread costs. The writer drains to nowhere so
+    // only the caller's side is timed
+    void benchmarkLog(BenchmarkRunner& runner)
+    {
+        std::ostream discard(nullptr);
+        RealtimeLog::Writer writer(discard);
+
+        NamedValueSet params;
+        params.set("capacity", RealtimeLog::capacity);
+
+        runner.run("RealtimeLog::write", params, 1, "messages", 0,
+                   [&] { RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::setGain gain should be between 0 and 1, got %f", 1.5); });
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray args;
+    for (int i = 1; i < argc; ++i)
+    {
+        args.add(argv[i]);
+    }
+
+    const bool quick = args.contains("--quick");
+    int iterations = quick ? 200 : 2000;
+    double importBudgetSeconds = 60.0;
+    File outputFile;
+
+    if (args.indexOf("--iterations") >= 0)
+    {
+        iterations = jmax(1, args[args.indexOf("--iterations") + 1].getIntValue());
+    }
+    if (args.indexOf("--import-budget") >= 0)
+    {
+        importBudgetSeconds = args[args.indexOf("--import-budget") + 1].getDoubleValue();
+    }
+    if (args.indexOf("--output") >= 0)
+    {
+        outputFile = File::getCurrentWorkingDirectory().getChildFile(args[args.indexOf("--output") + 1]);
+    }
+
+    Array<int> playlistSizes{ 1000, 10000 };
+    if (!quick)
+    {
+        playlistSizes.add(100000);
+    }
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    TrackDecoder decoder{ formatManager };
+
+    File workDir = File::getSpecialLocation(File::tempDirectory).getChildFile("OtoDecksBenchmarks");
+    workDir.deleteRecursively();
+    workDir.createDirectory();
+
+    BenchmarkRunner runner(iterations / 10, iterations);
+
+    Array<File> fixtures = createPlayerFixtures(workDir);
+    benchmarkPlayer(runner, decoder, fixtures);
+    benchmarkTrackStorage(runner, formatManager, fixtures);
+    benchmarkMixer(runner);
+    benchmarkDeckMixer(runner, decoder, fixtures);
+    benchmarkLineInput(runner, decoder);
+    benchmarkGlitchStress(runner, decoder, workDir, quick);
+    benchmarkMeter(runner);
+    benchmarkLimiter(runner);
+    benchmarkDeckEffects(runner);
+    benchmarkTempoSync(runner);
+    benchmarkTimeStretch(runner);
+    benchmarkLog(runner);
+    benchmarkThumbnail(runner, formatManager, fixtures);
+    benchmarkRemoteTrack(runner, formatManager, fixtures);
+    benchmarkPlaylist(runner, decoder, workDir, playlistSizes, importBudgetSeconds);
+
+    workDir.deleteRecursively();
+
+    String json = JSON::toString(runner.toJSON());
+    if (outputFile != File())
+    {
+        outputFile.replaceWithText(json);
+        std::cout << runner.getSummary();
+    }
+    else
+    {
+        // keep stdout machine readable
+        std::cerr << runner.getSummary();
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
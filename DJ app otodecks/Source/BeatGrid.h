@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    BeatGrid.h
+    Created: 19 Oct 2026 1:05:31pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+/*
+    Tempo and phase of a track: its BPM and where the first beat falls.
+*/
+struct BeatGrid
+{
+    double bpm = 120.0;
+    double firstBeatSeconds = 0.0;
+
+    bool isValid() const { return bpm > 0.0; }
+    double getSecondsPerBeat() const { return 60.0 / bpm; }
+};
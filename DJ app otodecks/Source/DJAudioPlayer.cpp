@@ -9,52 +9,348 @@ Author:  matthew
 */
 
 #include "DJAudioPlayer.h"
+#include "RealtimeLog.h"
 
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager& _formatManager) 
-: formatManager(_formatManager)
+namespace
 {
+    // how much audio is copied out for every hot cue
+    const double cueWindowSeconds = 2.0;
+}
 
+DJAudioPlayer::DJAudioPlayer(TrackDecoder& _decoder) 
+: decoder(_decoder)
+{
+    transportSource.addChangeListener(this);
 }
 DJAudioPlayer::~DJAudioPlayer()
 {
-
+    cancelPendingUpdate();
+    transportSource.removeChangeListener(this);
+    transportSource.setSource(nullptr);
 }
 
 void DJAudioPlayer::prepareToPlay (int samplesPerBlockExpected, double sampleRate) 
 {
     transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    stretchSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    jogSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    effects.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    meter.prepareToPlay(sampleRate);
+    loopRecorder.prepareToPlay(sampleRate);
+    outputSampleRate = sampleRate;
 }
 void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    resampleSource.getNextAudioBlock(bufferToFill);
+    process(bufferToFill, nullptr, nullptr);
+}
 
+void DJAudioPlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill, AudioBuffer<float>& cueBus,
+                                       const AudioBuffer<float>* lineInput)
+{
+    process(bufferToFill, &cueBus, lineInput);
+}
+
+void DJAudioPlayer::process(const AudioSourceChannelInfo& bufferToFill, AudioBuffer<float>* cueBus,
+                            const AudioBuffer<float>* lineInput)
+{
+    // the track is left where it is while the line input plays
+    const bool useInput = lineInputEnabled.load();
+    if (!useInput || !wasLineInput)
+    {
+        renderTrack(bufferToFill);
+    }
+    else
+    {
+        sampleTime += bufferToFill.numSamples;
+    }
+    if (useInput || wasLineInput)
+    {
+        renderLineInput(bufferToFill, lineInput, useInput);
+    }
+
+    // where the track got to, for lining events up with its beats. The read
+    // position is a few samples ahead of what's heard because of the resampler
+    const double trackRate = trackSource.getCurrentSampleRate();
+    const double speed = keyLock.load() ? stretchSource.getTempo() : resampleSource.getResamplingRatio();
+    timeline.publish(sampleTime,
+                     trackRate > 0 ? loopCueSource.getNextReadPosition() / trackRate : 0.0,
+                     trackRate > 0 ? loopCueSource.getTotalLength() / trackRate : 0.0,
+                     speed / outputSampleRate,
+                     isPlaying() && !jogSource.isActive() && !useInput);
+
+    // tempo synced effects follow the deck's beats at its current speed
+    effects.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                    speed / timeline.getSecondsPerBeat());
+
+    // PFL, fading in or out over a block when it is switched
+    const float targetCueGain = cueEnabled.load() ? 1.0f : 0.0f;
+    if (cueBus != nullptr && (targetCueGain > 0.0f || appliedCueGain > 0.0f) && bufferToFill.buffer->getNumChannels() > 0)
+    {
+        const int numCueChannels = jmin(cueBus->getNumChannels(), 2);
+        for (int channel = 0; channel < numCueChannels; ++channel)
+        {
+            const int sourceChannel = jmin(channel, bufferToFill.buffer->getNumChannels() - 1);
+            cueBus->addFromWithRamp(channel, 0, bufferToFill.buffer->getReadPointer(sourceChannel, bufferToFill.startSample),
+                                    bufferToFill.numSamples, appliedCueGain, targetCueGain);
+        }
+    }
+    appliedCueGain = cueBus != nullptr ? targetCueGain : 0.0f;
+
+    const float targetVolume = volume.load();
+    if (targetVolume != 1.0f || appliedVolume != 1.0f)
+    {
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples,
+                                           appliedVolume, targetVolume);
+        appliedVolume = targetVolume;
+    }
+
+    meter.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    const float targetCrossfaderGain = crossfaderGain.load();
+    if (targetCrossfaderGain != 1.0f || appliedCrossfaderGain != 1.0f)
+    {
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples,
+                                           appliedCrossfaderGain, targetCrossfaderGain);
+        appliedCrossfaderGain = targetCrossfaderGain;
+    }
+
+    // the track source moved on to the preloaded track during this block
+    if (trackSource.getTrackChangeCount() != lastTrackChangeCount)
+    {
+        lastTrackChangeCount = trackSource.getTrackChangeCount();
+        loopCueSource.inputTrackChanged();
+        triggerAsyncUpdate();
+    }
+}
+
+void DJAudioPlayer::renderTrack(const AudioSourceChannelInfo& bufferToFill)
+{
+    // a follower works its speed out afresh every block
+    const DeckScheduler::Timeline* leader = syncLeader.load();
+    if (leader != nullptr && leader->isPlaying() && timeline.isPlaying())
+    {
+        applySpeed(tempoSync.process(timeline, *leader, sampleTime, bufferToFill.numSamples, outputSampleRate));
+        wasSyncing = true;
+    }
+    else if (wasSyncing)
+    {
+        tempoSync.reset();
+        applySpeed(userSpeed.load());
+        wasSyncing = false;
+    }
+
+    // a scheduled event splits the block, so it happens at its exact sample
+    scheduler.collect(timeline);
+    const int64 blockEnd = sampleTime + bufferToFill.numSamples;
+    int done = 0;
+
+    DeckScheduler::Event event;
+    while (scheduler.popNextDue(blockEnd, event))
+    {
+        const int offset = (int) jlimit((int64) done, (int64) bufferToFill.numSamples, event.time - sampleTime);
+        if (offset > done)
+        {
+            renderBlock(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + done, offset - done));
+            done = offset;
+        }
+        performEvent(event);
+    }
+    if (done < bufferToFill.numSamples)
+    {
+        renderBlock(AudioSourceChannelInfo(bufferToFill.buffer, bufferToFill.startSample + done,
+                                           bufferToFill.numSamples - done));
+    }
+    sampleTime = blockEnd;
+}
+
+void DJAudioPlayer::renderLineInput(const AudioSourceChannelInfo& bufferToFill, const AudioBuffer<float>* lineInput,
+                                    bool useInput)
+{
+    AudioBuffer<float>& buffer = *bufferToFill.buffer;
+    const int numSamples = bufferToFill.numSamples;
+    const bool hasInput = lineInput != nullptr && lineInput->getNumChannels() > 0
+                          && lineInput->getNumSamples() >= numSamples;
+
+    // the track fades out or in under the input, or isn't there at all
+    if (useInput && wasLineInput)
+    {
+        buffer.clear(bufferToFill.startSample, numSamples);
+    }
+    else
+    {
+        buffer.applyGainRamp(bufferToFill.startSample, numSamples, useInput ? 1.0f : 0.0f, useInput ? 0.0f : 1.0f);
+    }
+
+    if (hasInput)
+    {
+        const float startGain = wasLineInput ? 1.0f : 0.0f;
+        const float endGain = useInput ? 1.0f : 0.0f;
+        for (int channel = 0; channel < jmin(buffer.getNumChannels(), 2); ++channel)
+        {
+            const int sourceChannel = jmin(channel, lineInput->getNumChannels() - 1);
+            buffer.addFromWithRamp(channel, bufferToFill.startSample, lineInput->getReadPointer(sourceChannel),
+                                   numSamples, startGain, endGain);
+        }
+
+        // what came in, before any of the deck's effects
+        if (useInput)
+        {
+            loopRecorder.push(*lineInput, 0, numSamples);
+        }
+    }
+    wasLineInput = useInput;
+}
+
+void DJAudioPlayer::renderBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const bool jogging = jogSource.isActive();
+    if (jogging)
+    {
+        // the transport is left where it was, stopJog moves it on to where the jog got to
+        jogSource.getNextAudioBlock(bufferToFill);
+    }
+    else
+    {
+        // a new track starts from silence, not from wherever the old one's fade was
+        if (playFadeReset.exchange(false))
+        {
+            playGain = 0.0f;
+        }
+
+        // stopped and faded out: the transport isn't pulled, so it waits where it is
+        const float targetGain = playRequested.load() ? 1.0f : 0.0f;
+        if (targetGain == 0.0f && playGain == 0.0f)
+        {
+            bufferToFill.clearActiveBufferRegion();
+        }
+        else
+        {
+            if (keyLock.load())
+            {
+                stretchSource.getNextAudioBlock(bufferToFill);
+            }
+            else
+            {
+                resampleSource.getNextAudioBlock(bufferToFill);
+            }
+            applyPlayFade(bufferToFill, targetGain);
+        }
+
+        // fade back in over the block the transport took over on
+        if (wasJogging)
+        {
+            bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, 0.0f, 1.0f);
+        }
+    }
+    wasJogging = jogging;
+}
+
+void DJAudioPlayer::applyPlayFade(const AudioSourceChannelInfo& bufferToFill, float targetGain)
+{
+    if (playGain == targetGain)
+    {
+        return;
+    }
+
+    // a whole fade is playFadeSamples long, however the block has been split
+    const int needed = (int) std::ceil(std::abs(targetGain - playGain) * playFadeSamples);
+    const int rampLength = jmin(bufferToFill.numSamples, needed);
+    const float endGain = rampLength == needed ? targetGain
+                                               : playGain + (targetGain - playGain) * (float) rampLength / (float) needed;
+
+    bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, rampLength, playGain, endGain);
+    if (endGain == 0.0f)
+    {
+        bufferToFill.buffer->clear(bufferToFill.startSample + rampLength, bufferToFill.numSamples - rampLength);
+    }
+    playGain = endGain;
+}
+
+void DJAudioPlayer::performEvent(const DeckScheduler::Event& event)
+{
+    switch (event.action)
+    {
+        case DeckScheduler::Action::start:
+            start();
+            break;
+        case DeckScheduler::Action::stop:
+            // faded out from the next stretch on
+            stop();
+            break;
+        case DeckScheduler::Action::jumpToHotCue:
+            // taken up by the loop/cue source at the start of the next stretch
+            loopCueSource.jumpToHotCue(event.hotCue, isPlaying());
+            stretchSource.reset();
+            break;
+    }
 }
 void DJAudioPlayer::releaseResources()
 {
     transportSource.releaseResources();
     resampleSource.releaseResources();
+    stretchSource.releaseResources();
+    jogSource.releaseResources();
 }
 
 void DJAudioPlayer::loadURL(URL audioURL)
 {
-    auto* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-    if (reader != nullptr) // good file!
-    {       
-        std::unique_ptr<AudioFormatReaderSource> newSource (new AudioFormatReaderSource (reader, 
-true)); 
-        transportSource.setSource (newSource.get(), 0, nullptr, reader->sampleRate);             
-        readerSource.reset (newSource.release());          
+    // local files call straight back, a remote one once it has connected
+    const int load = ++loadsRequested;
+    loading = true;
+    startWhenLoaded = false;
+
+    WeakReference<DJAudioPlayer> self(this);
+    decoder.openAsync(audioURL, [self, load, audioURL](DecodedTrack::Ptr track)
+    {
+        if (self != nullptr && load == self->loadsRequested)
+        {
+            self->loadTrack(audioURL, track);
+        }
+    });
+}
+
+void DJAudioPlayer::loadTrack(const URL& audioURL, DecodedTrack::Ptr track)
+{
+    loading = false;
+    if (track == nullptr)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::loadURL could not open %s",
+                           audioURL.toString(false).toRawUTF8());
+        startWhenLoaded = false;
+        return;
     }
+
+    // the waveform and playlist get the same decode, the file is only read once
+    const double sampleRate = track->getSampleRate();
+    jogSource.stop();
+    transportSource.setSource(nullptr);
+    trackSource.setCurrentTrack(std::make_unique<DecodedTrackSource>(track), sampleRate);
+    loopCueSource.inputTrackChanged();
+    loopCueSource.clearHotCues();
+    loopCueSource.setFadeNextSeek(false);
+    loopCueSource.setNextReadPosition(0);
+    stretchSource.reset();
+    transportSource.setSource(&loopCueSource, 0, nullptr, sampleRate);
+    loadedTrack = track;
+    jogSource.setTrack(loadedTrack);
+    restoreBeatGrid();
+
+    // a new track is loaded stopped, unless start was pressed while it was on its way
+    playFadeReset = true;
+    playRequested = startWhenLoaded.exchange(false);
+    transportSource.start();
+    triggerAsyncUpdate();
 }
+
 void DJAudioPlayer::setGain(double gain)
 {
     if (gain < 0 || gain > 1.0)
     {
-        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::setGain gain should be between 0 and 1, got %f", gain);
     }
     else {
-        transportSource.setGain(gain);
+        volume = (float) gain;
     }
    
 }
@@ -62,25 +358,43 @@ void DJAudioPlayer::setSpeed(double ratio)
 {
   if (ratio < 0 || ratio > 3.0)
     {
-        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 3" << std::endl;
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::setSpeed ratio should be between 0 and 3, got %f", ratio);
     }
     else {
-        resampleSource.setResamplingRatio(ratio);
+        userSpeed = ratio;
+
+        // while synced the audio thread sets the speed, this one is used when it stops
+        if (!isSynced())
+        {
+            applySpeed(ratio);
+        }
     }
 }
+void DJAudioPlayer::applySpeed(double ratio)
+{
+    resampleSource.setResamplingRatio(ratio);
+    stretchSource.setTempo(ratio);
+    appliedSpeed = ratio;
+}
+
 void DJAudioPlayer::setPosition(double posInSecs)
 {
-    transportSource.setPosition(posInSecs);
+    // only fade the old position out if it is actually being heard. The loop/cue
+    // source takes the jump up at the start of its next block, so this never
+    // waits on the audio thread and can be called from it
+    loopCueSource.setFadeNextSeek(isPlaying());
+    loopCueSource.setNextReadPosition((int64) (jmax(0.0, posInSecs) * trackSource.getCurrentSampleRate()));
+    stretchSource.reset();
 }
 
 void DJAudioPlayer::setPositionRelative(double pos)
 {
      if (pos < 0 || pos > 1.0)
     {
-        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::setPositionRelative pos should be between 0 and 1, got %f", pos);
     }
     else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
+        double posInSecs = getLengthInSeconds() * pos;
         setPosition(posInSecs);
     }
 }
@@ -88,14 +402,427 @@ void DJAudioPlayer::setPositionRelative(double pos)
 
 void DJAudioPlayer::start()
 {
-    transportSource.start();
+    if (loading.load())
+    {
+        startWhenLoaded = true;
+        return;
+    }
+    playRequested = true;
+
+    // a transport that has run off the end is restarted from the message thread.
+    // Posting that takes a lock, so it is only done when there is something to
+    // restart, which a controller on the audio thread almost never hits
+    if (!transportSource.isPlaying())
+    {
+        triggerAsyncUpdate();
+    }
 }
 void DJAudioPlayer::stop()
 {
-  transportSource.stop();
+  // nothing else to do, the renderer fades out and stops pulling from the transport
+  startWhenLoaded = false;
+  playRequested = false;
+}
+
+bool DJAudioPlayer::isPlaying() const
+{
+    // the transport only stops by itself, at the end of the track
+    return playRequested.load() && transportSource.isPlaying();
+}
+
+double DJAudioPlayer::getGain() const
+{
+    return volume.load();
+}
+
+double DJAudioPlayer::getSpeed() const
+{
+    return userSpeed.load();
+}
+
+void DJAudioPlayer::setCrossfaderGain(float gain)
+{
+    crossfaderGain = jlimit(0.0f, 1.0f, gain);
+}
+
+void DJAudioPlayer::setCueEnabled(bool shouldCue)
+{
+    cueEnabled = shouldCue;
+}
+
+bool DJAudioPlayer::isCueEnabled() const
+{
+    return cueEnabled.load();
+}
+
+void DJAudioPlayer::setLineInput(bool shouldUseInput)
+{
+    lineInputEnabled = shouldUseInput;
+}
+
+bool DJAudioPlayer::isLineInput() const
+{
+    return lineInputEnabled.load();
+}
+
+bool DJAudioPlayer::scheduleStart(int64 time, DeckScheduler::Quantise quantise, const DJAudioPlayer* quantiseTo)
+{
+    return schedule(DeckScheduler::Action::start, 0, time, quantise, quantiseTo);
+}
+
+bool DJAudioPlayer::scheduleStop(int64 time, DeckScheduler::Quantise quantise, const DJAudioPlayer* quantiseTo)
+{
+    return schedule(DeckScheduler::Action::stop, 0, time, quantise, quantiseTo);
+}
+
+bool DJAudioPlayer::scheduleHotCueJump(int index, int64 time, DeckScheduler::Quantise quantise,
+                                       const DJAudioPlayer* quantiseTo)
+{
+    if (!loopCueSource.hasHotCue(index))
+    {
+        return false;
+    }
+    return schedule(DeckScheduler::Action::jumpToHotCue, index, time, quantise, quantiseTo);
+}
+
+void DJAudioPlayer::clearScheduledEvents()
+{
+    scheduler.clear();
+}
+
+void DJAudioPlayer::setSyncLeader(const DJAudioPlayer* leader)
+{
+    syncLeader = leader != nullptr && leader != this ? &leader->timeline : nullptr;
+}
+
+bool DJAudioPlayer::isSynced() const
+{
+    return syncLeader.load() != nullptr;
+}
+
+double DJAudioPlayer::getSyncErrorMs() const
+{
+    return tempoSync.getPhaseErrorMs();
+}
+
+int64 DJAudioPlayer::getSampleTime() const
+{
+    return timeline.getSampleTime();
+}
+
+bool DJAudioPlayer::schedule(DeckScheduler::Action action, int hotCue, int64 time,
+                             DeckScheduler::Quantise quantise, const DJAudioPlayer* quantiseTo)
+{
+    DeckScheduler::Event event;
+    event.action = action;
+    event.time = time;
+    event.quantise = quantise;
+    event.grid = quantiseTo != nullptr ? &quantiseTo->timeline : nullptr;
+    event.hotCue = hotCue;
+
+    if (!scheduler.post(event))
+    {
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::schedule too many events waiting");
+        return false;
+    }
+    return true;
 }
 
 double DJAudioPlayer::getPositionRelative()
 {
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
-}
\ No newline at end of file
+    const double sampleRate = trackSource.getCurrentSampleRate();
+    if (jogSource.isActive() && sampleRate > 0)
+    {
+        return jogSource.getPosition() / sampleRate / getLengthInSeconds();
+    }
+    return sampleRate > 0 ? loopCueSource.getNextReadPosition() / sampleRate / getLengthInSeconds() : 0.0;
+}
+
+double DJAudioPlayer::getLengthInSeconds()
+{
+    // from the track source's published length, the transport would take its lock
+    const double sampleRate = trackSource.getCurrentSampleRate();
+    return sampleRate > 0 ? loopCueSource.getTotalLength() / sampleRate : 0.0;
+}
+
+bool DJAudioPlayer::preloadNextURL(URL audioURL)
+{
+    const int preload = ++preloadsRequested;
+
+    WeakReference<DJAudioPlayer> self(this);
+    decoder.openAsync(audioURL, [self, preload, audioURL](DecodedTrack::Ptr track)
+    {
+        if (self != nullptr && preload == self->preloadsRequested)
+        {
+            self->preloadTrack(audioURL, track);
+        }
+    });
+
+    // a local file has been opened by now, or couldn't be
+    return !audioURL.isLocalFile() || (preloadedTrack != nullptr && preloadedTrack->getURL() == audioURL);
+}
+
+void DJAudioPlayer::preloadTrack(const URL& audioURL, DecodedTrack::Ptr track)
+{
+    if (track == nullptr)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "DJAudioPlayer::preloadNextURL could not open %s",
+                           audioURL.toString(false).toRawUTF8());
+        clearPreloadedTrack();
+        return;
+    }
+
+    trackSource.setNextTrack(std::make_unique<DecodedTrackSource>(track), track->getSampleRate());
+    preloadedTrack = track;
+}
+
+void DJAudioPlayer::clearPreloadedTrack()
+{
+    // and forget one that is still connecting
+    ++preloadsRequested;
+    trackSource.clearNextTrack();
+    preloadedTrack = nullptr;
+}
+
+bool DJAudioPlayer::playPreloadedTrack()
+{
+    if (!trackSource.hasNextTrack())
+    {
+        return false;
+    }
+
+    if (isPlaying() && trackSource.canJoinNextTrack())
+    {
+        // switched by the audio thread at the start of its next block
+        trackSource.skipToNextTrack();
+    }
+    else
+    {
+        trackSource.moveToNextTrack();
+        restartTransport(true);
+        handleAsyncUpdate();
+    }
+    return true;
+}
+
+void DJAudioPlayer::setAutoCrossfade(double seconds)
+{
+    trackSource.setCrossfadeSeconds(seconds);
+}
+
+int DJAudioPlayer::getTrackChangeCount() const
+{
+    return trackSource.getTrackChangeCount();
+}
+
+void DJAudioPlayer::restartTransport(bool startPlaying)
+{
+    transportSource.setSource(nullptr);
+    loopCueSource.inputTrackChanged();
+    transportSource.setSource(&loopCueSource, 0, nullptr, trackSource.getCurrentSampleRate());
+    stretchSource.reset();
+    playFadeReset = true;
+    playRequested = startPlaying;
+    transportSource.start();
+}
+
+void DJAudioPlayer::changeListenerCallback(ChangeBroadcaster* source)
+{
+    // the preloaded track couldn't follow on without a gap (different sample rate),
+    // so switch over now that the current one has finished
+    if (source == &transportSource
+        && transportSource.hasStreamFinished()
+        && trackSource.hasNextTrack())
+    {
+        trackSource.moveToNextTrack();
+        restartTransport(true);
+        handleAsyncUpdate();
+    }
+    else if (source == &transportSource && transportSource.hasStreamFinished())
+    {
+        // ran off the end with nothing to follow, the deck has stopped
+        playRequested = false;
+        sendChangeMessage();
+    }
+}
+
+void DJAudioPlayer::handleAsyncUpdate()
+{
+    // started from the audio thread after the track had run out
+    if (playRequested.load() && !transportSource.isPlaying())
+    {
+        transportSource.start();
+    }
+
+    if (trackSource.getTrackChangeCount() != lastHandledTrackChange)
+    {
+        lastHandledTrackChange = trackSource.getTrackChangeCount();
+        loadedTrack = preloadedTrack;
+        preloadedTrack = nullptr;
+
+        // the cues belonged to the old track
+        loopCueSource.inputTrackChanged();
+        loopCueSource.clearHotCues();
+        jogSource.setTrack(loadedTrack);
+        restoreBeatGrid();
+    }
+
+    trackSource.releaseFinishedTracks();
+    sendChangeMessage();
+}
+
+void DJAudioPlayer::setBeatGrid(const BeatGrid& grid)
+{
+    if (grid.isValid())
+    {
+        beatGrid = grid;
+        timeline.setBeatGrid(grid);
+
+        if (loadedTrack != nullptr)
+        {
+            beatGrids[loadedTrack->getURL().toString(false)] = grid;
+        }
+    }
+}
+
+BeatGrid DJAudioPlayer::getBeatGrid() const
+{
+    return beatGrid;
+}
+
+void DJAudioPlayer::setDownbeatAtPlayhead()
+{
+    const double sampleRate = trackSource.getCurrentSampleRate();
+    if (loadedTrack == nullptr || sampleRate <= 0)
+    {
+        return;
+    }
+
+    const int64 position = jogSource.isActive() ? (int64) jogSource.getPosition() : loopCueSource.getNextReadPosition();
+    BeatGrid grid = beatGrid;
+    grid.firstBeatSeconds = position / sampleRate;
+    setBeatGrid(grid);
+}
+
+void DJAudioPlayer::restoreBeatGrid()
+{
+    auto found = loadedTrack != nullptr ? beatGrids.find(loadedTrack->getURL().toString(false)) : beatGrids.end();
+    beatGrid = found != beatGrids.end() ? found->second : BeatGrid();
+    timeline.setBeatGrid(beatGrid);
+}
+
+void DJAudioPlayer::setHotCue(int index)
+{
+    const int64 position = loopCueSource.getNextReadPosition();
+    if (loadedTrack == nullptr || position >= loadedTrack->getLengthInSamples())
+    {
+        return;
+    }
+
+    // copy a little of the track from the cue onwards, so jumping there never waits on anything
+    const int length = (int) jmin((int64) (loadedTrack->getSampleRate() * cueWindowSeconds),
+                                  loadedTrack->getLengthInSamples() - position);
+    auto window = std::make_unique<AudioBuffer<float>>(2, length);
+    loadedTrack->read(*window, 0, position, length);
+
+    loopCueSource.setHotCue(index, position, std::move(window));
+}
+
+void DJAudioPlayer::jumpToHotCue(int index)
+{
+    loopCueSource.jumpToHotCue(index, isPlaying());
+    stretchSource.reset();
+}
+
+void DJAudioPlayer::clearHotCue(int index)
+{
+    loopCueSource.clearHotCue(index);
+}
+
+bool DJAudioPlayer::hasHotCue(int index) const
+{
+    return loopCueSource.hasHotCue(index);
+}
+
+void DJAudioPlayer::setBeatLoop(double beats)
+{
+    const double sampleRate = trackSource.getCurrentSampleRate();
+    if (sampleRate <= 0)
+    {
+        return;
+    }
+
+    beats = jlimit(1.0 / 8.0, 32.0, beats);
+    loopCueSource.startLoop((int64) std::round(beats * beatGrid.getSecondsPerBeat() * sampleRate));
+}
+
+void DJAudioPlayer::exitLoop()
+{
+    loopCueSource.exitLoop();
+}
+
+bool DJAudioPlayer::isLoopActive() const
+{
+    return loopCueSource.isLoopActive();
+}
+
+void DJAudioPlayer::setKeyLock(bool shouldLockKey)
+{
+    if (shouldLockKey && !keyLock.load())
+    {
+        // nothing it buffered before is still wanted
+        stretchSource.reset();
+    }
+    keyLock = shouldLockKey;
+}
+
+bool DJAudioPlayer::isKeyLocked() const
+{
+    return keyLock.load();
+}
+
+void DJAudioPlayer::setKeyLockQuality(TimeStretchSource::Quality quality)
+{
+    stretchSource.setQuality(quality);
+}
+
+void DJAudioPlayer::startJog()
+{
+    if (jogSource.isActive())
+    {
+        return;
+    }
+
+    // pick up from the transport at the speed it was going
+    const double velocity = isPlaying() ? appliedSpeed.load() : 0.0;
+    jogSource.start(loopCueSource.getNextReadPosition(), velocity);
+}
+
+void DJAudioPlayer::stopJog()
+{
+    if (!jogSource.isActive())
+    {
+        return;
+    }
+
+    // there's nothing of the old position worth fading out, the transport hasn't moved
+    loopCueSource.setFadeNextSeek(false);
+    loopCueSource.setNextReadPosition((int64) jogSource.getPosition());
+    stretchSource.reset();
+    jogSource.stop();
+}
+
+bool DJAudioPlayer::isJogging() const
+{
+    return jogSource.isActive();
+}
+
+void DJAudioPlayer::setJogTarget(double posInSecs, double velocity)
+{
+    jogSource.setTarget(posInSecs * trackSource.getCurrentSampleRate(), velocity);
+}
+
+void DJAudioPlayer::setJogVelocity(double velocity)
+{
+    jogSource.setVelocity(velocity);
+}
@@ -11,35 +11,271 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "GaplessTrackSource.h"
+#include "DecodedTrackSource.h"
+#include "LoopCueSource.h"
+#include "JogSource.h"
+#include "TimeStretchSource.h"
+#include "BeatGrid.h"
+#include "LevelMeter.h"
+#include "DeckScheduler.h"
+#include "TempoSync.h"
+#include "DeckEffects.h"
+#include "LoopRecorder.h"
 
-class DJAudioPlayer : public AudioSource {
+class DJAudioPlayer : public AudioSource,
+                      public ChangeBroadcaster,
+                      private ChangeListener,
+                      private AsyncUpdater {
   public:
 
-    DJAudioPlayer(AudioFormatManager& _formatManager);
+    DJAudioPlayer(TrackDecoder& _decoder);
     ~DJAudioPlayer();
 
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
     void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
     void releaseResources() override;
 
+    // the same, also adding the deck into cueBus from its sample 0 if PFL is on.
+    // lineInput is this block of the device's inputs, from its sample 0, for
+    // when the deck is switched to them
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill, AudioBuffer<float>& cueBus,
+                            const AudioBuffer<float>* lineInput = nullptr);
+
+    // a remote track connects in the background, the deck keeps playing what
+    // it has until it is in. start() meanwhile starts the new one once it is
     void loadURL(URL audioURL);
     void setGain(double gain);
     void setSpeed(double ratio);
+    // lock-free, the jump happens at the start of the next block
     void setPosition(double posInSecs);
     void setPositionRelative(double pos);
     
 
+    // any thread, the audio thread included. They only say what the deck
+    // should be doing, the renderer fades in or out over a few ms and a
+    // change message follows from the message thread
     void start();
     void stop();
+    bool isPlaying() const;
+
+    // what setGain and setSpeed were last given
+    double getGain() const;
+    double getSpeed() const;
+
+    // the crossfader's share of this deck, 0 to 1, ramped over the next block.
+    // Applied after the meter
+    void setCrossfaderGain(float gain);
+
+    // pre-fader listen: the deck goes to the cue bus as it is before the volume
+    // and the crossfader, so it can be heard in the headphones with both down
+    void setCueEnabled(bool shouldCue);
+    bool isCueEnabled() const;
+
+    // play the device's inputs instead of the track, e.g. a turntable or another
+    // laptop, through the same effects, PFL, volume, meter and crossfader.
+    // The input is heard in the block it arrives in, so nothing is added to
+    // the device's own latency. The track is paused where it was meanwhile,
+    // and the two crossfade over a block when this is switched
+    void setLineInput(bool shouldUseInput);
+    bool isLineInput() const;
+
+    // the last few seconds of the line input, when it has been given a length
+    LoopRecorder& getLoopRecorder() { return loopRecorder; }
 
     // get the relative position of the playhead
     double getPositionRelative();
 
+    double getLengthInSeconds();
+
+    // open the track that should follow the current one and start buffering it
+    // in the background, so it can take over without a gap. Returns false if the
+    // file can't be read. A remote track is still connecting when this returns,
+    // and is only ready to take over once it is in
+    bool preloadNextURL(URL audioURL);
+    void clearPreloadedTrack();
+
+    // move on to the preloaded track now instead of waiting for the current one to end
+    bool playPreloadedTrack();
+
+    // overlap the end of the current track with the preloaded one, 0 for a straight cut
+    void setAutoCrossfade(double seconds);
+
+    // goes up every time the deck moves on to a preloaded track. A change message
+    // is sent each time it does
+    int getTrackChangeCount() const;
+
+    // tempo and downbeat of the loaded track, used to size beat loops and by
+    // quantise and sync. Kept for each track this session, a new one starts
+    // at 120 BPM with its first beat at 0 until it is set
+    void setBeatGrid(const BeatGrid& grid);
+    BeatGrid getBeatGrid() const;
+
+    // the first beat of the grid is at the playhead
+    void setDownbeatAtPlayhead();
+
+    // hot cues: set at the playhead, jump to (at the exact sample, crossfaded) or clear
+    void setHotCue(int index);
+    void jumpToHotCue(int index);
+    void clearHotCue(int index);
+    bool hasHotCue(int index) const;
+
+    // loop the next 1/8 to 32 beats from the playhead
+    void setBeatLoop(double beats);
+    void exitLoop();
+    bool isLoopActive() const;
+
+    // key lock: speed changes the tempo but leaves the pitch alone
+    void setKeyLock(bool shouldLockKey);
+    bool isKeyLocked() const;
+    void setKeyLockQuality(TimeStretchSource::Quality quality);
+
+    // scratch/jog: while jogging the deck follows setJogTarget or setJogVelocity
+    // instead of the transport, at any speed between -8 and 8, and carries on
+    // from wherever it got to once stopJog is called. None of these lock, so a
+    // controller can call them from the audio thread
+    void startJog();
+    void stopJog();
+    bool isJogging() const;
+
+    // where the playhead should be and how fast that point is moving (1 is normal speed)
+    void setJogTarget(double posInSecs, double velocity);
+
+    // spin the platter at this speed, negative for backwards
+    void setJogVelocity(double velocity);
+
+    // levels of what the deck is sending to the mixer, after the volume
+    LevelMeter& getMeter() { return meter; }
+
+    // echo, reverb, flanger and bit crush, before the cue and the volume
+    DeckEffectsRack& getEffects() { return effects; }
+
+    // sample accurate transport: start, stop or jump to a hot cue at a sample
+    // of the output clock (DeckScheduler::asap for the next block), optionally
+    // on the next beat or bar of quantiseTo's grid (nullptr for this deck's).
+    // Returns false if too much is already scheduled
+    bool scheduleStart(int64 sampleTime, DeckScheduler::Quantise quantise = DeckScheduler::Quantise::none,
+                       const DJAudioPlayer* quantiseTo = nullptr);
+    bool scheduleStop(int64 sampleTime, DeckScheduler::Quantise quantise = DeckScheduler::Quantise::none,
+                      const DJAudioPlayer* quantiseTo = nullptr);
+    bool scheduleHotCueJump(int index, int64 sampleTime,
+                            DeckScheduler::Quantise quantise = DeckScheduler::Quantise::none,
+                            const DJAudioPlayer* quantiseTo = nullptr);
+    void clearScheduledEvents();
+
+    // follow the leader's tempo and beat from the audio thread until this is
+    // called with nullptr, when the speed goes back to the last setSpeed
+    void setSyncLeader(const DJAudioPlayer* leader);
+    bool isSynced() const;
+    double getSyncErrorMs() const;
+
+    // the output clock, as of the last block
+    int64 getSampleTime() const;
+    const DeckScheduler::Timeline& getTimeline() const { return timeline; }
+
 private:
-    AudioFormatManager& formatManager;
-    std::unique_ptr<AudioFormatReaderSource> readerSource;
+    void process(const AudioSourceChannelInfo& bufferToFill, AudioBuffer<float>* cueBus,
+                 const AudioBuffer<float>* lineInput);
+
+    // the track, speed sync and scheduled events
+    void renderTrack(const AudioSourceChannelInfo& bufferToFill);
+
+    // the line input in place of the track, or crossfaded with it over the block it is switched on or off
+    void renderLineInput(const AudioSourceChannelInfo& bufferToFill, const AudioBuffer<float>* lineInput,
+                         bool useInput);
+
+    // what getNextAudioBlock used to do, for the stretch between two events
+    void renderBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    // moves playGain towards targetGain at the fade rate over this stretch
+    void applyPlayFade(const AudioSourceChannelInfo& bufferToFill, float targetGain);
+
+    void performEvent(const DeckScheduler::Event& event);
+    void applySpeed(double ratio);
+    bool schedule(DeckScheduler::Action action, int hotCue, int64 sampleTime,
+                  DeckScheduler::Quantise quantise, const DJAudioPlayer* quantiseTo);
+
+    // once the decoder has the track, which for a remote one can be a while after loadURL
+    void loadTrack(const URL& audioURL, DecodedTrack::Ptr track);
+    void preloadTrack(const URL& audioURL, DecodedTrack::Ptr track);
+
+    // reinstall the track source so the transport picks up a new sample rate
+    void restartTransport(bool startPlaying);
+
+    /** implement ChangeListener, hears about the transport reaching the end */
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    /** implement AsyncUpdater, tidies up after the audio thread switched track */
+    void handleAsyncUpdate() override;
+
+    TrackDecoder& decoder;
+    GaplessTrackSource trackSource;
+    LoopCueSource loopCueSource{ &trackSource };
+    JogSource jogSource;
+    bool wasJogging = false;
+    DeckEffectsRack effects;
+    LevelMeter meter;
+    DeckScheduler scheduler;
+    DeckScheduler::Timeline timeline;
+    int64 sampleTime = 0;
+    double outputSampleRate = 44100.0;
+
+    std::atomic<const DeckScheduler::Timeline*> syncLeader{ nullptr };
+    TempoSync tempoSync;
+    bool wasSyncing = false;
+    std::atomic<double> userSpeed{ 1.0 };
+
+    // what the deck is actually going at, the sync's speed while it is synced
+    std::atomic<double> appliedSpeed{ 1.0 };
+
+    // the volume is applied after the cue is taken off, the transport's own gain stays at 1
+    std::atomic<float> volume{ 1.0f };
+    float appliedVolume = 1.0f;
+    std::atomic<float> crossfaderGain{ 1.0f };
+    float appliedCrossfaderGain = 1.0f;
+    std::atomic<bool> cueEnabled{ false };
+    float appliedCueGain = 0.0f;
+    std::atomic<bool> lineInputEnabled{ false };
+    bool wasLineInput = false;
+    LoopRecorder loopRecorder;
+    int lastTrackChangeCount = 0;
+    int lastHandledTrackChange = 0;
+
+    DecodedTrack::Ptr loadedTrack;
+    DecodedTrack::Ptr preloadedTrack;
+
+    // message thread: a remote track that is still connecting is dropped if
+    // another is asked for meanwhile
+    int loadsRequested = 0;
+    int preloadsRequested = 0;
+
+    // so start waits for a track that is still on its way, whichever thread it is called on
+    std::atomic<bool> loading{ false };
+    std::atomic<bool> startWhenLoaded{ false };
+
+    // what start and stop asked for. The transport is left running while a
+    // track is loaded and the renderer simply stops pulling from it once it
+    // has faded out, so it stays exactly where it was and nothing on the
+    // audio thread ever waits for AudioTransportSource::stop
+    std::atomic<bool> playRequested{ false };
+    std::atomic<bool> playFadeReset{ false };
+    float playGain = 0.0f;
+    static constexpr int playFadeSamples = 256;
+
+    // the grid of the loaded track, from beatGrids once it is loaded
+    void restoreBeatGrid();
+
+    BeatGrid beatGrid;
+    std::map<String, BeatGrid> beatGrids;
     AudioTransportSource transportSource; 
     ResamplingAudioSource resampleSource{&transportSource, false, 2};
+    // reset every time the loop/cue source is told to jump. It reads ahead of
+    // what it plays, and none of that is wanted after the jump. A loop wrap is
+    // spliced into the input and carries straight on, so it keeps its state
+    TimeStretchSource stretchSource{&transportSource};
+    std::atomic<bool> keyLock{ false };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(DJAudioPlayer)
 
 };
 
@@ -0,0 +1,495 @@
+/*
+  ==============================================================================
+
+    DeckEffects.cpp
+    Created: 20 Oct 2026 6:58:19am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "DeckEffects.h"
+
+namespace
+{
+    const double smoothingSeconds = 0.05;
+
+    // how long the CPU load is averaged over
+    const double loadSeconds = 1.0;
+
+    // when a deck's tempo isn't known, synced times assume this
+    const double fallbackBeatsPerSecond = 2.0;
+
+    const double echoMaxSeconds = 2.0;
+    const double echoGlideSeconds = 0.1;
+    const double echoBeats[] = { 1.0 / 16, 1.0 / 8, 3.0 / 16, 1.0 / 4, 3.0 / 8, 1.0 / 2, 3.0 / 4, 1.0 };
+    const char* const echoBeatNames[] = { "1/16", "1/8", "3/16", "1/4", "3/8", "1/2", "3/4", "1" };
+
+    const double flangerMaxMs = 8.0;
+    const double flangerFeedback = 0.5;
+    const double flangerBeats[] = { 0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0 };
+
+    // one of a table of choices for a parameter from 0 to 1
+    template <size_t size>
+    int getChoice(const double (&)[size], float value)
+    {
+        return jlimit(0, (int) size - 1, roundToInt(value * (size - 1)));
+    }
+
+    double getEchoSeconds(float value)
+    {
+        // 10 ms to 1.5 s, finer at the short end
+        return 0.01 * std::pow(150.0, (double) value);
+    }
+
+    double getFlangerHz(float value)
+    {
+        return 0.05 * std::pow(100.0, (double) value);
+    }
+
+    String getPercentText(float value)
+    {
+        return String(roundToInt(value * 100.0f)) + "%";
+    }
+}
+
+//==============================================================================
+DeckEffect::DeckEffect(float initialParameter0, float initialParameter1)
+{
+    parameters[0] = initialParameter0;
+    parameters[1] = initialParameter1;
+}
+
+void DeckEffect::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    maximumBlockSize = jmax(1, samplesPerBlockExpected);
+    dry.setSize(maxChannels, maximumBlockSize);
+    mixGains.allocate((size_t) maximumBlockSize, true);
+
+    mixSmoother.reset(sampleRate, smoothingSeconds);
+    mixSmoother.setCurrentAndTargetValue(0.0f);
+    for (int i = 0; i < numParameters; ++i)
+    {
+        parameterSmoothers[i].reset(sampleRate, smoothingSeconds);
+        parameterSmoothers[i].setCurrentAndTargetValue(parameters[i].load());
+    }
+
+    active = false;
+    cpuLoad = 0.0f;
+    prepare(sampleRate, maximumBlockSize);
+}
+
+void DeckEffect::process(AudioBuffer<float>& buffer, int startSample, int numSamples, const Timing& timing)
+{
+    const bool on = enabled.load();
+    if (!active)
+    {
+        // bypassed, and the last of the wet signal has faded out
+        if (!on || maximumBlockSize == 0)
+        {
+            return;
+        }
+
+        reset();
+        mixSmoother.setCurrentAndTargetValue(0.0f);
+        for (int i = 0; i < numParameters; ++i)
+        {
+            parameterSmoothers[i].setCurrentAndTargetValue(parameters[i].load());
+        }
+        active = true;
+    }
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    mixSmoother.setTargetValue(on ? mix.load() : 0.0f);
+    for (int i = 0; i < numParameters; ++i)
+    {
+        parameterSmoothers[i].setTargetValue(parameters[i].load());
+    }
+
+    const int numChannels = jmin(buffer.getNumChannels(), maxChannels);
+    float* channels[maxChannels] = {};
+
+    // in pieces no longer than the dry buffer
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = jmin(maximumBlockSize, numSamples - done);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            channels[channel] = buffer.getWritePointer(channel, startSample + done);
+            dry.copyFrom(channel, 0, channels[channel], chunk);
+        }
+        for (int i = 0; i < chunk; ++i)
+        {
+            mixGains[i] = mixSmoother.getNextValue();
+        }
+
+        processWet(channels, numChannels, chunk, timing);
+
+        // dry + (wet - dry) * mix
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* dryData = dry.getReadPointer(channel);
+            FloatVectorOperations::subtract(channels[channel], dryData, chunk);
+            FloatVectorOperations::multiply(channels[channel], mixGains, chunk);
+            FloatVectorOperations::add(channels[channel], dryData, chunk);
+        }
+        done += chunk;
+    }
+
+    // switched off and faded out, it costs nothing from the next block
+    if (!on && !mixSmoother.isSmoothing())
+    {
+        active = false;
+        cpuLoad = 0.0f;
+        return;
+    }
+
+    const double blockSeconds = numSamples / sampleRate;
+    const float load = (float) (Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks)
+                                / blockSeconds);
+    const float keep = (float) std::exp(-blockSeconds / loadSeconds);
+    cpuLoad.store(load + keep * (cpuLoad.load(std::memory_order_relaxed) - load), std::memory_order_relaxed);
+}
+
+void DeckEffect::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+}
+
+bool DeckEffect::isEnabled() const
+{
+    return enabled.load();
+}
+
+void DeckEffect::setMix(float wet)
+{
+    mix = jlimit(0.0f, 1.0f, wet);
+}
+
+float DeckEffect::getMix() const
+{
+    return mix.load();
+}
+
+void DeckEffect::setParameter(int index, float value)
+{
+    parameters[index] = jlimit(0.0f, 1.0f, value);
+}
+
+float DeckEffect::getParameter(int index) const
+{
+    return parameters[index].load();
+}
+
+float DeckEffect::getCpuLoad() const
+{
+    return cpuLoad.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+EchoEffect::EchoEffect()
+    : DeckEffect(0.5f, 0.4f)
+{
+}
+
+double EchoEffect::getBeats(float value)
+{
+    return echoBeats[getChoice(echoBeats, value)];
+}
+
+String EchoEffect::getParameterText(int index, float value, bool tempoSync) const
+{
+    if (index == 1)
+    {
+        return getPercentText(value);
+    }
+    if (tempoSync)
+    {
+        return String(echoBeatNames[getChoice(echoBeats, value)]) + " beat";
+    }
+    return String(roundToInt(getEchoSeconds(value) * 1000.0)) + " ms";
+}
+
+void EchoEffect::prepare(double sampleRate, int)
+{
+    line.setSize(maxChannels, (int) (sampleRate * echoMaxSeconds) + 2);
+    delay.reset(sampleRate, echoGlideSeconds);
+    reset();
+}
+
+void EchoEffect::reset()
+{
+    line.clear();
+    writePosition = 0;
+
+    // picked up straight away by the next block rather than glided to
+    delay.setCurrentAndTargetValue(0.0f);
+}
+
+void EchoEffect::processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing)
+{
+    const float time = getParameter(0);
+    double seconds = getEchoSeconds(time);
+    if (timing.tempoSync)
+    {
+        const double beatsPerSecond = timing.beatsPerSecond > 0 ? timing.beatsPerSecond : fallbackBeatsPerSecond;
+        seconds = getBeats(time) / beatsPerSecond;
+    }
+
+    const int length = line.getNumSamples();
+    const float target = (float) jlimit(1.0, (double) length - 2, seconds * getSampleRate());
+    if (delay.getCurrentValue() <= 0.0f)
+    {
+        delay.setCurrentAndTargetValue(target);
+    }
+    delay.setTargetValue(target);
+
+    float* lines[maxChannels] = { line.getWritePointer(0), line.getWritePointer(1) };
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float feedback = nextParameter(1) * 0.9f;
+
+        float readPosition = writePosition - delay.getNextValue();
+        if (readPosition < 0)
+        {
+            readPosition += length;
+        }
+        const int index0 = (int) readPosition;
+        const int index1 = index0 + 1 < length ? index0 + 1 : 0;
+        const float fraction = readPosition - index0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* data = lines[channel];
+            const float echo = data[index0] + fraction * (data[index1] - data[index0]);
+            data[writePosition] = channels[channel][i] + echo * feedback;
+            channels[channel][i] = echo;
+        }
+
+        if (++writePosition == length)
+        {
+            writePosition = 0;
+        }
+    }
+}
+
+//==============================================================================
+ReverbEffect::ReverbEffect()
+    : DeckEffect(0.5f, 0.5f)
+{
+}
+
+String ReverbEffect::getParameterText(int, float value, bool) const
+{
+    return getPercentText(value);
+}
+
+void ReverbEffect::prepare(double sampleRate, int)
+{
+    // the comb and all-pass lines are sized here
+    reverb.setSampleRate(sampleRate);
+    reset();
+}
+
+void ReverbEffect::reset()
+{
+    reverb.reset();
+}
+
+void ReverbEffect::processWet(float* const* channels, int numChannels, int numSamples, const Timing&)
+{
+    // the reverb glides its own settings, so they only need to be set per block
+    Reverb::Parameters settings;
+    settings.roomSize = skipParameter(0, numSamples);
+    settings.damping = skipParameter(1, numSamples);
+    settings.wetLevel = 1.0f;
+    settings.dryLevel = 0.0f;
+    settings.width = 1.0f;
+    reverb.setParameters(settings);
+
+    if (numChannels == 2)
+    {
+        reverb.processStereo(channels[0], channels[1], numSamples);
+    }
+    else
+    {
+        reverb.processMono(channels[0], numSamples);
+    }
+}
+
+//==============================================================================
+FlangerEffect::FlangerEffect()
+    : DeckEffect(0.3f, 0.7f)
+{
+}
+
+double FlangerEffect::getBeats(float value)
+{
+    return flangerBeats[getChoice(flangerBeats, value)];
+}
+
+String FlangerEffect::getParameterText(int index, float value, bool tempoSync) const
+{
+    if (index == 1)
+    {
+        return getPercentText(value);
+    }
+    if (tempoSync)
+    {
+        const double beats = getBeats(value);
+        return (beats < 1.0 ? String("1/2") : String((int) beats)) + (beats > 1.0 ? " beats" : " beat");
+    }
+    return String(getFlangerHz(value), 2) + " Hz";
+}
+
+void FlangerEffect::prepare(double sampleRate, int)
+{
+    line.setSize(maxChannels, (int) (sampleRate * flangerMaxMs / 1000.0) + 2);
+    reset();
+}
+
+void FlangerEffect::reset()
+{
+    line.clear();
+    writePosition = 0;
+    phase = 0;
+}
+
+void FlangerEffect::processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing)
+{
+    const float rate = getParameter(0);
+    double hz = getFlangerHz(rate);
+    if (timing.tempoSync)
+    {
+        const double beatsPerSecond = timing.beatsPerSecond > 0 ? timing.beatsPerSecond : fallbackBeatsPerSecond;
+        hz = beatsPerSecond / getBeats(rate);
+    }
+
+    const double phaseStep = MathConstants<double>::twoPi * hz / getSampleRate();
+    const int length = line.getNumSamples();
+    const float minimumDelay = (float) (getSampleRate() * 0.001);
+    const float sweep = (float) (getSampleRate() * (flangerMaxMs - 1.0) / 1000.0);
+
+    float* lines[maxChannels] = { line.getWritePointer(0), line.getWritePointer(1) };
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float depth = nextParameter(1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            // the right channel a quarter of a sweep behind, for some width
+            const double channelPhase = phase + channel * MathConstants<double>::halfPi;
+            const float delay = minimumDelay + sweep * depth * (0.5f + 0.5f * (float) std::sin(channelPhase));
+
+            float readPosition = writePosition - delay;
+            if (readPosition < 0)
+            {
+                readPosition += length;
+            }
+            const int index0 = (int) readPosition;
+            const int index1 = index0 + 1 < length ? index0 + 1 : 0;
+            const float fraction = readPosition - index0;
+
+            float* data = lines[channel];
+            const float delayed = data[index0] + fraction * (data[index1] - data[index0]);
+            data[writePosition] = channels[channel][i] + delayed * (float) flangerFeedback;
+            channels[channel][i] = delayed;
+        }
+
+        if (++writePosition == length)
+        {
+            writePosition = 0;
+        }
+        phase += phaseStep;
+        if (phase >= MathConstants<double>::twoPi)
+        {
+            phase -= MathConstants<double>::twoPi;
+        }
+    }
+}
+
+//==============================================================================
+BitCrushEffect::BitCrushEffect()
+    : DeckEffect(0.5f, 0.3f)
+{
+}
+
+String BitCrushEffect::getParameterText(int index, float value, bool) const
+{
+    if (index == 0)
+    {
+        return String(16.0f - 14.0f * value, 1) + " bits";
+    }
+    return "1/" + String(1.0f + 31.0f * value * value, 1) + " rate";
+}
+
+void BitCrushEffect::prepare(double, int)
+{
+    reset();
+}
+
+void BitCrushEffect::reset()
+{
+    held[0] = held[1] = 0;
+    holdCounter = 0;
+}
+
+void BitCrushEffect::processWet(float* const* channels, int numChannels, int numSamples, const Timing&)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // 16 bits down to 2, and every sample down to every 32nd
+        const float levels = std::exp2(15.0f - 14.0f * nextParameter(0));
+        const float rate = nextParameter(1);
+        const float hold = 1.0f + 31.0f * rate * rate;
+
+        holdCounter += 1.0f;
+        const bool take = holdCounter >= hold;
+        if (take)
+        {
+            holdCounter -= hold;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (take)
+            {
+                held[channel] = std::round(channels[channel][i] * levels) / levels;
+            }
+            channels[channel][i] = held[channel];
+        }
+    }
+}
+
+//==============================================================================
+void DeckEffectsRack::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    for (auto* effect : effects)
+    {
+        effect->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+}
+
+void DeckEffectsRack::process(AudioBuffer<float>& buffer, int startSample, int numSamples, double beatsPerSecond)
+{
+    DeckEffect::Timing timing;
+    timing.tempoSync = tempoSync.load();
+    timing.beatsPerSecond = beatsPerSecond;
+
+    for (auto* effect : effects)
+    {
+        effect->process(buffer, startSample, numSamples, timing);
+    }
+}
+
+void DeckEffectsRack::setTempoSync(bool shouldSync)
+{
+    tempoSync = shouldSync;
+}
+
+bool DeckEffectsRack::isTempoSynced() const
+{
+    return tempoSync.load();
+}
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    DeckEffects.h
+    Created: 20 Oct 2026 6:58:19am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    An insert effect on a deck. Each one has an on switch, a wet/dry mix and
+    two parameters from 0 to 1, which can be set from any thread and are
+    smoothed on the audio thread. Switching on or off fades the wet signal
+    in or out; once it has faded out the effect isn't run at all.
+
+    Everything an effect needs is allocated in prepareToPlay.
+*/
+class DeckEffect
+{
+public:
+    // what the deck is doing, for effects that follow its tempo
+    struct Timing
+    {
+        bool tempoSync = false;
+
+        // beats of the track per second of output, 0 if unknown or stopped
+        double beatsPerSecond = 0;
+    };
+
+    static constexpr int numParameters = 2;
+    static constexpr int maxChannels = 2;
+
+    virtual ~DeckEffect() = default;
+
+    virtual String getName() const = 0;
+    virtual String getParameterName(int index) const = 0;
+
+    // the parameter as it should be shown, e.g. "350 ms" or "1/4 beat"
+    virtual String getParameterText(int index, float value, bool tempoSync) const = 0;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // audio thread, in place on the first two channels
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples, const Timing& timing);
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+    void setMix(float wet);
+    float getMix() const;
+    void setParameter(int index, float value);
+    float getParameter(int index) const;
+
+    // the share of the real-time budget it is using, averaged over about a
+    // second, 0 while it is bypassed. Any thread
+    float getCpuLoad() const;
+
+protected:
+    DeckEffect(float initialParameter0, float initialParameter1);
+
+    virtual void prepare(double sampleRate, int maximumBlockSize) = 0;
+
+    // clear any tails left from last time it was on
+    virtual void reset() = 0;
+
+    // replace the audio with the effect's output, fully wet. Parameters move
+    // towards their targets one sample at a time through nextParameter
+    virtual void processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing) = 0;
+
+    float nextParameter(int index) { return parameterSmoothers[index].getNextValue(); }
+    float skipParameter(int index, int numSamples) { return parameterSmoothers[index].skip(numSamples); }
+    double getSampleRate() const { return sampleRate; }
+
+private:
+    std::atomic<bool> enabled{ false };
+    std::atomic<float> mix{ 0.5f };
+    std::atomic<float> parameters[numParameters];
+    std::atomic<float> cpuLoad{ 0.0f };
+
+    // audio thread only
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0;
+    bool active = false;
+    SmoothedValue<float> mixSmoother;
+    SmoothedValue<float> parameterSmoothers[numParameters];
+    AudioBuffer<float> dry;
+    HeapBlock<float> mixGains;
+};
+
+//==============================================================================
+/*
+    A feedback delay. Time is up to a second and a half, or a fraction of a
+    beat when tempo synced.
+*/
+class EchoEffect : public DeckEffect
+{
+public:
+    EchoEffect();
+
+    String getName() const override { return "Echo"; }
+    String getParameterName(int index) const override { return index == 0 ? "Time" : "Feedback"; }
+    String getParameterText(int index, float value, bool tempoSync) const override;
+
+    // tempo synced times, in beats
+    static double getBeats(float value);
+
+private:
+    void prepare(double sampleRate, int maximumBlockSize) override;
+    void reset() override;
+    void processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing) override;
+
+    AudioBuffer<float> line;
+    int writePosition = 0;
+
+    // in samples, glides so a change of time bends the echoes rather than clicking
+    SmoothedValue<float> delay;
+};
+
+//==============================================================================
+/*
+    JUCE's Freeverb, run fully wet so the rack does the mix.
+*/
+class ReverbEffect : public DeckEffect
+{
+public:
+    ReverbEffect();
+
+    String getName() const override { return "Reverb"; }
+    String getParameterName(int index) const override { return index == 0 ? "Size" : "Damping"; }
+    String getParameterText(int index, float value, bool tempoSync) const override;
+
+private:
+    void prepare(double sampleRate, int maximumBlockSize) override;
+    void reset() override;
+    void processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing) override;
+
+    Reverb reverb;
+};
+
+//==============================================================================
+/*
+    A short delay swept by a sine, with some feedback. The sweep can last a
+    number of beats when tempo synced.
+*/
+class FlangerEffect : public DeckEffect
+{
+public:
+    FlangerEffect();
+
+    String getName() const override { return "Flanger"; }
+    String getParameterName(int index) const override { return index == 0 ? "Rate" : "Depth"; }
+    String getParameterText(int index, float value, bool tempoSync) const override;
+
+    // tempo synced sweeps, in beats
+    static double getBeats(float value);
+
+private:
+    void prepare(double sampleRate, int maximumBlockSize) override;
+    void reset() override;
+    void processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing) override;
+
+    AudioBuffer<float> line;
+    int writePosition = 0;
+    double phase = 0;
+};
+
+//==============================================================================
+/*
+    Fewer bits and a lower sample rate, by holding samples.
+*/
+class BitCrushEffect : public DeckEffect
+{
+public:
+    BitCrushEffect();
+
+    String getName() const override { return "Bit crush"; }
+    String getParameterName(int index) const override { return index == 0 ? "Bits" : "Rate"; }
+    String getParameterText(int index, float value, bool tempoSync) const override;
+
+private:
+    void prepare(double sampleRate, int maximumBlockSize) override;
+    void reset() override;
+    void processWet(float* const* channels, int numChannels, int numSamples, const Timing& timing) override;
+
+    float held[maxChannels] = { 0, 0 };
+    float holdCounter = 0;
+};
+
+//==============================================================================
+/*
+    The effects on one deck, in order: echo, reverb, flanger, bit crush.
+*/
+class DeckEffectsRack
+{
+public:
+    enum EffectIndex
+    {
+        echo,
+        reverb,
+        flanger,
+        bitCrush,
+        numEffects
+    };
+
+    DeckEffectsRack() = default;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // audio thread. beatsPerSecond is how fast the deck is going through its
+    // track's beats right now
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples, double beatsPerSecond);
+
+    DeckEffect& getEffect(int index) { return *effects[index]; }
+
+    // delays and sweeps in beats of the deck instead of time
+    void setTempoSync(bool shouldSync);
+    bool isTempoSynced() const;
+
+private:
+    EchoEffect echoEffect;
+    ReverbEffect reverbEffect;
+    FlangerEffect flangerEffect;
+    BitCrushEffect bitCrushEffect;
+    DeckEffect* const effects[numEffects] = { &echoEffect, &reverbEffect, &flangerEffect, &bitCrushEffect };
+
+    std::atomic<bool> tempoSync{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckEffectsRack)
+};
@@ -10,25 +10,31 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "DeckGUI.h"
+#include "RealtimeLog.h"
+#include "EffectsPanel.h"
 
 //==============================================================================
 DeckGUI::DeckGUI(DJAudioPlayer* _player, 
-                AudioFormatManager & 	formatManagerToUse,
-                AudioThumbnailCache & 	cacheToUse
+                TrackDecoder & 	decoderToUse
            ) : player(_player), 
-               waveformDisplay(formatManagerToUse, cacheToUse),
+               waveformDisplay(decoderToUse),
+               levelMeter(_player->getMeter()),
     queueComponent(_player, this) // Initialize the queue component
 {
 
     addAndMakeVisible(playButton);
     addAndMakeVisible(stopButton);
     addAndMakeVisible(loadButton);
+    addAndMakeVisible(effectsButton);
+    addAndMakeVisible(lineButton);
+    addAndMakeVisible(grabButton);
        
     addAndMakeVisible(volSlider);
     addAndMakeVisible(speedSlider);
     addAndMakeVisible(posSlider);
 
     addAndMakeVisible(waveformDisplay);
+    addAndMakeVisible(levelMeter);
 
     addAndMakeVisible(queueComponent); // Make queue visible
 
@@ -55,6 +61,9 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     playButton.addListener(this);
     stopButton.addListener(this);
     loadButton.addListener(this);
+    effectsButton.addListener(this);
+    lineButton.addListener(this);
+    grabButton.addListener(this);
 
     volSlider.addListener(this);
     speedSlider.addListener(this);
@@ -77,10 +86,61 @@ DeckGUI::DeckGUI(DJAudioPlayer* _player,
     playButton.setColour(TextButton::buttonColourId, Colours::navy);
     stopButton.setColour(TextButton::buttonColourId, Colours::indigo);
     loadButton.setColour(TextButton::buttonColourId, Colours::darkslateblue);
+    effectsButton.setColour(TextButton::buttonColourId, Colours::darkslateblue);
 
     playButton.setColour(TextButton::textColourOnId, Colours::white);
     stopButton.setColour(TextButton::textColourOnId, Colours::white);
     loadButton.setColour(TextButton::textColourOnId, Colours::white);
+    effectsButton.setColour(TextButton::textColourOnId, Colours::white);
+
+    lineButton.setClickingTogglesState(true);
+    lineButton.setColour(TextButton::buttonColourId, Colours::darkslateblue);
+    lineButton.setColour(TextButton::buttonOnColourId, Colours::darkred);
+    grabButton.setColour(TextButton::buttonColourId, Colours::darkslateblue);
+    grabButton.setEnabled(false);
+
+    // Key lock, speed then changes the tempo without the pitch
+    keyLockToggle.setColour(ToggleButton::textColourId, Colours::white);
+    keyLockToggle.addListener(this);
+    addAndMakeVisible(keyLockToggle);
+
+    quantiseToggle.setColour(ToggleButton::textColourId, Colours::white);
+    addAndMakeVisible(quantiseToggle);
+
+    syncToggle.setColour(ToggleButton::textColourId, Colours::white);
+    syncToggle.addListener(this);
+    addAndMakeVisible(syncToggle);
+
+    // Hot cue buttons
+    for (int i = 0; i < LoopCueSource::numHotCues; ++i)
+    {
+        cueButtons[i].setButtonText(String(i + 1));
+        cueButtons[i].addListener(this);
+        addAndMakeVisible(cueButtons[i]);
+    }
+
+    // Beat loop length, from 1/8 to 32 beats (item id 4 is one beat)
+    StringArray loopLengths{ "1/8", "1/4", "1/2", "1", "2", "4", "8", "16", "32" };
+    loopLengthBox.addItemList(loopLengths, 1);
+    loopLengthBox.setSelectedId(6, dontSendNotification);
+    addAndMakeVisible(loopLengthBox);
+
+    loopButton.addListener(this);
+    addAndMakeVisible(loopButton);
+
+    // Tempo of the loaded track, double-click to type it in
+    bpmLabel.setText(String(player->getBeatGrid().bpm, 1) + " BPM", dontSendNotification);
+    bpmLabel.setEditable(false, true);
+    bpmLabel.setJustificationType(Justification::centred);
+    bpmLabel.setColour(Label::textColourId, Colours::white);
+    bpmLabel.addListener(this);
+    addAndMakeVisible(bpmLabel);
+
+    downbeatButton.setColour(TextButton::buttonColourId, Colours::darkslategrey);
+    downbeatButton.addListener(this);
+    addAndMakeVisible(downbeatButton);
+
+    updatePerformanceButtons();
 
     startTimer(500);
 
@@ -106,7 +166,7 @@ void DeckGUI::paint (Graphics& g)
 
 void DeckGUI::resized()
 {
-    double rowH = getHeight() / 10;
+    double rowH = getHeight() / 11;
 
     // Play/Stop buttons 
     playButton.setBounds(0, 0, getWidth() / 2, rowH);
@@ -114,10 +174,12 @@ void DeckGUI::resized()
 
     // Labels above sliders
     volLabel.setBounds(0, rowH, getWidth() / 2, rowH / 2);
-    speedLabel.setBounds(getWidth() / 2, rowH, getWidth() / 2, rowH / 2);
+    speedLabel.setBounds(getWidth() / 2, rowH, getWidth() / 4, rowH / 2);
+    keyLockToggle.setBounds(getWidth() * 3 / 4, rowH, getWidth() / 4, rowH / 2);
 
-    // Sliders below labels
-    volSlider.setBounds(0, rowH + rowH / 2, getWidth() / 2, rowH * 2);
+    // Sliders below labels, with the deck's level meter beside the volume
+    volSlider.setBounds(0, rowH + rowH / 2, getWidth() / 2 - 20, rowH * 2);
+    levelMeter.setBounds(getWidth() / 2 - 18, rowH + rowH / 2, 14, rowH * 2);
     speedSlider.setBounds(getWidth() / 2, rowH + rowH / 2, getWidth() / 2, rowH * 2);
 
     //position slider
@@ -126,24 +188,51 @@ void DeckGUI::resized()
     // Waveform
     waveformDisplay.setBounds(0, rowH * 4, getWidth(), rowH * 1.5);
 
-    // Track name and load button
-    trackNameLabel.setBounds(0, rowH * 5.5, getWidth(), rowH / 2);
-    loadButton.setBounds(0, rowH * 6, getWidth(), rowH);
+    // Track name, tempo and load button
+    trackNameLabel.setBounds(0, rowH * 5.5, getWidth() * 3 / 10, rowH / 2);
+    downbeatButton.setBounds(getWidth() * 3 / 10, rowH * 5.5, getWidth() / 10, rowH / 2);
+    quantiseToggle.setBounds(getWidth() * 2 / 5, rowH * 5.5, getWidth() / 5, rowH / 2);
+    syncToggle.setBounds(getWidth() * 3 / 5, rowH * 5.5, getWidth() / 5, rowH / 2);
+    bpmLabel.setBounds(getWidth() * 4 / 5, rowH * 5.5, getWidth() / 5, rowH / 2);
+    loadButton.setBounds(0, rowH * 6, getWidth() / 2, rowH);
+    lineButton.setBounds(getWidth() / 2, rowH * 6, getWidth() / 8, rowH);
+    grabButton.setBounds(getWidth() * 5 / 8, rowH * 6, getWidth() / 8, rowH);
+    effectsButton.setBounds(getWidth() * 3 / 4, rowH * 6, getWidth() / 4, rowH);
+
+    // Hot cues on the left half, loop controls on the right
+    int cueWidth = getWidth() / 2 / LoopCueSource::numHotCues;
+    for (int i = 0; i < LoopCueSource::numHotCues; ++i)
+    {
+        cueButtons[i].setBounds(i * cueWidth, rowH * 7, cueWidth, rowH);
+    }
+    loopLengthBox.setBounds(getWidth() / 2, rowH * 7, getWidth() / 4, rowH);
+    loopButton.setBounds(getWidth() * 3 / 4, rowH * 7, getWidth() / 4, rowH);
 
     // Queue
-    queueComponent.setBounds(0, rowH * 7, getWidth(), rowH * 3);
+    queueComponent.setBounds(0, rowH * 8, getWidth(), rowH * 3);
 }
 
 void DeckGUI::buttonClicked(Button* button)
 {
     if (button == &playButton)
     {
-        std::cout << "Play button was clicked " << std::endl;
-        player->start();
+        RealtimeLog::write(RealtimeLog::debug, "Play button was clicked");
+        if (quantiseToggle.getToggleState())
+        {
+            player->scheduleStart(DeckScheduler::asap, DeckScheduler::Quantise::bar, partner);
+        }
+        else
+        {
+            player->start();
+        }
+    }
+    if (button == &downbeatButton)
+    {
+        player->setDownbeatAtPlayhead();
     }
      if (button == &stopButton)
     {
-        std::cout << "Stop button was clicked " << std::endl;
+        RealtimeLog::write(RealtimeLog::debug, "Stop button was clicked");
         player->stop();
 
     }
@@ -160,9 +249,78 @@ void DeckGUI::buttonClicked(Button* button)
 
                      // update track name label
                      trackNameLabel.setText(chosenFile.getFileNameWithoutExtension(), dontSendNotification);
+                     updatePerformanceButtons();
                  }
              });
      }
+    if (button == &lineButton)
+    {
+        const bool useInput = lineButton.getToggleState();
+        if (useInput && !player->getLoopRecorder().isEnabled())
+        {
+            player->getLoopRecorder().setLength(loopRecorderSeconds);
+        }
+        player->setLineInput(useInput);
+        grabButton.setEnabled(useInput);
+    }
+
+    if (button == &grabButton)
+    {
+        grabLoop();
+    }
+
+    if (button == &effectsButton)
+    {
+        CallOutBox::launchAsynchronously(std::make_unique<EffectsPanel>(player->getEffects()),
+                                         effectsButton.getScreenBounds(), nullptr);
+    }
+     for (int i = 0; i < LoopCueSource::numHotCues; ++i)
+     {
+         if (button == &cueButtons[i])
+         {
+             if (ModifierKeys::currentModifiers.isShiftDown())
+             {
+                 player->clearHotCue(i);
+             }
+             else if (player->hasHotCue(i) && quantiseToggle.getToggleState())
+             {
+                 player->scheduleHotCueJump(i, DeckScheduler::asap, DeckScheduler::Quantise::beat);
+             }
+             else if (player->hasHotCue(i))
+             {
+                 player->jumpToHotCue(i);
+             }
+             else
+             {
+                 player->setHotCue(i);
+             }
+             updatePerformanceButtons();
+         }
+     }
+     if (button == &syncToggle)
+     {
+         const bool syncing = syncToggle.getToggleState() && partner != nullptr;
+         player->setSyncLeader(syncing ? partner : nullptr);
+
+         // the speed is the leader's business while synced
+         speedSlider.setEnabled(!syncing);
+     }
+     if (button == &keyLockToggle)
+     {
+         player->setKeyLock(keyLockToggle.getToggleState());
+     }
+     if (button == &loopButton)
+     {
+         if (player->isLoopActive())
+         {
+             player->exitLoop();
+         }
+         else
+         {
+             double beats = std::pow(2.0, loopLengthBox.getSelectedId() - 4);
+             player->setBeatLoop(beats);
+         }
+     }
 }
 
 void DeckGUI::sliderValueChanged (Slider *slider)
@@ -179,30 +337,142 @@ void DeckGUI::sliderValueChanged (Slider *slider)
     
     if (slider == &posSlider)
     {
-        player->setPositionRelative(slider->getValue());
+        if (player->isJogging())
+        {
+            double posInSecs = slider->getValue() * player->getLengthInSeconds();
+            double now = Time::getMillisecondCounterHiRes() / 1000.0;
+            double velocity = (posInSecs - lastJogPosition) / jmax(now - lastJogTime, 0.001);
+
+            player->setJogTarget(posInSecs, velocity);
+            lastJogPosition = posInSecs;
+            lastJogTime = now;
+        }
+        else
+        {
+            player->setPositionRelative(slider->getValue());
+        }
     }
     
 }
 
+void DeckGUI::sliderDragStarted (Slider *slider)
+{
+    if (slider == &posSlider)
+    {
+        player->startJog();
+        lastJogPosition = slider->getValue() * player->getLengthInSeconds();
+        lastJogTime = Time::getMillisecondCounterHiRes() / 1000.0;
+    }
+}
+
+void DeckGUI::sliderDragEnded (Slider *slider)
+{
+    if (slider == &posSlider)
+    {
+        // the jog can't keep up with a click or a fast drag, so the playhead
+        // ends up where the slider was let go
+        player->stopJog();
+        player->setPositionRelative(slider->getValue());
+    }
+}
+
+void DeckGUI::setPartnerDeck(DJAudioPlayer* partnerPlayer)
+{
+    partner = partnerPlayer;
+}
+
 bool DeckGUI::isInterestedInFileDrag (const StringArray &files)
 {
-  std::cout << "DeckGUI::isInterestedInFileDrag" << std::endl;
   return true; 
 }
 
 void DeckGUI::filesDropped (const StringArray &files, int x, int y)
 {
-  std::cout << "DeckGUI::filesDropped" << std::endl;
+  RealtimeLog::write(RealtimeLog::debug, "DeckGUI::filesDropped");
   if (files.size() == 1)
   {
     player->loadURL(URL{File{files[0]}});
   }
 }
 
+bool DeckGUI::isInterestedInTextDrag (const String& text)
+{
+    return text.trim().startsWithIgnoreCase("http://") || text.trim().startsWithIgnoreCase("https://");
+}
+
+void DeckGUI::textDropped (const String& text, int x, int y)
+{
+    URL url{ text.trim() };
+    player->loadURL(url);
+    waveformDisplay.loadURL(url);
+    updateTrackName(URL::removeEscapeChars(url.getFileName()));
+}
+
+void DeckGUI::labelTextChanged (Label* label)
+{
+    if (label == &bpmLabel)
+    {
+        double bpm = bpmLabel.getText().getDoubleValue();
+        if (bpm >= 40.0 && bpm <= 250.0)
+        {
+            BeatGrid grid = player->getBeatGrid();
+            grid.bpm = bpm;
+            player->setBeatGrid(grid);
+        }
+        bpmLabel.setText(String(player->getBeatGrid().bpm, 1) + " BPM", dontSendNotification);
+    }
+}
+
 void DeckGUI::timerCallback()
 {
     waveformDisplay.setPositionRelative(
             player->getPositionRelative());
+    updatePerformanceButtons();
+
+    // a MIDI controller may have moved them
+    if (!volSlider.isMouseButtonDown())
+    {
+        volSlider.setValue(player->getGain(), dontSendNotification);
+    }
+    if (!speedSlider.isMouseButtonDown() && speedSlider.isEnabled())
+    {
+        speedSlider.setValue(player->getSpeed(), dontSendNotification);
+    }
+
+    // each track has its own grid, so this changes when another one is loaded
+    if (!bpmLabel.isBeingEdited())
+    {
+        bpmLabel.setText(String(player->getBeatGrid().bpm, 1) + " BPM", dontSendNotification);
+    }
+}
+
+void DeckGUI::updatePerformanceButtons()
+{
+    for (int i = 0; i < LoopCueSource::numHotCues; ++i)
+    {
+        cueButtons[i].setColour(TextButton::buttonColourId,
+                                player->hasHotCue(i) ? Colours::darkorange : Colours::darkslategrey);
+    }
+
+    loopButton.setColour(TextButton::buttonColourId,
+                         player->isLoopActive() ? Colours::seagreen : Colours::darkslategrey);
+}
+
+void DeckGUI::grabLoop()
+{
+    const BeatGrid grid = partner != nullptr ? partner->getBeatGrid() : BeatGrid();
+    const double seconds = partner != nullptr && grid.isValid() ? 16.0 * grid.getSecondsPerBeat() : 8.0;
+
+    const String name = "Loop " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S");
+    const File file = File::getSpecialLocation(File::userApplicationDataDirectory)
+                          .getChildFile("OtoDecks")
+                          .getChildFile("Loops")
+                          .getChildFile(name + ".wav");
+
+    if (player->getLoopRecorder().captureToFile(seconds, file))
+    {
+        addToQueue(URL(file), name);
+    }
 }
 
 void DeckGUI::updateWaveformDisplay(URL audioURL)
@@ -221,6 +491,21 @@ void DeckGUI::addToQueue(const URL& url, const String& trackName)
     queueComponent.addToQueue(url, trackName);
 }
 
+void DeckGUI::playNextInQueue()
+{
+    queueComponent.playNextInQueue();
+}
+
+void DeckGUI::clearQueue()
+{
+    queueComponent.clearQueue();
+}
+
+String DeckGUI::getTrackName() const
+{
+    return trackNameLabel.getText();
+}
+
 
     
 
@@ -22,12 +22,13 @@ class DeckGUI    : public Component,
                    public Button::Listener, 
                    public Slider::Listener, 
                    public FileDragAndDropTarget, 
+                   public TextDragAndDropTarget,
+                   public Label::Listener,
                    public Timer
 {
 public:
     DeckGUI(DJAudioPlayer* player, 
-           AudioFormatManager & 	formatManagerToUse,
-           AudioThumbnailCache & 	cacheToUse );
+           TrackDecoder & 	decoderToUse );
     ~DeckGUI();
 
     void paint (Graphics&) override;
@@ -39,9 +40,20 @@ public:
     /** implement Slider::Listener */
     void sliderValueChanged (Slider *slider) override;
 
+    // dragging the position slider scratches instead of seeking
+    void sliderDragStarted (Slider *slider) override;
+    void sliderDragEnded (Slider *slider) override;
+
     bool isInterestedInFileDrag (const StringArray &files) override;
     void filesDropped (const StringArray &files, int x, int y) override; 
 
+    // http(s) links dragged in from a browser stream onto the deck
+    bool isInterestedInTextDrag (const String& text) override;
+    void textDropped (const String& text, int x, int y) override;
+
+    /** implement Label::Listener, for typing in the BPM */
+    void labelTextChanged (Label* label) override;
+
     void timerCallback() override; 
 
     // Add these two new methods here
@@ -50,13 +62,36 @@ public:
 
     // Method to add a track to the queue
     void addToQueue(const URL& url, const String& trackName);
+    void playNextInQueue();
+    void clearQueue();
+
+    // what the deck shows as playing
+    String getTrackName() const;
 
+    // the other deck, whose bars a quantised PLAY lines up with and which Sync follows
+    void setPartnerDeck(DJAudioPlayer* partnerPlayer);
 
 private:
+    // colour the cue and loop buttons to match the player
+    void updatePerformanceButtons();
+
+    // the last four bars of the line input at the partner's tempo, or eight
+    // seconds without one, into a WAV file and onto the queue
+    void grabLoop();
+
+    // how much of the line input is kept for GRAB, allocated the first time LINE is used
+    static constexpr double loopRecorderSeconds = 20.0;
+
 
     TextButton playButton{"PLAY"};
     TextButton stopButton{"STOP"};
     TextButton loadButton{"LOAD"};
+    TextButton effectsButton{"FX"};
+
+    // play the sound card's inputs instead of the track, and save what they
+    // just played as a loop in the deck's queue
+    TextButton lineButton{"LINE"};
+    TextButton grabButton{"GRAB"};
   
     Slider volSlider; 
     Slider speedSlider;
@@ -64,18 +99,40 @@ private:
 
     Label volLabel;
     Label speedLabel;
+    ToggleButton keyLockToggle{"Key Lock"};
+
+    // PLAY waits for the partner's next bar, hot cues for this deck's next beat
+    ToggleButton quantiseToggle{"Quantise"};
+
+    // follow the partner's tempo and beat
+    ToggleButton syncToggle{"Sync"};
 
     Label trackNameLabel; // display the currently loaded track name label
 
+    // hot cues: click to set, click again to jump, shift-click to clear
+    TextButton cueButtons[LoopCueSource::numHotCues];
+    ComboBox loopLengthBox;
+    TextButton loopButton{"LOOP"};
+    Label bpmLabel;
+
+    // the first beat of the grid is where the playhead is now
+    TextButton downbeatButton{"DOWN"};
+
+    // last position sent while scratching, to work out how fast the hand is moving
+    double lastJogPosition = 0;
+    double lastJogTime = 0;
+
 
     FileChooser fChooser{"Select a file..."};
 
 
     WaveformDisplay waveformDisplay;
+    LevelMeterComponent levelMeter;
 
     Queue queueComponent; // adds the queue component
 
     DJAudioPlayer* player; 
+    DJAudioPlayer* partner = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
 };
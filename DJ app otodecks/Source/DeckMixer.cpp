@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    DeckMixer.cpp
+    Created: 20 Oct 2026 9:12:26am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "DeckMixer.h"
+
+//==============================================================================
+DeckMixer::DeckMixer(std::initializer_list<DJAudioPlayer*> decksToMix)
+{
+    jassert(decksToMix.size() <= (size_t) maxDecks);
+    for (DJAudioPlayer* deck : decksToMix)
+    {
+        if (numDecks < maxDecks)
+        {
+            decks[numDecks++] = deck;
+        }
+    }
+}
+
+void DeckMixer::setCueDelay(int numSamples)
+{
+    cueDelaySamples = jmax(0, numSamples);
+}
+
+void DeckMixer::prepareToPlay(int samplesPerBlockExpected, double /*sampleRate*/)
+{
+    deckBuffer.setSize(2, samplesPerBlockExpected);
+    cueBus.setSize(2, samplesPerBlockExpected);
+    lineInput.setSize(2, samplesPerBlockExpected);
+    cueDelayLine.setSize(2, cueDelaySamples);
+    cueDelayLine.clear();
+    cueDelayPosition = 0;
+    appliedCueMix = cueMix.load();
+}
+
+void DeckMixer::releaseResources()
+{
+    deckBuffer.setSize(2, 0);
+    cueBus.setSize(2, 0);
+    lineInput.setSize(2, 0);
+    cueDelayLine.setSize(2, 0);
+}
+
+void DeckMixer::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    AudioBuffer<float>& output = *bufferToFill.buffer;
+    const int numSamples = bufferToFill.numSamples;
+    if (output.getNumChannels() == 0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    // only ever grows, and only if the device sends a bigger block than it said
+    deckBuffer.setSize(2, numSamples, false, false, true);
+    cueBus.setSize(2, numSamples, false, false, true);
+    cueBus.clear(0, numSamples);
+    lineInput.setSize(2, numSamples, false, false, true);
+
+    // the device's inputs arrive in the first channels, and are gone once the
+    // first deck has played over them. Silent if none are open
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        lineInput.copyFrom(channel, 0, output, jmin(channel, output.getNumChannels() - 1),
+                           bufferToFill.startSample, numSamples);
+    }
+
+    // the decks only see the master pair of the device's channels
+    AudioBuffer<float> master(output.getArrayOfWritePointers(), jmin(2, output.getNumChannels()),
+                              bufferToFill.startSample, numSamples);
+
+    if (numDecks == 0)
+    {
+        master.clear();
+    }
+    else
+    {
+        // the first deck straight into the output, the rest added on
+        decks[0]->getNextAudioBlock(AudioSourceChannelInfo(&master, 0, numSamples), cueBus, &lineInput);
+
+        for (int i = 1; i < numDecks; ++i)
+        {
+            AudioBuffer<float> deck(deckBuffer.getArrayOfWritePointers(), master.getNumChannels(), numSamples);
+            decks[i]->getNextAudioBlock(AudioSourceChannelInfo(&deck, 0, numSamples), cueBus, &lineInput);
+
+            for (int channel = 0; channel < master.getNumChannels(); ++channel)
+            {
+                master.addFrom(channel, 0, deck, channel, 0, numSamples);
+            }
+        }
+    }
+
+    for (int channel = 2; channel < output.getNumChannels(); ++channel)
+    {
+        output.clear(channel, bufferToFill.startSample, numSamples);
+    }
+}
+
+void DeckMixer::routeCue(const AudioSourceChannelInfo& bufferToFill)
+{
+    AudioBuffer<float>& output = *bufferToFill.buffer;
+    const int start = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+
+    const float targetMix = cueMix.load();
+    const float startMix = appliedCueMix;
+    appliedCueMix = targetMix;
+
+    if (numSamples <= 0 || numSamples > cueBus.getNumSamples())
+    {
+        return;
+    }
+
+    // lined up with the master, which has been through the limiter since the decks played
+    delayCue(numSamples);
+
+    if (hasCueOutputs(output.getNumChannels()))
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            output.copyFromWithRamp(channel + 2, start, cueBus.getReadPointer(channel), numSamples,
+                                    1.0f - startMix, 1.0f - targetMix);
+            output.addFromWithRamp(channel + 2, start, output.getReadPointer(channel, start), numSamples,
+                                   startMix, targetMix);
+        }
+    }
+    else if (splitCue.load() && output.getNumChannels() == 2)
+    {
+        // both sides folded to mono, the master on the left and the cue mix on the right
+        float* left = output.getWritePointer(0, start);
+        float* masterMono = deckBuffer.getWritePointer(0);
+
+        FloatVectorOperations::add(masterMono, left, output.getReadPointer(1, start), numSamples);
+        FloatVectorOperations::multiply(masterMono, 0.5f, numSamples);
+        FloatVectorOperations::copy(left, masterMono, numSamples);
+
+        output.copyFromWithRamp(1, start, cueBus.getReadPointer(0), numSamples,
+                                0.5f * (1.0f - startMix), 0.5f * (1.0f - targetMix));
+        output.addFromWithRamp(1, start, cueBus.getReadPointer(1), numSamples,
+                               0.5f * (1.0f - startMix), 0.5f * (1.0f - targetMix));
+        output.addFromWithRamp(1, start, masterMono, numSamples, startMix, targetMix);
+    }
+}
+
+void DeckMixer::delayCue(int numSamples)
+{
+    const int length = cueDelayLine.getNumSamples();
+    if (length == 0)
+    {
+        return;
+    }
+
+    // each sample swapped with the one from length samples ago
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* cue = cueBus.getWritePointer(channel);
+        float* line = cueDelayLine.getWritePointer(channel);
+        int position = cueDelayPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = cue[i];
+            cue[i] = line[position];
+            line[position] = in;
+            if (++position == length)
+            {
+                position = 0;
+            }
+        }
+    }
+    cueDelayPosition = (cueDelayPosition + numSamples) % length;
+}
+
+//==============================================================================
+void DeckMixer::setCueMix(float mix)
+{
+    cueMix = jlimit(0.0f, 1.0f, mix);
+}
+
+float DeckMixer::getCueMix() const
+{
+    return cueMix.load();
+}
+
+void DeckMixer::setSplitCue(bool shouldSplit)
+{
+    splitCue = shouldSplit;
+}
+
+bool DeckMixer::isSplitCue() const
+{
+    return splitCue.load();
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    DeckMixer.h
+    Created: 20 Oct 2026 9:12:26am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+
+//==============================================================================
+/*
+    Sums the decks into the master and, in the same pass, the decks with PFL
+    on into a cue bus for the headphones.
+
+    Each deck is also handed the device's inputs for the block, in case it
+    is switched to its line input.
+
+    The cue goes to outputs 3/4 when the device has them, blended with the
+    master by the cue mix. On a plain stereo device it can be split instead:
+    the master in mono on the left and the cue mix on the right, for a Y cable.
+    The cue is delayed by as much as the master chain delays the master, so
+    a deck heard in both doesn't flam in the headphones.
+
+    Nothing is allocated on the audio thread unless a block is bigger than the
+    one it was prepared for.
+*/
+class DeckMixer
+{
+public:
+    static constexpr int maxDecks = 4;
+
+    DeckMixer(std::initializer_list<DJAudioPlayer*> decksToMix);
+
+    // how far the master is behind the decks by the time routeCue sees it,
+    // e.g. the limiter's lookahead. Set before prepareToPlay
+    void setCueDelay(int numSamples);
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+
+    // audio thread: the master into the first two channels, anything past them silent
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    // audio thread, once the master is finished: the headphone mix into
+    // outputs 3/4, or split across the first two
+    void routeCue(const AudioSourceChannelInfo& bufferToFill);
+
+    // 0 for just the cue in the headphones, 1 for just the master
+    void setCueMix(float mix);
+    float getCueMix() const;
+
+    // master left, cue right, on devices without outputs 3/4
+    void setSplitCue(bool shouldSplit);
+    bool isSplitCue() const;
+
+    // where the cue is going with this many outputs
+    static bool hasCueOutputs(int numOutputChannels) { return numOutputChannels >= 4; }
+
+private:
+    // the cue bus through the delay line, in place
+    void delayCue(int numSamples);
+
+    DJAudioPlayer* decks[maxDecks] = {};
+    int numDecks = 0;
+
+    // audio thread only
+    AudioBuffer<float> deckBuffer;
+    AudioBuffer<float> cueBus;
+    AudioBuffer<float> lineInput;
+    float appliedCueMix = 0.0f;
+
+    int cueDelaySamples = 0;
+    AudioBuffer<float> cueDelayLine;
+    int cueDelayPosition = 0;
+
+    std::atomic<float> cueMix{ 0.0f };
+    std::atomic<bool> splitCue{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckMixer)
+};
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    DeckScheduler.cpp
+    Created: 20 Oct 2026 3:47:19am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "DeckScheduler.h"
+#include "RealtimeLog.h"
+
+//==============================================================================
+void DeckScheduler::Timeline::publish(int64 sampleTime, double trackSeconds, double trackLengthSeconds,
+                                      double trackSecondsPerSample, bool playing)
+{
+    position.store(trackSeconds, std::memory_order_relaxed);
+    length.store(trackLengthSeconds, std::memory_order_relaxed);
+    secondsPerSample.store(trackSecondsPerSample, std::memory_order_relaxed);
+    moving.store(playing && trackSecondsPerSample > 0, std::memory_order_relaxed);
+    time.store(sampleTime, std::memory_order_relaxed);
+}
+
+void DeckScheduler::Timeline::setBeatGrid(const BeatGrid& grid)
+{
+    bpm = grid.bpm;
+    firstBeatSeconds = grid.firstBeatSeconds;
+}
+
+int64 DeckScheduler::Timeline::getNextBoundary(int64 earliest, Quantise quantise) const
+{
+    const double rate = secondsPerSample.load(std::memory_order_relaxed);
+    if (!isPlaying() || rate <= 0)
+    {
+        return -1;
+    }
+
+    const int64 publishedTime = getSampleTime();
+    const double publishedPosition = position.load(std::memory_order_relaxed);
+    const double unit = 60.0 / bpm.load() * (quantise == Quantise::bar ? beatsPerBar : 1);
+    const double firstBeat = firstBeatSeconds.load();
+
+    // where the track will be at earliest, then the first boundary from there
+    earliest = jmax(earliest, publishedTime);
+    const double earliestPosition = publishedPosition + (earliest - publishedTime) * rate;
+    const double boundary = firstBeat + std::ceil((earliestPosition - firstBeat) / unit - 1.0e-9) * unit;
+
+    return jmax(earliest, publishedTime + (int64) std::llround((boundary - publishedPosition) / rate));
+}
+
+double DeckScheduler::Timeline::getBeatsAt(int64 sampleTime) const
+{
+    const double elapsed = isPlaying() ? (sampleTime - getSampleTime()) * secondsPerSample.load() : 0.0;
+    return (position.load() + elapsed - firstBeatSeconds.load()) / getSecondsPerBeat();
+}
+
+double DeckScheduler::Timeline::getBeatsPerSample() const
+{
+    return isPlaying() ? secondsPerSample.load() / getSecondsPerBeat() : 0.0;
+}
+
+//==============================================================================
+bool DeckScheduler::post(const Event& event)
+{
+    const SpinLock::ScopedLockType sl(postLock);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    posted[size1 > 0 ? start1 : start2] = event;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+void DeckScheduler::clear()
+{
+    clearRequested = true;
+}
+
+void DeckScheduler::collect(const Timeline& own)
+{
+    if (clearRequested.exchange(false))
+    {
+        numPending = 0;
+        fifo.finishedRead(fifo.getNumReady());
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    auto add = [this, &own](Event event)
+    {
+        if (event.quantise != Quantise::none)
+        {
+            const Timeline* grid = event.grid != nullptr && event.grid->isPlaying() ? event.grid : &own;
+            const int64 boundary = grid->getNextBoundary(event.time, event.quantise);
+            if (boundary >= 0)
+            {
+                event.time = boundary;
+            }
+            event.quantise = Quantise::none;
+        }
+
+        if (numPending == capacity)
+        {
+            RealtimeLog::write(RealtimeLog::warning, "DeckScheduler::collect too many events, one was dropped");
+            return;
+        }
+
+        // in time order, after any others at the same time
+        int index = numPending;
+        while (index > 0 && pending[index - 1].time > event.time)
+        {
+            pending[index] = pending[index - 1];
+            --index;
+        }
+        pending[index] = event;
+        ++numPending;
+    };
+
+    for (int i = 0; i < size1; ++i)
+    {
+        add(posted[start1 + i]);
+    }
+    for (int i = 0; i < size2; ++i)
+    {
+        add(posted[start2 + i]);
+    }
+    fifo.finishedRead(size1 + size2);
+}
+
+bool DeckScheduler::popNextDue(int64 endTime, Event& event)
+{
+    if (numPending == 0 || pending[0].time >= endTime)
+    {
+        return false;
+    }
+
+    event = pending[0];
+    --numPending;
+    for (int i = 0; i < numPending; ++i)
+    {
+        pending[i] = pending[i + 1];
+    }
+    return true;
+}
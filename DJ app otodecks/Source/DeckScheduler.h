@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    DeckScheduler.h
+    Created: 20 Oct 2026 3:47:19am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BeatGrid.h"
+
+//==============================================================================
+/*
+    Transport events for a deck, to be carried out by the audio thread at an
+    exact sample of the output rather than at whatever block follows the
+    click. Times are counted in output samples since the deck was prepared,
+    and both decks count together because the mixer pulls them in step.
+
+    An event can also be quantised, so it happens on the next beat or bar of
+    a deck's beat grid at or after its time.
+
+    Any thread other than the audio one can post. Posting only ever waits on
+    other posters, the audio thread takes events without locking.
+*/
+class DeckScheduler
+{
+public:
+    enum class Action
+    {
+        start,
+        stop,
+        jumpToHotCue
+    };
+
+    enum class Quantise
+    {
+        none,
+        beat,
+        bar
+    };
+
+    static constexpr int beatsPerBar = 4;
+
+    // for events that should happen at the start of the next block
+    static constexpr int64 asap = 0;
+
+    //==============================================================================
+    /*
+        Where a deck is in its track at a point on the output clock, so an
+        event can be lined up with its beats. Written by the audio thread at
+        the end of every block.
+    */
+    class Timeline
+    {
+    public:
+        void publish(int64 sampleTime, double trackSeconds, double trackLengthSeconds,
+                     double trackSecondsPerSample, bool playing);
+        void setBeatGrid(const BeatGrid& grid);
+
+        int64 getSampleTime() const { return time.load(std::memory_order_relaxed); }
+        bool isPlaying() const { return moving.load(std::memory_order_relaxed); }
+
+        // where the track was and how long it is, as of the last block
+        double getTrackSeconds() const { return position.load(std::memory_order_relaxed); }
+        double getTrackLengthSeconds() const { return length.load(std::memory_order_relaxed); }
+
+        // the first beat or bar at or after earliest, or -1 if the deck isn't moving
+        int64 getNextBoundary(int64 earliest, Quantise quantise) const;
+
+        // how many beats into the track it is at sampleTime, if it carries on as it is
+        double getBeatsAt(int64 sampleTime) const;
+
+        // how fast it is going through beats, 0 if it isn't moving
+        double getBeatsPerSample() const;
+        double getSecondsPerBeat() const { return 60.0 / bpm.load(); }
+
+    private:
+        std::atomic<int64> time{ 0 };
+        std::atomic<double> position{ 0 };
+        std::atomic<double> length{ 0 };
+        std::atomic<double> secondsPerSample{ 0 };
+        std::atomic<bool> moving{ false };
+        std::atomic<double> bpm{ 120.0 };
+        std::atomic<double> firstBeatSeconds{ 0 };
+    };
+
+    struct Event
+    {
+        Action action = Action::start;
+        int64 time = asap;
+        Quantise quantise = Quantise::none;
+
+        // whose beats to quantise to, nullptr for the deck's own. If that deck
+        // isn't playing, the deck's own are used, and if neither is it happens at time
+        const Timeline* grid = nullptr;
+
+        int hotCue = 0;
+    };
+
+    // false if too many are waiting
+    bool post(const Event& event);
+
+    // forget everything that hasn't happened yet
+    void clear();
+
+    // audio thread: take what was posted, working out quantised times from
+    // the deck's own timeline
+    void collect(const Timeline& own);
+
+    // audio thread: the next event due before endTime, if there is one. Late
+    // events are due straight away
+    bool popNextDue(int64 endTime, Event& event);
+
+    static constexpr int capacity = 64;
+
+private:
+    AbstractFifo fifo{ capacity };
+    Event posted[capacity];
+    SpinLock postLock;
+
+    // audio thread only, in time order
+    Event pending[capacity];
+    int numPending = 0;
+
+    std::atomic<bool> clearRequested{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckScheduler)
+};
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    DecodedTrackSource.cpp
+    Created: 19 Oct 2026 4:58:40pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackSource.h"
+
+//==============================================================================
+DecodedTrackSource::DecodedTrackSource(DecodedTrack::Ptr trackToPlay)
+    : track(trackToPlay)
+{
+}
+
+DecodedTrackSource::~DecodedTrackSource()
+{
+}
+
+void DecodedTrackSource::prepareToPlay(int, double)
+{
+}
+
+void DecodedTrackSource::releaseResources()
+{
+}
+
+void DecodedTrackSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    track->read(*bufferToFill.buffer, bufferToFill.startSample, nextReadPosition, bufferToFill.numSamples);
+    nextReadPosition += bufferToFill.numSamples;
+}
+
+void DecodedTrackSource::setNextReadPosition(int64 newPosition)
+{
+    nextReadPosition = jmax((int64) 0, newPosition);
+}
+
+int64 DecodedTrackSource::getNextReadPosition() const
+{
+    return nextReadPosition;
+}
+
+int64 DecodedTrackSource::getTotalLength() const
+{
+    return track->getLengthInSamples();
+}
+
+bool DecodedTrackSource::isLooping() const
+{
+    return false;
+}
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    DecodedTrackSource.h
+    Created: 19 Oct 2026 4:58:40pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackDecoder.h"
+
+//==============================================================================
+/*
+    Plays a DecodedTrack straight out of memory. Anything the decoder hasn't
+    got to yet plays as silence.
+*/
+class DecodedTrackSource : public PositionableAudioSource
+{
+public:
+    DecodedTrackSource(DecodedTrack::Ptr trackToPlay);
+    ~DecodedTrackSource();
+
+    DecodedTrack* getTrack() const { return track.get(); }
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override;
+
+private:
+    DecodedTrack::Ptr track;
+    int64 nextReadPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackSource)
+};
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    EffectsPanel.cpp
+    Created: 20 Oct 2026 7:31:44am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "EffectsPanel.h"
+
+//==============================================================================
+EffectsPanel::EffectsPanel(DeckEffectsRack& rackToControl)
+    : rack(rackToControl)
+{
+    tempoSyncToggle.setToggleState(rack.isTempoSynced(), dontSendNotification);
+    tempoSyncToggle.setColour(ToggleButton::textColourId, Colours::white);
+    tempoSyncToggle.addListener(this);
+    addAndMakeVisible(tempoSyncToggle);
+
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        DeckEffect& deckEffect = rack.getEffect(effect);
+
+        auto* toggle = enabledToggles.add(new ToggleButton(deckEffect.getName()));
+        toggle->setToggleState(deckEffect.isEnabled(), dontSendNotification);
+        toggle->setColour(ToggleButton::textColourId, Colours::white);
+        toggle->addListener(this);
+        addAndMakeVisible(toggle);
+
+        for (int knob = 0; knob < knobsPerEffect; ++knob)
+        {
+            auto* label = knobLabels.add(new Label({}, knob == 0 ? "Mix" : deckEffect.getParameterName(knob - 1)));
+            label->setColour(Label::textColourId, Colours::white);
+            label->setFont(Font(12.0f));
+            label->setJustificationType(Justification::centred);
+            addAndMakeVisible(label);
+
+            auto* slider = knobs.add(new Slider(Slider::RotaryHorizontalVerticalDrag, Slider::TextBoxBelow));
+            slider->setRange(0.0, 1.0);
+            slider->setTextBoxStyle(Slider::TextBoxBelow, true, 80, 16);
+            slider->setColour(Slider::thumbColourId, Colours::white);
+            slider->setColour(Slider::rotarySliderFillColourId, Colours::orange);
+            if (knob == 0)
+            {
+                slider->textFromValueFunction = [](double value) { return String(roundToInt(value * 100.0)) + "%"; };
+                slider->setValue(deckEffect.getMix(), dontSendNotification);
+            }
+            else
+            {
+                const int parameter = knob - 1;
+                slider->textFromValueFunction = [this, &deckEffect, parameter](double value)
+                {
+                    return deckEffect.getParameterText(parameter, (float) value, rack.isTempoSynced());
+                };
+                slider->setValue(deckEffect.getParameter(parameter), dontSendNotification);
+            }
+            slider->updateText();
+            slider->addListener(this);
+            addAndMakeVisible(slider);
+        }
+
+        auto* cpu = cpuLabels.add(new Label());
+        cpu->setColour(Label::textColourId, Colours::lightgrey);
+        cpu->setFont(Font(12.0f));
+        addAndMakeVisible(cpu);
+    }
+
+    timerCallback();
+    startTimer(250);
+
+    setSize(420, headerHeight + DeckEffectsRack::numEffects * rowHeight);
+}
+
+EffectsPanel::~EffectsPanel()
+{
+    stopTimer();
+    tempoSyncToggle.removeListener(this);
+    for (auto* toggle : enabledToggles)
+    {
+        toggle->removeListener(this);
+    }
+    for (auto* knob : knobs)
+    {
+        knob->removeListener(this);
+    }
+}
+
+void EffectsPanel::paint(Graphics& g)
+{
+    g.fillAll(Colours::slategrey);
+
+    // a line between the effects
+    g.setColour(Colours::darkslategrey);
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        g.drawHorizontalLine(headerHeight + effect * rowHeight, 0.0f, (float) getWidth());
+    }
+}
+
+void EffectsPanel::resized()
+{
+    tempoSyncToggle.setBounds(5, 2, 150, headerHeight - 4);
+
+    const int knobWidth = 80;
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        const int y = headerHeight + effect * rowHeight;
+        enabledToggles[effect]->setBounds(5, y + 4, 95, 24);
+        cpuLabels[effect]->setBounds(5, y + 30, 95, 20);
+
+        for (int knob = 0; knob < knobsPerEffect; ++knob)
+        {
+            const int x = 100 + knob * (knobWidth + 5);
+            knobLabels[effect * knobsPerEffect + knob]->setBounds(x, y + 2, knobWidth, 16);
+            getKnob(effect, knob)->setBounds(x, y + 18, knobWidth, rowHeight - 22);
+        }
+    }
+}
+
+void EffectsPanel::sliderValueChanged(Slider* slider)
+{
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        DeckEffect& deckEffect = rack.getEffect(effect);
+        if (slider == getKnob(effect, 0))
+        {
+            deckEffect.setMix((float) slider->getValue());
+        }
+        for (int parameter = 0; parameter < DeckEffect::numParameters; ++parameter)
+        {
+            if (slider == getKnob(effect, parameter + 1))
+            {
+                deckEffect.setParameter(parameter, (float) slider->getValue());
+            }
+        }
+    }
+}
+
+void EffectsPanel::buttonClicked(Button* button)
+{
+    if (button == &tempoSyncToggle)
+    {
+        rack.setTempoSync(tempoSyncToggle.getToggleState());
+
+        // times read as beats now, or back to ms
+        for (auto* knob : knobs)
+        {
+            knob->updateText();
+        }
+    }
+
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        if (button == enabledToggles[effect])
+        {
+            rack.getEffect(effect).setEnabled(button->getToggleState());
+        }
+    }
+}
+
+void EffectsPanel::timerCallback()
+{
+    for (int effect = 0; effect < DeckEffectsRack::numEffects; ++effect)
+    {
+        const float load = rack.getEffect(effect).getCpuLoad();
+        cpuLabels[effect]->setText(load > 0.0f ? "CPU " + String(load * 100.0f, 2) + "%" : "bypassed",
+                                   dontSendNotification);
+    }
+}
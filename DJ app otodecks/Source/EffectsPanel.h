@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    EffectsPanel.h
+    Created: 20 Oct 2026 7:31:44am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckEffects.h"
+
+//==============================================================================
+/*
+    A deck's effects, shown in a call-out from its FX button: a row per
+    effect with its switch, mix and two parameters, and how much of the
+    audio thread's time it is taking.
+*/
+class EffectsPanel : public Component,
+                     public Slider::Listener,
+                     public Button::Listener,
+                     private Timer
+{
+public:
+    EffectsPanel(DeckEffectsRack& rackToControl);
+    ~EffectsPanel();
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    /** implement Slider::Listener */
+    void sliderValueChanged(Slider* slider) override;
+
+    /** implement Button::Listener */
+    void buttonClicked(Button* button) override;
+
+private:
+    /** implement Timer, refreshes the CPU loads */
+    void timerCallback() override;
+
+    // the mix and parameter knobs of an effect, 0 for the mix
+    Slider* getKnob(int effect, int knob) { return knobs[effect * knobsPerEffect + knob]; }
+
+    DeckEffectsRack& rack;
+
+    ToggleButton tempoSyncToggle{ "Tempo sync" };
+    OwnedArray<ToggleButton> enabledToggles;
+    OwnedArray<Slider> knobs;
+    OwnedArray<Label> knobLabels;
+    OwnedArray<Label> cpuLabels;
+
+    static constexpr int knobsPerEffect = 1 + DeckEffect::numParameters;
+    static constexpr int headerHeight = 28;
+    static constexpr int rowHeight = 88;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectsPanel)
+};
@@ -0,0 +1,339 @@
+/*
+  ==============================================================================
+
+    GaplessTrackSource.cpp
+    Created: 19 Oct 2026 10:02:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "GaplessTrackSource.h"
+
+//==============================================================================
+GaplessTrackSource::GaplessTrackSource()
+{
+}
+
+GaplessTrackSource::~GaplessTrackSource()
+{
+    releaseResources();
+}
+
+void GaplessTrackSource::setCurrentTrack(std::unique_ptr<PositionableAudioSource> newTrack, double sampleRate)
+{
+    // get the new track ready before taking the lock, this can take a moment
+    if (newTrack != nullptr && preparedBlockSize > 0)
+    {
+        newTrack->prepareToPlay(preparedBlockSize, preparedSampleRate);
+    }
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        std::swap(currentTrack, newTrack);
+        currentSampleRate = sampleRate;
+        pendingPosition = -1;
+        publishState();
+    }
+
+    // newTrack now holds the old track, which is deleted here outside the lock
+    if (newTrack != nullptr)
+    {
+        newTrack->releaseResources();
+    }
+}
+
+void GaplessTrackSource::setNextTrack(std::unique_ptr<PositionableAudioSource> newTrack, double sampleRate)
+{
+    if (newTrack != nullptr && preparedBlockSize > 0)
+    {
+        newTrack->prepareToPlay(preparedBlockSize, preparedSampleRate);
+    }
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        std::swap(nextTrack, newTrack);
+        nextSampleRate = sampleRate;
+        publishState();
+    }
+
+    if (newTrack != nullptr)
+    {
+        newTrack->releaseResources();
+    }
+}
+
+void GaplessTrackSource::clearNextTrack()
+{
+    setNextTrack(nullptr, 0);
+}
+
+bool GaplessTrackSource::hasNextTrack() const
+{
+    return publishedHasNext.load();
+}
+
+bool GaplessTrackSource::canJoinNextTrack() const
+{
+    return publishedCanJoin.load();
+}
+
+bool GaplessTrackSource::moveToNextTrack()
+{
+    std::unique_ptr<PositionableAudioSource> oldTrack;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        if (nextTrack == nullptr)
+        {
+            return false;
+        }
+
+        oldTrack = std::move(currentTrack);
+        currentTrack = std::move(nextTrack);
+        currentSampleRate = nextSampleRate;
+        currentTrack->setNextReadPosition(0);
+        pendingPosition = -1;
+        ++trackChangeCount;
+        publishState();
+    }
+
+    if (oldTrack != nullptr)
+    {
+        oldTrack->releaseResources();
+    }
+    return true;
+}
+
+void GaplessTrackSource::skipToNextTrack()
+{
+    skipRequested = true;
+}
+
+void GaplessTrackSource::setCrossfadeSeconds(double seconds)
+{
+    crossfadeSeconds = jmax(0.0, seconds);
+}
+
+double GaplessTrackSource::getCurrentSampleRate() const
+{
+    return publishedSampleRate.load();
+}
+
+void GaplessTrackSource::releaseFinishedTracks()
+{
+    // called after every change message, but only takes the lock when there is
+    // something to take, so the audio thread rarely finds it held
+    if (numFinishedTracks.load() == 0)
+    {
+        return;
+    }
+
+    std::unique_ptr<PositionableAudioSource> toDelete[maxFinishedTracks];
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        for (int i = 0; i < maxFinishedTracks; ++i)
+        {
+            toDelete[i] = std::move(finishedTracks[i]);
+        }
+        numFinishedTracks = 0;
+    }
+
+    for (auto& track : toDelete)
+    {
+        if (track != nullptr)
+        {
+            track->releaseResources();
+        }
+    }
+}
+
+//==============================================================================
+void GaplessTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    preparedBlockSize = samplesPerBlockExpected;
+    preparedSampleRate = sampleRate;
+
+    // the crossfade is mixed in chunks, so this doesn't need to fit a whole block
+    fadeBuffer.setSize(2, jmax(samplesPerBlockExpected, 1024));
+
+    const SpinLock::ScopedLockType sl(lock);
+    if (currentTrack != nullptr)
+    {
+        currentTrack->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+    if (nextTrack != nullptr)
+    {
+        nextTrack->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+}
+
+void GaplessTrackSource::releaseResources()
+{
+    preparedBlockSize = 0;
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        if (currentTrack != nullptr)
+        {
+            currentTrack->releaseResources();
+        }
+        if (nextTrack != nullptr)
+        {
+            nextTrack->releaseResources();
+        }
+    }
+
+    releaseFinishedTracks();
+}
+
+void GaplessTrackSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const SpinLock::ScopedTryLockType sl(lock);
+
+    // the message thread is swapping tracks, skip this block rather than wait
+    if (!sl.isLocked() || currentTrack == nullptr)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    const int64 seek = pendingPosition.exchange(-1);
+    if (seek >= 0)
+    {
+        currentTrack->setNextReadPosition(seek);
+
+        // if we were part way through a crossfade, the next track starts over
+        if (nextTrack != nullptr)
+        {
+            nextTrack->setNextReadPosition(0);
+        }
+    }
+
+    if (skipRequested.exchange(false) && nextTrack != nullptr && nextSampleRate == currentSampleRate)
+    {
+        nextTrack->setNextReadPosition(0);
+        switchToNextTrack();
+    }
+
+    int done = 0;
+    while (done < bufferToFill.numSamples)
+    {
+        const bool canJoin = nextTrack != nullptr && nextSampleRate == currentSampleRate;
+        const int64 position = currentTrack->getNextReadPosition();
+        const int64 length = currentTrack->getTotalLength();
+
+        // the current track has run out, carry on with the next one from this very sample
+        if (position >= length && canJoin && switchToNextTrack())
+        {
+            continue;
+        }
+
+        AudioSourceChannelInfo part(bufferToFill.buffer,
+                                    bufferToFill.startSample + done,
+                                    bufferToFill.numSamples - done);
+
+        if (!canJoin || position >= length)
+        {
+            // nothing to join (or nowhere to park the old track), let the track play
+            // out so the transport sees the end of the stream
+            currentTrack->getNextAudioBlock(part);
+            break;
+        }
+
+        const int64 fadeLength = jmin((int64) (crossfadeSeconds.load() * currentSampleRate), length);
+        const int64 fadeStart = length - fadeLength;
+
+        if (position < fadeStart)
+        {
+            part.numSamples = (int) jmin((int64) part.numSamples, fadeStart - position);
+            currentTrack->getNextAudioBlock(part);
+        }
+        else
+        {
+            part.numSamples = (int) jmin((int64) part.numSamples, length - position);
+            currentTrack->getNextAudioBlock(part);
+            mixInNextTrack(part, position - fadeStart, fadeLength);
+        }
+
+        done += part.numSamples;
+    }
+
+    publishState();
+}
+
+bool GaplessTrackSource::switchToNextTrack()
+{
+    // the old track can't be deleted on the audio thread, so park it
+    for (auto& slot : finishedTracks)
+    {
+        if (slot == nullptr)
+        {
+            slot = std::move(currentTrack);
+            currentTrack = std::move(nextTrack);
+            currentSampleRate = nextSampleRate;
+            ++numFinishedTracks;
+            ++trackChangeCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GaplessTrackSource::mixInNextTrack(const AudioSourceChannelInfo& info, int64 fadePosition, int64 fadeLength)
+{
+    const int numChannels = jmin(info.buffer->getNumChannels(), fadeBuffer.getNumChannels());
+    int done = 0;
+
+    while (done < info.numSamples)
+    {
+        const int numThisTime = jmin(info.numSamples - done, fadeBuffer.getNumSamples());
+        AudioSourceChannelInfo fadeInfo(&fadeBuffer, 0, numThisTime);
+        nextTrack->getNextAudioBlock(fadeInfo);
+
+        const float startGain = (float) (fadePosition + done) / (float) fadeLength;
+        const float endGain = (float) (fadePosition + done + numThisTime) / (float) fadeLength;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            info.buffer->applyGainRamp(channel, info.startSample + done, numThisTime,
+                                       1.0f - startGain, 1.0f - endGain);
+            info.buffer->addFromWithRamp(channel, info.startSample + done,
+                                         fadeBuffer.getReadPointer(channel), numThisTime,
+                                         startGain, endGain);
+        }
+
+        done += numThisTime;
+    }
+}
+
+void GaplessTrackSource::setNextReadPosition(int64 newPosition)
+{
+    // made by the audio thread at the start of its next block, seen straight away
+    pendingPosition = jmax((int64) 0, newPosition);
+    publishedPosition = jmax((int64) 0, newPosition);
+}
+
+int64 GaplessTrackSource::getNextReadPosition() const
+{
+    return publishedPosition.load();
+}
+
+int64 GaplessTrackSource::getTotalLength() const
+{
+    return publishedLength.load();
+}
+
+void GaplessTrackSource::publishState()
+{
+    // a seek that hasn't been made yet is already showing
+    if (pendingPosition.load() < 0)
+    {
+        publishedPosition = currentTrack != nullptr ? currentTrack->getNextReadPosition() : 0;
+    }
+    publishedLength = currentTrack != nullptr ? currentTrack->getTotalLength() : 0;
+    publishedSampleRate = currentSampleRate;
+    publishedHasNext = nextTrack != nullptr;
+    publishedCanJoin = nextTrack != nullptr && currentTrack != nullptr && nextSampleRate == currentSampleRate;
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    GaplessTrackSource.h
+    Created: 19 Oct 2026 10:02:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Plays one track and keeps the next one ready behind it. When the current
+    track runs out the next one carries on from the very next sample, inside
+    the same block, optionally overlapping the two with a crossfade.
+
+    Both tracks are expected to play from memory (see DecodedTrackSource) so the
+    audio thread only ever copies memory here. Tracks that were finished with
+    on the audio thread are parked and deleted later by releaseFinishedTracks().
+
+    The lock is only held by the message thread to swap track pointers. The
+    position, length and rate are published in atomics for other threads to
+    read, and seeks are left for the audio thread to pick up, so nothing that
+    polls the deck can make the audio thread miss a block.
+*/
+class GaplessTrackSource : public PositionableAudioSource
+{
+public:
+    GaplessTrackSource();
+    ~GaplessTrackSource() override;
+
+    // replace the playing track, the queued one is kept
+    void setCurrentTrack(std::unique_ptr<PositionableAudioSource> newTrack, double sampleRate);
+
+    // queue the track that should follow the current one
+    void setNextTrack(std::unique_ptr<PositionableAudioSource> newTrack, double sampleRate);
+    void clearNextTrack();
+    bool hasNextTrack() const;
+
+    // the queued track can follow without a gap. Tracks with a different sample
+    // rate have to be switched by the caller once the current one has stopped
+    bool canJoinNextTrack() const;
+
+    // make the queued track current straight away (message thread)
+    bool moveToNextTrack();
+
+    // ask the audio thread to jump to the queued track at the start of its next block
+    void skipToNextTrack();
+
+    // overlap the end of the current track with the next one, 0 for a straight cut
+    void setCrossfadeSeconds(double seconds);
+
+    // goes up by one every time playback moves on to the queued track
+    int getTrackChangeCount() const { return trackChangeCount.load(); }
+
+    double getCurrentSampleRate() const;
+
+    // delete the tracks the audio thread has finished with (message thread)
+    void releaseFinishedTracks();
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override { return false; }
+
+private:
+    static constexpr int maxFinishedTracks = 4;
+
+    // audio thread, with the lock held
+    bool switchToNextTrack();
+    void mixInNextTrack(const AudioSourceChannelInfo& info, int64 fadePosition, int64 fadeLength);
+
+    // with the lock held, what getNextReadPosition and friends return
+    void publishState();
+
+    // guards the track pointers. Only held for pointer swaps
+    SpinLock lock;
+
+    std::unique_ptr<PositionableAudioSource> currentTrack;
+    std::unique_ptr<PositionableAudioSource> nextTrack;
+    std::unique_ptr<PositionableAudioSource> finishedTracks[maxFinishedTracks];
+
+    // how many of finishedTracks are waiting, so releaseFinishedTracks can check without the lock
+    std::atomic<int> numFinishedTracks{ 0 };
+    double currentSampleRate = 0;
+    double nextSampleRate = 0;
+
+    AudioBuffer<float> fadeBuffer;
+    int preparedBlockSize = 0;
+    double preparedSampleRate = 0;
+
+    // what the other threads see
+    std::atomic<int64> publishedPosition{ 0 };
+    std::atomic<int64> publishedLength{ 0 };
+    std::atomic<double> publishedSampleRate{ 0 };
+    std::atomic<bool> publishedHasNext{ false };
+    std::atomic<bool> publishedCanJoin{ false };
+
+    // a seek for the audio thread to make at the start of its next block, -1 for none
+    std::atomic<int64> pendingPosition{ -1 };
+
+    std::atomic<double> crossfadeSeconds{ 0.0 };
+    std::atomic<bool> skipRequested{ false };
+    std::atomic<int> trackChangeCount{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GaplessTrackSource)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    JogSource.cpp
+    Created: 19 Oct 2026 3:12:48pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "JogSource.h"
+
+namespace
+{
+    // how quickly a position error is made up, and how quickly the speed follows
+    const double catchUpSeconds = 0.05;
+    const double smoothingSeconds = 0.005;
+
+    // a target is only carried on at its velocity for this long, after that the hand has stopped
+    const double extrapolateSeconds = 0.05;
+}
+
+//==============================================================================
+JogSource::JogSource()
+{
+}
+
+JogSource::~JogSource()
+{
+}
+
+void JogSource::setTrack(DecodedTrack::Ptr newTrack)
+{
+    stop();
+
+    {
+        const SpinLock::ScopedLockType sl(trackLock);
+        std::swap(track, newTrack);
+        hasTrack = track != nullptr;
+    }
+
+    // newTrack now holds the old one, released here rather than on the audio thread
+}
+
+bool JogSource::start(int64 startPosition, double startVelocity)
+{
+    if (active.load())
+    {
+        return true;
+    }
+
+    // may be the audio thread, e.g. a controller's jog wheel, so no lock here
+    if (!hasTrack.load())
+    {
+        return false;
+    }
+
+    const double speed = jlimit(-maxSpeed, maxSpeed, startVelocity);
+    targetPosition = (double) startPosition;
+    targetVelocity = speed;
+    followTarget = false;
+    ++targetVersion;
+
+    // the audio thread picks these up at the start of its next block
+    reportedPosition = (double) startPosition;
+    startingPosition = (double) startPosition;
+    startingVelocity = speed;
+    pendingStart = true;
+    active = true;
+    return true;
+}
+
+void JogSource::stop()
+{
+    active = false;
+}
+
+bool JogSource::isActive() const
+{
+    return active.load();
+}
+
+void JogSource::setTarget(double newPosition, double newVelocity)
+{
+    targetPosition = newPosition;
+    targetVelocity = jlimit(-maxSpeed, maxSpeed, newVelocity);
+    followTarget = true;
+    ++targetVersion;
+}
+
+void JogSource::setVelocity(double newVelocity)
+{
+    targetVelocity = jlimit(-maxSpeed, maxSpeed, newVelocity);
+    followTarget = false;
+    ++targetVersion;
+}
+
+double JogSource::getPosition() const
+{
+    return reportedPosition.load();
+}
+
+//==============================================================================
+void JogSource::prepareToPlay(int, double sampleRate)
+{
+    outputSampleRate = sampleRate;
+}
+
+void JogSource::releaseResources()
+{
+}
+
+void JogSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    // setTrack is swapping the track right now, a block of silence rather than wait for it
+    const SpinLock::ScopedTryLockType sl(trackLock);
+
+    if (!sl.isLocked() || !active.load() || track == nullptr)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    if (pendingStart.exchange(false))
+    {
+        position = startingPosition.load();
+        velocity = startingVelocity.load();
+    }
+
+    const int version = targetVersion.load();
+    if (version != heldVersion)
+    {
+        heldVersion = version;
+        heldTarget = targetPosition.load();
+        heldVelocity = targetVelocity.load();
+        heldFollow = followTarget.load();
+        samplesSinceTarget = 0;
+    }
+
+    const double trackSampleRate = track->getSampleRate();
+    const double trackLength = (double) track->getLengthInSamples();
+    const int lastTrackChannel = track->getNumChannels() - 1;
+
+    // track samples per output sample at normal speed
+    const double rateRatio = trackSampleRate / outputSampleRate;
+    const double catchUp = 1.0 / (catchUpSeconds * trackSampleRate);
+    const double smoothing = 1.0 - std::exp(-1.0 / (smoothingSeconds * outputSampleRate));
+    const int extrapolateSamples = (int) (extrapolateSeconds * outputSampleRate);
+
+    AudioBuffer<float>& buffer = *bufferToFill.buffer;
+
+    for (int i = 0; i < bufferToFill.numSamples; ++i)
+    {
+        double desiredVelocity = heldVelocity;
+        if (heldFollow)
+        {
+            // the target keeps moving between updates from the GUI, until they stop coming
+            if (samplesSinceTarget < extrapolateSamples)
+            {
+                heldTarget += heldVelocity * rateRatio;
+                ++samplesSinceTarget;
+            }
+            else
+            {
+                desiredVelocity = 0;
+            }
+            desiredVelocity += (heldTarget - position) * catchUp;
+        }
+
+        velocity += (jlimit(-maxSpeed, maxSpeed, desiredVelocity) - velocity) * smoothing;
+        position += velocity * rateRatio;
+
+        if (position < 0 || position > trackLength)
+        {
+            position = jlimit(0.0, trackLength, position);
+            velocity = 0;
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.setSample(channel, bufferToFill.startSample + i,
+                             readInterpolated(*track, jmin(channel, lastTrackChannel), position));
+        }
+    }
+
+    // scratched somewhere the decoder hasn't reached yet
+    if (!track->isSampleDecoded((int64) position))
+    {
+        track->requestDecodeAt((int64) position);
+    }
+
+    reportedPosition = position;
+}
+
+//==============================================================================
+float JogSource::readInterpolated(const DecodedTrack& source, int channel, double pos) const
+{
+    const int64 index = (int64) std::floor(pos);
+
+    // the four points span at most two chunks, so checking the ends covers them all
+    if (!source.isSampleDecoded(index - 1) || !source.isSampleDecoded(index + 2))
+    {
+        return 0.0f;
+    }
+
+    const float t = (float) (pos - (double) index);
+    const float y0 = source.getSample(channel, index - 1);
+    const float y1 = source.getSample(channel, index);
+    const float y2 = source.getSample(channel, index + 1);
+    const float y3 = source.getSample(channel, index + 2);
+
+    const float c1 = 0.5f * (y2 - y0);
+    const float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    const float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    return ((c3 * t + c2) * t + c1) * t + y1;
+}
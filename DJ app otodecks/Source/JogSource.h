@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    JogSource.h
+    Created: 19 Oct 2026 3:12:48pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackDecoder.h"
+
+//==============================================================================
+/*
+    Scratch/jog playback. While active the playhead eases towards a target
+    position and velocity set from the GUI or a controller, and is read with
+    cubic interpolation at any speed, backwards too.
+
+    It plays from the track the TrackDecoder already holds in memory, so the
+    audio thread never touches the file, whichever way the playhead goes.
+*/
+class JogSource : public AudioSource
+{
+public:
+    JogSource();
+    ~JogSource();
+
+    // the track to scratch, or nullptr when nothing is loaded
+    void setTrack(DecodedTrack::Ptr newTrack);
+
+    // take over from the given position (in samples of the track), moving at the
+    // given speed. False if there's no track. Lock-free, like stop and the setters
+    bool start(int64 position, double velocity);
+    void stop();
+    bool isActive() const;
+
+    // where the playhead should be (in samples of the track) and how fast that
+    // point is moving, 1 being normal speed and negative playing backwards
+    void setTarget(double position, double velocity);
+
+    // spin at this speed without a position to hold on to, e.g. from a jog wheel
+    void setVelocity(double velocity);
+
+    // where the playhead is, in samples of the track
+    double getPosition() const;
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    // fastest the playhead is allowed to move, either way
+    static constexpr double maxSpeed = 8.0;
+
+private:
+    // 4-point Hermite interpolation, silent outside what has been decoded
+    float readInterpolated(const DecodedTrack& source, int channel, double position) const;
+
+    // held by the audio thread while it reads, and briefly by setTrack to swap.
+    // The audio thread only tries it
+    SpinLock trackLock;
+    DecodedTrack::Ptr track;
+    std::atomic<bool> hasTrack{ false };
+
+    std::atomic<bool> active{ false };
+    std::atomic<bool> pendingStart{ false };
+    std::atomic<double> startingPosition{ 0 };
+    std::atomic<double> startingVelocity{ 0 };
+    std::atomic<double> targetPosition{ 0 };
+    std::atomic<double> targetVelocity{ 0 };
+    std::atomic<bool> followTarget{ false };
+    std::atomic<int> targetVersion{ 0 };
+    std::atomic<double> reportedPosition{ 0 };
+
+    // audio thread only
+    double outputSampleRate = 44100;
+    double position = 0;
+    double velocity = 0;
+    double heldTarget = 0;
+    double heldVelocity = 0;
+    bool heldFollow = false;
+    int heldVersion = -1;
+    int samplesSinceTarget = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JogSource)
+};
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    LatencyMeter.h
+    Created: 19 Oct 2026 11:48:02pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    How long events took from arriving to being heard. The audio thread
+    reports each one, the message thread takes the totals now and then.
+*/
+class LatencyMeter
+{
+public:
+    struct Stats
+    {
+        int count = 0;
+        double averageMs = 0;
+        double maxMs = 0;
+    };
+
+    // audio thread: an event that came in at arrivalMs was applied now
+    void report(double arrivalMs)
+    {
+        const double latencyMs = Time::getMillisecondCounterHiRes() - arrivalMs;
+
+        ++count;
+        totalMs = totalMs.load() + latencyMs;
+
+        double previous = maxMs.load();
+        while (latencyMs > previous && !maxMs.compare_exchange_weak(previous, latencyMs))
+        {
+        }
+    }
+
+    // since the last call. Message thread
+    Stats take()
+    {
+        Stats stats;
+        stats.count = count.exchange(0);
+        const double total = totalMs.exchange(0);
+        stats.maxMs = maxMs.exchange(0);
+        stats.averageMs = stats.count > 0 ? total / stats.count : 0.0;
+        return stats;
+    }
+
+private:
+    std::atomic<int> count{ 0 };
+    std::atomic<double> totalMs{ 0 };
+    std::atomic<double> maxMs{ 0 };
+};
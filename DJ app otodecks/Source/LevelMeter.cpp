@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Created: 20 Oct 2026 2:14:40am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+namespace
+{
+    const double rmsSeconds = 0.3;
+
+    // what the meters show, and how they move
+    const float minimumDecibels = -60.0f;
+    const float maximumDecibels = 6.0f;
+    const float fallDecibelsPerSecond = 24.0f;
+    const uint32 peakHoldMs = 1500;
+    const int refreshHz = 30;
+}
+
+//==============================================================================
+void LevelMeter::prepareToPlay(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        meanSquare[channel] = 0;
+        peaks[channel] = 0;
+        rms[channel] = 0;
+        blockPeaks[channel] = 0;
+    }
+}
+
+void LevelMeter::process(const AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0 || buffer.getNumChannels() == 0)
+    {
+        return;
+    }
+
+    // how much of the running average is kept over a block this long
+    const float keep = (float) std::exp(-numSamples / (sampleRate * rmsSeconds));
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        const int sourceChannel = jmin(channel, buffer.getNumChannels() - 1);
+
+        float blockPeak, sumOfSquares;
+        measure(buffer.getReadPointer(sourceChannel, startSample), numSamples, blockPeak, sumOfSquares);
+
+        blockPeaks[channel].store(blockPeak, std::memory_order_relaxed);
+
+        // keep the highest until the GUI takes it
+        float previous = peaks[channel].load(std::memory_order_relaxed);
+        while (blockPeak > previous
+               && !peaks[channel].compare_exchange_weak(previous, blockPeak, std::memory_order_relaxed))
+        {
+        }
+
+        const float blockMeanSquare = sumOfSquares / numSamples;
+        meanSquare[channel] = blockMeanSquare + keep * (meanSquare[channel] - blockMeanSquare);
+        rms[channel].store(std::sqrt(meanSquare[channel]), std::memory_order_relaxed);
+    }
+}
+
+float LevelMeter::takePeak(int channel)
+{
+    return peaks[channel].exchange(0.0f, std::memory_order_relaxed);
+}
+
+float LevelMeter::getRMS(int channel) const
+{
+    return rms[channel].load(std::memory_order_relaxed);
+}
+
+float LevelMeter::getBlockPeak(int channel) const
+{
+    return blockPeaks[channel].load(std::memory_order_relaxed);
+}
+
+void LevelMeter::measure(const float* data, int numSamples, float& peak, float& sumOfSquares)
+{
+    float blockPeak = 0, blockSum = 0;
+    int i = 0;
+
+   #if JUCE_USE_SIMD
+    using Vector = dsp::SIMDRegister<float>;
+    const int vectorSize = (int) Vector::size();
+
+    // one at a time up to the first aligned sample
+    for (; i < numSamples && !Vector::isSIMDAligned(data + i); ++i)
+    {
+        blockPeak = jmax(blockPeak, std::abs(data[i]));
+        blockSum += data[i] * data[i];
+    }
+
+    if (numSamples - i >= vectorSize)
+    {
+        Vector peaks = Vector::expand(0.0f);
+        Vector sums = Vector::expand(0.0f);
+
+        for (; i + vectorSize <= numSamples; i += vectorSize)
+        {
+            const Vector samples = Vector::fromRawArray(data + i);
+            peaks = Vector::max(peaks, Vector::abs(samples));
+            sums += samples * samples;
+        }
+
+        for (int lane = 0; lane < vectorSize; ++lane)
+        {
+            blockPeak = jmax(blockPeak, peaks[(size_t) lane]);
+        }
+        blockSum += sums.sum();
+    }
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        blockPeak = jmax(blockPeak, std::abs(data[i]));
+        blockSum += data[i] * data[i];
+    }
+
+    peak = blockPeak;
+    sumOfSquares = blockSum;
+}
+
+//==============================================================================
+LevelMeterComponent::LevelMeterComponent(LevelMeter& meterToShow)
+    : meter(meterToShow)
+{
+    setOpaque(true);
+    startTimerHz(refreshHz);
+}
+
+LevelMeterComponent::~LevelMeterComponent()
+{
+    stopTimer();
+}
+
+void LevelMeterComponent::timerCallback()
+{
+    const float fall = Decibels::decibelsToGain(-fallDecibelsPerSecond / refreshHz);
+    const uint32 now = Time::getMillisecondCounter();
+    bool changed = false;
+
+    for (int channel = 0; channel < LevelMeter::maxChannels; ++channel)
+    {
+        const float newPeak = jmax(meter.takePeak(channel), peakLevel[channel] * fall);
+        const float newRMS = meter.getRMS(channel);
+
+        if (newPeak >= heldLevel[channel])
+        {
+            heldLevel[channel] = newPeak;
+            heldSince[channel] = now;
+        }
+        else if (now - heldSince[channel] > peakHoldMs)
+        {
+            heldLevel[channel] *= fall;
+        }
+
+        changed = changed || newPeak != peakLevel[channel] || newRMS != rmsLevel[channel];
+        peakLevel[channel] = newPeak;
+        rmsLevel[channel] = newRMS;
+    }
+
+    if (changed)
+    {
+        repaint();
+    }
+}
+
+float LevelMeterComponent::toProportion(float gain)
+{
+    const float decibels = Decibels::gainToDecibels(gain, minimumDecibels);
+    return jmap(decibels, minimumDecibels, maximumDecibels, 0.0f, 1.0f);
+}
+
+void LevelMeterComponent::paint(Graphics& g)
+{
+    g.fillAll(Colours::black);
+
+    const bool vertical = getHeight() > getWidth();
+    Rectangle<float> area = getLocalBounds().toFloat().reduced(1.0f);
+    const float barThickness = (vertical ? area.getWidth() : area.getHeight()) / LevelMeter::maxChannels;
+
+    // the part of a bar's strip from the bottom (or left) up to a proportion
+    auto lengthOf = [vertical](Rectangle<float> strip, float proportion)
+    {
+        return vertical ? strip.withTop(strip.getBottom() - strip.getHeight() * proportion)
+                        : strip.withWidth(strip.getWidth() * proportion);
+    };
+
+    const float zeroDecibels = toProportion(1.0f);
+
+    for (int channel = 0; channel < LevelMeter::maxChannels; ++channel)
+    {
+        Rectangle<float> strip = vertical ? area.removeFromLeft(barThickness).reduced(0.5f, 0)
+                                          : area.removeFromTop(barThickness).reduced(0, 0.5f);
+
+        const Colour barColour = peakLevel[channel] >= 1.0f ? Colours::red
+                               : peakLevel[channel] >= 0.7f ? Colours::yellow
+                                                            : Colours::limegreen;
+
+        g.setColour(barColour.withAlpha(0.4f));
+        g.fillRect(lengthOf(strip, toProportion(peakLevel[channel])));
+
+        g.setColour(barColour);
+        g.fillRect(lengthOf(strip, toProportion(rmsLevel[channel])));
+
+        // the held peak, red once it has clipped
+        const float held = toProportion(heldLevel[channel]);
+        if (held > 0)
+        {
+            g.setColour(heldLevel[channel] >= 1.0f ? Colours::red : Colours::white);
+            if (vertical)
+            {
+                g.fillRect(strip.getX(), strip.getBottom() - strip.getHeight() * held, strip.getWidth(), 1.5f);
+            }
+            else
+            {
+                g.fillRect(strip.getX() + strip.getWidth() * held - 1.5f, strip.getY(), 1.5f, strip.getHeight());
+            }
+        }
+
+        // a mark at 0 dBFS
+        g.setColour(Colours::grey);
+        if (vertical)
+        {
+            g.fillRect(strip.getX(), strip.getBottom() - strip.getHeight() * zeroDecibels, strip.getWidth(), 1.0f);
+        }
+        else
+        {
+            g.fillRect(strip.getX() + strip.getWidth() * zeroDecibels, strip.getY(), 1.0f, strip.getHeight());
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 20 Oct 2026 2:14:40am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Peak and RMS levels of whatever goes through process(), worked out on the
+    audio thread and handed over in atomics, so the GUI never touches the audio.
+    Peaks are kept until the GUI takes them, so no block is missed between
+    repaints. RMS is averaged over about 300 ms, like a VU meter.
+*/
+class LevelMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    void prepareToPlay(double sampleRate);
+
+    // audio thread. A mono buffer shows on both channels
+    void process(const AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // the highest peak since the last call, and the current RMS. GUI thread
+    float takePeak(int channel);
+    float getRMS(int channel) const;
+
+    // the peak of the last block, without taking it from the GUI. Any thread
+    float getBlockPeak(int channel) const;
+
+    // the biggest absolute sample and the sum of squares of a stretch of audio,
+    // with SIMD where there is any
+    static void measure(const float* data, int numSamples, float& peak, float& sumOfSquares);
+
+private:
+    double sampleRate = 44100.0;
+
+    // audio thread only
+    float meanSquare[maxChannels] = { 0, 0 };
+
+    std::atomic<float> peaks[maxChannels]{ { 0.0f }, { 0.0f } };
+    std::atomic<float> rms[maxChannels]{ { 0.0f }, { 0.0f } };
+    std::atomic<float> blockPeaks[maxChannels]{ { 0.0f }, { 0.0f } };
+};
+
+//==============================================================================
+/*
+    Bars for a LevelMeter: RMS solid, peaks lighter behind it and the highest
+    recent peak held for a moment as a line. Vertical if it's taller than it
+    is wide, horizontal otherwise.
+*/
+class LevelMeterComponent : public Component,
+                            private Timer
+{
+public:
+    LevelMeterComponent(LevelMeter& meterToShow);
+    ~LevelMeterComponent();
+
+    void paint(Graphics& g) override;
+
+private:
+    void timerCallback() override;
+
+    // 0 to 1 up the meter for a gain
+    static float toProportion(float gain);
+
+    LevelMeter& meter;
+
+    float peakLevel[LevelMeter::maxChannels] = { 0, 0 };
+    float rmsLevel[LevelMeter::maxChannels] = { 0, 0 };
+    float heldLevel[LevelMeter::maxChannels] = { 0, 0 };
+    uint32 heldSince[LevelMeter::maxChannels] = { 0, 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterComponent)
+};
@@ -0,0 +1,663 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.cpp
+    Created: 19 Oct 2026 10:37:52pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LibraryWatcher.h"
+#include "RealtimeLog.h"
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+ #include <cerrno>
+ #include <cstring>
+#endif
+
+namespace
+{
+    const int snapshotMagic = 0x4f544c53; // "OTLS"
+    const int snapshotVersion = 1;
+
+    // how often the folders are walked when there is no inotify
+    const int rescanIntervalMs = 30000;
+
+    // a big copy into the library shouldn't rewrite the snapshot for every file
+    const int snapshotSaveDelayMs = 10000;
+
+    String getStateKey(int64 size, int64 modified)
+    {
+        return String(size) + ":" + String(modified);
+    }
+}
+
+//==============================================================================
+LibraryWatcher::LibraryWatcher()
+    : Thread("Library watcher")
+{
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    stopThread(4000);
+}
+
+void LibraryWatcher::setRoots(const Array<File>& newRoots)
+{
+    {
+        const ScopedLock sl(rootsLock);
+        if (newRoots == roots)
+        {
+            return;
+        }
+    }
+
+    stopThread(4000);
+
+    {
+        const ScopedLock sl(rootsLock);
+        roots = newRoots;
+    }
+
+    if (!newRoots.isEmpty())
+    {
+        startThread();
+    }
+}
+
+Array<File> LibraryWatcher::getRoots() const
+{
+    const ScopedLock sl(rootsLock);
+    return roots;
+}
+
+Array<LibraryWatcher::Change> LibraryWatcher::takeChanges()
+{
+    Array<Change> taken;
+    const ScopedLock sl(changesLock);
+    taken.swapWith(changes);
+    numChangesTaken += taken.size();
+    return taken;
+}
+
+void LibraryWatcher::changesSaved()
+{
+    const ScopedLock sl(changesLock);
+    numChangesSaved = numChangesTaken;
+}
+
+bool LibraryWatcher::isAudioFile(const File& file)
+{
+    return file.hasFileExtension("wav;mp3;aif;aiff");
+}
+
+File LibraryWatcher::getSnapshotFile()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("LibrarySnapshot.bin");
+}
+
+//==============================================================================
+void LibraryWatcher::run()
+{
+    loadSnapshot();
+
+   #if JUCE_LINUX
+    // the watches go in before the walk, so nothing that changes during it is missed
+    if (startInotify())
+    {
+        if (rescan())
+        {
+            inotifyLoop();
+        }
+        stopInotify();
+    }
+   #endif
+
+    // no inotify, or it ran out of watches
+    while (!threadShouldExit())
+    {
+        rescan();
+        saveSnapshot();
+        wait(rescanIntervalMs);
+    }
+
+    saveSnapshot();
+}
+
+bool LibraryWatcher::rescan()
+{
+    Snapshot found;
+    found.reserve(snapshot.size());
+
+    // only the directory entries are read, never the audio itself
+    for (const File& root : getRoots())
+    {
+        for (const auto& entry : RangedDirectoryIterator(root, true, "*", File::findFiles))
+        {
+            if (threadShouldExit())
+            {
+                return false;
+            }
+            if (isAudioFile(entry.getFile()))
+            {
+                found[entry.getFile().getFullPathName()] = { entry.getFileSize(),
+                                                             entry.getModificationTime().toMilliseconds() };
+            }
+        }
+    }
+
+    // gone since last time. One with the same size and date turning up
+    // somewhere else is taken to be the same file, renamed
+    std::unordered_multimap<String, String, PathHash> removedByState;
+    for (const auto& entry : snapshot)
+    {
+        if (found.find(entry.first) == found.end() && isUnderRoot(entry.first))
+        {
+            removedByState.emplace(getStateKey(entry.second.size, entry.second.modified), entry.first);
+        }
+    }
+
+    StringArray added;
+    for (const auto& entry : found)
+    {
+        auto previous = snapshot.find(entry.first);
+        if (previous == snapshot.end())
+        {
+            auto match = removedByState.find(getStateKey(entry.second.size, entry.second.modified));
+            if (match != removedByState.end())
+            {
+                addChange(Change::renamed, File(entry.first), File(match->second));
+                removedByState.erase(match);
+            }
+            else
+            {
+                added.add(entry.first);
+            }
+        }
+        else if (!(previous->second == entry.second))
+        {
+            addChange(Change::modified, File(entry.first));
+        }
+    }
+
+    // new files go into the playlist in folder order
+    added.sortNatural();
+    for (const String& path : added)
+    {
+        addChange(Change::added, File(path));
+    }
+
+    for (const auto& entry : removedByState)
+    {
+        addChange(Change::removed, File(entry.second));
+    }
+
+    // anything under a folder that is no longer watched drops out quietly
+    if (found.size() != snapshot.size())
+    {
+        snapshotDirty = true;
+    }
+    snapshot = std::move(found);
+    return true;
+}
+
+void LibraryWatcher::updateFile(const File& file)
+{
+    if (!isAudioFile(file))
+    {
+        return;
+    }
+    if (!file.existsAsFile())
+    {
+        removeFile(file);
+        return;
+    }
+
+    const FileState state{ file.getSize(), file.getLastModificationTime().toMilliseconds() };
+    auto previous = snapshot.find(file.getFullPathName());
+
+    if (previous == snapshot.end())
+    {
+        snapshot.emplace(file.getFullPathName(), state);
+        addChange(Change::added, file);
+    }
+    else if (!(previous->second == state))
+    {
+        previous->second = state;
+        addChange(Change::modified, file);
+    }
+}
+
+void LibraryWatcher::removeFile(const File& file)
+{
+    if (snapshot.erase(file.getFullPathName()) > 0)
+    {
+        addChange(Change::removed, file);
+    }
+}
+
+void LibraryWatcher::removeTree(const File& dir)
+{
+    const String prefix = dir.getFullPathName() + File::getSeparatorString();
+
+    for (auto it = snapshot.begin(); it != snapshot.end();)
+    {
+        if (it->first.startsWith(prefix))
+        {
+            addChange(Change::removed, File(it->first));
+            it = snapshot.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void LibraryWatcher::moveTree(const File& from, const File& to)
+{
+    const String oldPrefix = from.getFullPathName() + File::getSeparatorString();
+
+    std::vector<std::pair<String, FileState>> moved;
+    for (auto it = snapshot.begin(); it != snapshot.end();)
+    {
+        if (it->first.startsWith(oldPrefix))
+        {
+            moved.push_back(*it);
+            it = snapshot.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto& entry : moved)
+    {
+        const File newFile = to.getChildFile(entry.first.substring(oldPrefix.length()));
+        snapshot[newFile.getFullPathName()] = entry.second;
+        addChange(Change::renamed, newFile, File(entry.first));
+    }
+
+   #if JUCE_LINUX
+    // the watches follow the directories, only their names need updating
+    const String newPrefix = to.getFullPathName() + File::getSeparatorString();
+    for (auto& watched : watchedDirs)
+    {
+        if (watched.second == from.getFullPathName())
+        {
+            watched.second = to.getFullPathName();
+        }
+        else if (watched.second.startsWith(oldPrefix))
+        {
+            watched.second = newPrefix + watched.second.substring(oldPrefix.length());
+        }
+    }
+   #endif
+}
+
+void LibraryWatcher::scanTree(const File& dir)
+{
+    for (const auto& entry : RangedDirectoryIterator(dir, true, "*", File::findFiles))
+    {
+        updateFile(entry.getFile());
+    }
+}
+
+bool LibraryWatcher::isUnderRoot(const String& path) const
+{
+    const ScopedLock sl(rootsLock);
+    for (const File& root : roots)
+    {
+        if (path.startsWith(root.getFullPathName() + File::getSeparatorString()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LibraryWatcher::addChange(Change::Type type, const File& file, const File& oldFile)
+{
+    snapshotDirty = true;
+
+    const ScopedLock sl(changesLock);
+    changes.add({ type, file, oldFile });
+}
+
+//==============================================================================
+void LibraryWatcher::loadSnapshot()
+{
+    snapshot.clear();
+
+    auto fileStream = std::make_unique<FileInputStream>(getSnapshotFile());
+    if (fileStream->failedToOpen())
+    {
+        return;
+    }
+
+    // strings are read a byte at a time
+    BufferedInputStream in(fileStream.release(), 65536, true);
+    if (in.readInt() != snapshotMagic || in.readInt() != snapshotVersion)
+    {
+        return;
+    }
+
+    const int numEntries = in.readInt();
+    snapshot.reserve((size_t) jmax(0, numEntries));
+
+    for (int i = 0; i < numEntries && !in.isExhausted(); ++i)
+    {
+        const String path = in.readString();
+        FileState state;
+        state.size = in.readInt64();
+        state.modified = in.readInt64();
+        snapshot.emplace(path, state);
+    }
+
+    snapshotDirty = false;
+}
+
+void LibraryWatcher::saveSnapshot()
+{
+    if (!snapshotDirty)
+    {
+        return;
+    }
+
+    // what is in the snapshot is never reported again, so it waits until the
+    // playlist has everything reported so far on disk
+    {
+        const ScopedLock sl(changesLock);
+        if (!changes.isEmpty() || numChangesSaved != numChangesTaken)
+        {
+            return;
+        }
+    }
+
+    const File snapshotFile = getSnapshotFile();
+    snapshotFile.getParentDirectory().createDirectory();
+
+    // written to the side and swapped in, so a crash can't leave half a snapshot
+    TemporaryFile temp(snapshotFile);
+    {
+        FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+        {
+            RealtimeLog::write(RealtimeLog::warning, "LibraryWatcher::saveSnapshot could not write %s",
+                               temp.getFile().getFullPathName().toRawUTF8());
+            return;
+        }
+
+        out.writeInt(snapshotMagic);
+        out.writeInt(snapshotVersion);
+        out.writeInt((int) snapshot.size());
+
+        for (const auto& entry : snapshot)
+        {
+            out.writeString(entry.first);
+            out.writeInt64(entry.second.size);
+            out.writeInt64(entry.second.modified);
+        }
+        out.flush();
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        RealtimeLog::write(RealtimeLog::warning, "LibraryWatcher::saveSnapshot could not replace %s",
+                           snapshotFile.getFullPathName().toRawUTF8());
+        return;
+    }
+
+    snapshotDirty = false;
+    lastSaveTime = Time::getMillisecondCounter();
+}
+
+void LibraryWatcher::saveSnapshotIfDue()
+{
+    if (snapshotDirty && Time::getMillisecondCounter() - lastSaveTime > (uint32) snapshotSaveDelayMs)
+    {
+        saveSnapshot();
+    }
+}
+
+//==============================================================================
+#if JUCE_LINUX
+bool LibraryWatcher::startInotify()
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+        return false;
+    }
+
+    for (const File& root : getRoots())
+    {
+        if (!watchTree(root))
+        {
+            stopInotify();
+            return false;
+        }
+    }
+    return true;
+}
+
+void LibraryWatcher::stopInotify()
+{
+    if (inotifyFd >= 0)
+    {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+    }
+    watchedDirs.clear();
+    pendingMoves.clear();
+}
+
+bool LibraryWatcher::watchTree(const File& dir)
+{
+    // inotify isn't recursive, every folder needs its own watch
+    Array<File> dirs{ dir };
+    for (const auto& entry : RangedDirectoryIterator(dir, true, "*", File::findDirectories))
+    {
+        dirs.add(entry.getFile());
+    }
+
+    const uint32 mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+    for (const File& d : dirs)
+    {
+        const int wd = inotify_add_watch(inotifyFd, d.getFullPathName().toRawUTF8(), mask);
+        if (wd < 0)
+        {
+            // usually ENOSPC, more folders than fs.inotify.max_user_watches
+            RealtimeLog::write(RealtimeLog::warning, "LibraryWatcher::watchTree could not watch %s (%s), rescanning instead",
+                               d.getFullPathName().toRawUTF8(), std::strerror(errno));
+            return false;
+        }
+        watchedDirs[wd] = d.getFullPathName();
+    }
+    return true;
+}
+
+void LibraryWatcher::inotifyLoop()
+{
+    const int bufferSize = 65536;
+    HeapBlock<char> buffer((size_t) bufferSize);
+
+    while (!threadShouldExit())
+    {
+        // woken up now and then to check for threadShouldExit
+        pollfd fd{ inotifyFd, POLLIN, 0 };
+        if (poll(&fd, 1, 500) > 0)
+        {
+            const ssize_t length = ::read(inotifyFd, buffer, (size_t) bufferSize);
+
+            for (ssize_t i = 0; i + (ssize_t) sizeof(inotify_event) <= length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + i);
+                const String name = event->len > 0 ? String::fromUTF8(event->name) : String();
+
+                if (!handleEvent(event->mask, event->cookie, event->wd, name))
+                {
+                    return;
+                }
+                i += (ssize_t) sizeof(inotify_event) + (ssize_t) event->len;
+            }
+
+            finishPendingMoves();
+        }
+
+        saveSnapshotIfDue();
+    }
+}
+
+bool LibraryWatcher::handleEvent(uint32 mask, uint32 cookie, int wd, const String& name)
+{
+    // the kernel's queue filled up and events were lost
+    if ((mask & IN_Q_OVERFLOW) != 0)
+    {
+        rescan();
+        return true;
+    }
+
+    auto dir = watchedDirs.find(wd);
+    if (dir == watchedDirs.end())
+    {
+        return true;
+    }
+    if ((mask & IN_IGNORED) != 0)
+    {
+        watchedDirs.erase(dir);
+        return true;
+    }
+    if (name.isEmpty())
+    {
+        return true;
+    }
+
+    const File file = File(dir->second).getChildFile(name);
+    const bool isDirectory = (mask & IN_ISDIR) != 0;
+
+    if ((mask & IN_MOVED_FROM) != 0)
+    {
+        pendingMoves[cookie] = { file, isDirectory };
+        return true;
+    }
+
+    if ((mask & IN_MOVED_TO) != 0)
+    {
+        auto from = pendingMoves.find(cookie);
+        if (from == pendingMoves.end())
+        {
+            // moved in from outside the library
+            if (isDirectory)
+            {
+                if (!watchTree(file))
+                {
+                    return false;
+                }
+                scanTree(file);
+            }
+            else
+            {
+                updateFile(file);
+            }
+            return true;
+        }
+
+        const File oldFile = from->second.file;
+        pendingMoves.erase(from);
+
+        if (isDirectory)
+        {
+            moveTree(oldFile, file);
+            return true;
+        }
+
+        auto previous = snapshot.find(oldFile.getFullPathName());
+        if (previous != snapshot.end() && isAudioFile(file))
+        {
+            const FileState state = previous->second;
+            snapshot.erase(previous);
+            snapshot[file.getFullPathName()] = state;
+            addChange(Change::renamed, file, oldFile);
+        }
+        else
+        {
+            removeFile(oldFile);
+            updateFile(file);
+        }
+        return true;
+    }
+
+    if ((mask & IN_CREATE) != 0)
+    {
+        // files are picked up once they have been written and closed
+        if (isDirectory)
+        {
+            if (!watchTree(file))
+            {
+                return false;
+            }
+            scanTree(file);
+        }
+        return true;
+    }
+
+    if ((mask & IN_CLOSE_WRITE) != 0)
+    {
+        updateFile(file);
+    }
+    else if ((mask & IN_DELETE) != 0)
+    {
+        if (isDirectory)
+        {
+            removeTree(file);
+        }
+        else
+        {
+            removeFile(file);
+        }
+    }
+    return true;
+}
+
+void LibraryWatcher::finishPendingMoves()
+{
+    // both halves of a rename come in the same read, so a half on its own
+    // is something moved out of the library
+    for (const auto& move : pendingMoves)
+    {
+        const File& file = move.second.file;
+        if (!move.second.isDirectory)
+        {
+            removeFile(file);
+            continue;
+        }
+
+        removeTree(file);
+
+        // its watches went with it
+        const String prefix = file.getFullPathName() + File::getSeparatorString();
+        for (auto it = watchedDirs.begin(); it != watchedDirs.end();)
+        {
+            if (it->second == file.getFullPathName() || it->second.startsWith(prefix))
+            {
+                inotify_rm_watch(inotifyFd, it->first);
+                it = watchedDirs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    pendingMoves.clear();
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.h
+    Created: 19 Oct 2026 10:37:52pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+//==============================================================================
+/*
+    Keeps an eye on the library folders and reports the audio files that are
+    added, removed, renamed or modified in them.
+
+    What was in the folders last time is kept in a snapshot on disk, so on
+    startup one walk of the directory metadata is enough to catch up, and
+    only the differences are reported. After that, changes come from inotify
+    on Linux, and from a walk every half a minute anywhere else (or when
+    there are more folders than inotify watches allowed).
+*/
+class LibraryWatcher : private Thread
+{
+public:
+    struct Change
+    {
+        enum Type { added, removed, modified, renamed };
+
+        Type type;
+        File file;
+        File oldFile; // where a renamed file used to be
+    };
+
+    // for unordered containers keyed by path
+    struct PathHash
+    {
+        size_t operator()(const String& path) const { return (size_t) path.hashCode64(); }
+    };
+
+    LibraryWatcher();
+    ~LibraryWatcher() override;
+
+    // the folders to watch, with their subfolders. Restarts the watch if they changed
+    void setRoots(const Array<File>& newRoots);
+    Array<File> getRoots() const;
+
+    // everything found since the last call, oldest first
+    Array<Change> takeChanges();
+
+    // everything taken so far has been saved by whoever took it. The snapshot
+    // isn't written before then, so a crash in between reports them again
+    void changesSaved();
+
+    // the extensions the playlist takes
+    static bool isAudioFile(const File& file);
+
+    static File getSnapshotFile();
+
+private:
+    struct FileState
+    {
+        int64 size;
+        int64 modified;
+
+        bool operator==(const FileState& other) const { return size == other.size && modified == other.modified; }
+    };
+
+    using Snapshot = std::unordered_map<String, FileState, PathHash>;
+
+    void run() override;
+
+    // walk every root and report what differs from the snapshot
+    bool rescan();
+
+    // bring one file in line with the snapshot
+    void updateFile(const File& file);
+    void removeFile(const File& file);
+    void removeTree(const File& dir);
+    void moveTree(const File& from, const File& to);
+    void scanTree(const File& dir);
+
+    bool isUnderRoot(const String& path) const;
+    void addChange(Change::Type type, const File& file, const File& oldFile = {});
+
+    void loadSnapshot();
+    void saveSnapshot();
+    void saveSnapshotIfDue();
+
+   #if JUCE_LINUX
+    struct PendingMove
+    {
+        File file;
+        bool isDirectory;
+    };
+
+    bool startInotify();
+    void stopInotify();
+    bool watchTree(const File& dir);
+
+    // returns if a new folder can't be watched, to fall back to rescanning
+    void inotifyLoop();
+    bool handleEvent(uint32 mask, uint32 cookie, int wd, const String& name);
+    void finishPendingMoves();
+
+    int inotifyFd = -1;
+    std::unordered_map<int, String> watchedDirs;
+    std::unordered_map<uint32, PendingMove> pendingMoves;
+   #endif
+
+    CriticalSection rootsLock;
+    Array<File> roots;
+
+    CriticalSection changesLock;
+    Array<Change> changes;
+    int64 numChangesTaken = 0;
+    int64 numChangesSaved = 0;
+
+    // watcher thread only
+    Snapshot snapshot;
+    bool snapshotDirty = false;
+    uint32 lastSaveTime = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryWatcher)
+};
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    LimiterPanel.cpp
+    Created: 20 Oct 2026 3:20:44am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LimiterPanel.h"
+
+//==============================================================================
+LimiterPanel::LimiterPanel(MasterLimiter& limiterToControl)
+    : limiter(limiterToControl)
+{
+    enabledToggle.setToggleState(limiter.isEnabled(), dontSendNotification);
+    enabledToggle.setColour(ToggleButton::textColourId, Colours::white);
+    enabledToggle.addListener(this);
+    addAndMakeVisible(enabledToggle);
+
+    ceilingLabel.setText("Ceiling", dontSendNotification);
+    ceilingLabel.setColour(Label::textColourId, Colours::white);
+    addAndMakeVisible(ceilingLabel);
+
+    ceilingSlider.setRange(-12.0, 0.0, 0.1);
+    ceilingSlider.setTextValueSuffix(" dBTP");
+    ceilingSlider.setValue(limiter.getCeilingDecibels(), dontSendNotification);
+    ceilingSlider.setColour(Slider::thumbColourId, Colours::white);
+    ceilingSlider.addListener(this);
+    addAndMakeVisible(ceilingSlider);
+
+    releaseLabel.setText("Release", dontSendNotification);
+    releaseLabel.setColour(Label::textColourId, Colours::white);
+    addAndMakeVisible(releaseLabel);
+
+    releaseSlider.setRange(10.0, 1000.0, 1.0);
+    releaseSlider.setSkewFactorFromMidPoint(100.0);
+    releaseSlider.setTextValueSuffix(" ms");
+    releaseSlider.setValue(limiter.getReleaseMs(), dontSendNotification);
+    releaseSlider.setColour(Slider::thumbColourId, Colours::white);
+    releaseSlider.addListener(this);
+    addAndMakeVisible(releaseSlider);
+
+    // the output is always this far behind, on or off
+    latencyLabel.setText("Latency " + String(limiter.getLatencyInSamples()) + " samples",
+                         dontSendNotification);
+    latencyLabel.setColour(Label::textColourId, Colours::lightgrey);
+    latencyLabel.setFont(Font(12.0f));
+    addAndMakeVisible(latencyLabel);
+
+    setSize(280, 120);
+}
+
+LimiterPanel::~LimiterPanel()
+{
+    enabledToggle.removeListener(this);
+    ceilingSlider.removeListener(this);
+    releaseSlider.removeListener(this);
+}
+
+void LimiterPanel::paint(Graphics& g)
+{
+    g.fillAll(Colours::slategrey);
+}
+
+void LimiterPanel::resized()
+{
+    const int rowH = getHeight() / 4;
+
+    enabledToggle.setBounds(5, 0, getWidth() - 10, rowH);
+    ceilingLabel.setBounds(5, rowH, 60, rowH);
+    ceilingSlider.setBounds(65, rowH, getWidth() - 70, rowH);
+    releaseLabel.setBounds(5, rowH * 2, 60, rowH);
+    releaseSlider.setBounds(65, rowH * 2, getWidth() - 70, rowH);
+    latencyLabel.setBounds(5, rowH * 3, getWidth() - 10, rowH);
+}
+
+void LimiterPanel::sliderValueChanged(Slider* slider)
+{
+    if (slider == &ceilingSlider)
+    {
+        limiter.setCeilingDecibels((float) ceilingSlider.getValue());
+    }
+    if (slider == &releaseSlider)
+    {
+        limiter.setReleaseMs((float) releaseSlider.getValue());
+    }
+}
+
+void LimiterPanel::buttonClicked(Button* button)
+{
+    if (button == &enabledToggle)
+    {
+        limiter.setEnabled(enabledToggle.getToggleState());
+    }
+}
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    LimiterPanel.h
+    Created: 20 Oct 2026 3:20:44am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MasterLimiter.h"
+
+//==============================================================================
+/*
+    The master limiter's settings, shown in a call-out from the top bar.
+*/
+class LimiterPanel : public Component,
+                     public Slider::Listener,
+                     public Button::Listener
+{
+public:
+    LimiterPanel(MasterLimiter& limiterToControl);
+    ~LimiterPanel();
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    /** implement Slider::Listener */
+    void sliderValueChanged(Slider* slider) override;
+
+    /** implement Button::Listener */
+    void buttonClicked(Button* button) override;
+
+private:
+    MasterLimiter& limiter;
+
+    ToggleButton enabledToggle{ "Limiter on" };
+    Label ceilingLabel;
+    Slider ceilingSlider;
+    Label releaseLabel;
+    Slider releaseSlider;
+    Label latencyLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LimiterPanel)
+};
@@ -0,0 +1,406 @@
+/*
+  ==============================================================================
+
+    LoopCueSource.cpp
+    Created: 19 Oct 2026 1:05:31pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LoopCueSource.h"
+
+//==============================================================================
+LoopCueSource::LoopCueSource(PositionableAudioSource* inputSource)
+    : input(inputSource)
+{
+}
+
+LoopCueSource::~LoopCueSource()
+{
+}
+
+void LoopCueSource::setHotCue(int index, int64 position, std::unique_ptr<AudioBuffer<float>> window)
+{
+    if (!isPositiveAndBelow(index, numHotCues))
+    {
+        return;
+    }
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+        HotCue& hotCue = hotCues[index];
+
+        // playing from the window we're about to replace, carry on from the input instead
+        if (memoryBuffer != nullptr && memoryBuffer == hotCue.window.get())
+        {
+            input->setNextReadPosition(memoryPosition);
+            memoryBuffer = nullptr;
+            playingFromMemory = false;
+        }
+
+        std::swap(hotCue.window, window);
+        hotCue.position = hotCue.window != nullptr ? position : -1;
+    }
+
+    // window now holds the old buffer, which is freed here outside the lock
+}
+
+void LoopCueSource::clearHotCue(int index)
+{
+    setHotCue(index, -1, nullptr);
+}
+
+void LoopCueSource::clearHotCues()
+{
+    for (int i = 0; i < numHotCues; ++i)
+    {
+        clearHotCue(i);
+    }
+}
+
+bool LoopCueSource::hasHotCue(int index) const
+{
+    return isPositiveAndBelow(index, numHotCues) && hotCues[index].position.load() >= 0;
+}
+
+void LoopCueSource::jumpToHotCue(int index, bool fade)
+{
+    if (hasHotCue(index))
+    {
+        pendingFade = fade;
+        pendingSeek = -1;
+        pendingCueJump = index;
+    }
+}
+
+void LoopCueSource::startLoop(int64 lengthInSamples)
+{
+    lengthInSamples = jmax(lengthInSamples, (int64) fadeLength);
+
+    // room for the loop plus the bit after it that is faded out on every wrap
+    auto newBuffer = std::make_unique<AudioBuffer<float>>(2, (int) (lengthInSamples + fadeLength));
+
+    {
+        const SpinLock::ScopedLockType sl(lock);
+
+        // record into whichever buffer isn't being played from right now
+        const int slot = (loopBuffers[0] != nullptr && memoryBuffer == loopBuffers[0].get()) ? 1 : 0;
+        std::swap(loopBuffers[slot], newBuffer);
+        loopBuffer = loopBuffers[slot].get();
+        loopRunning = false;
+        pendingLoopExit = false;
+        pendingLoopStart = true;
+    }
+}
+
+void LoopCueSource::exitLoop()
+{
+    pendingLoopStart = false;
+    pendingLoopExit = true;
+}
+
+void LoopCueSource::inputTrackChanged()
+{
+    // the windows are freed by the message thread, here they just stop being used
+    for (HotCue& hotCue : hotCues)
+    {
+        hotCue.position = -1;
+    }
+
+    pendingCueJump = -1;
+    pendingLoopStart = false;
+    pendingTrackChange = true;
+}
+
+//==============================================================================
+void LoopCueSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    fadeBuffer.setSize(2, fadeLength);
+    fadeRemaining = 0;
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void LoopCueSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void LoopCueSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    // the message thread is swapping buffers, skip this block rather than wait
+    const SpinLock::ScopedTryLockType sl(lock);
+    if (!sl.isLocked())
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    applyPendingCommands();
+
+    AudioBuffer<float>& buffer = *bufferToFill.buffer;
+    int done = 0;
+
+    while (done < bufferToFill.numSamples)
+    {
+        int numThisTime = bufferToFill.numSamples - done;
+        const int64 position = getPlayPosition();
+
+        if (loopRunning)
+        {
+            if (position == loopEnd && capturedEnd >= loopEnd)
+            {
+                // the exact end of the loop: fade what follows it out and its start in
+                beginFadeOut();
+                playFromMemory(loopBuffer, loopStart, loopStart);
+                continue;
+            }
+
+            if (position < loopEnd)
+            {
+                numThisTime = (int) jmin((int64) numThisTime, loopEnd - position);
+            }
+            else
+            {
+                stopLoop();
+            }
+        }
+
+        if (memoryBuffer != nullptr)
+        {
+            if (memoryPosition >= memoryEnd)
+            {
+                // the input was parked at memoryEnd, so it carries on seamlessly
+                memoryBuffer = nullptr;
+                playingFromMemory = false;
+                continue;
+            }
+            numThisTime = (int) jmin((int64) numThisTime, memoryEnd - memoryPosition);
+        }
+
+        readLinear(buffer, bufferToFill.startSample + done, numThisTime);
+
+        if (fadeRemaining > 0)
+        {
+            mixFadeOut(buffer, bufferToFill.startSample + done, numThisTime);
+        }
+
+        done += numThisTime;
+    }
+
+    reportedPosition = getPlayPosition();
+    loopActive = loopRunning;
+}
+
+void LoopCueSource::setNextReadPosition(int64 newPosition)
+{
+    pendingFade = fadeNextSeek.exchange(true);
+    pendingCueJump = -1;
+    pendingSeek = jmax((int64) 0, newPosition);
+}
+
+int64 LoopCueSource::getNextReadPosition() const
+{
+    // report where a pending jump is going, so the GUI doesn't see the old position
+    const int64 seek = pendingSeek.load();
+    if (seek >= 0)
+    {
+        return seek;
+    }
+
+    const int cue = pendingCueJump.load();
+    if (cue >= 0 && hotCues[cue].position.load() >= 0)
+    {
+        return hotCues[cue].position.load();
+    }
+
+    if (playingFromMemory.load())
+    {
+        return reportedPosition.load();
+    }
+
+    return input->getNextReadPosition();
+}
+
+int64 LoopCueSource::getTotalLength() const
+{
+    return input->getTotalLength();
+}
+
+//==============================================================================
+int64 LoopCueSource::getPlayPosition() const
+{
+    return memoryBuffer != nullptr ? memoryPosition : input->getNextReadPosition();
+}
+
+void LoopCueSource::applyPendingCommands()
+{
+    // nothing from the old track is played again, and it isn't faded out either
+    if (pendingTrackChange.exchange(false))
+    {
+        stopLoop();
+        memoryBuffer = nullptr;
+        playingFromMemory = false;
+        fadeRemaining = 0;
+    }
+
+    const int64 seek = pendingSeek.exchange(-1);
+    const int cue = pendingCueJump.exchange(-1);
+    const bool fade = pendingFade.load();
+
+    if (seek >= 0)
+    {
+        if (fade)
+        {
+            beginFadeOut();
+        }
+        stopLoop();
+        memoryBuffer = nullptr;
+        playingFromMemory = false;
+        input->setNextReadPosition(seek);
+    }
+    else if (isPositiveAndBelow(cue, numHotCues))
+    {
+        HotCue& hotCue = hotCues[cue];
+        const int64 position = hotCue.position.load();
+
+        if (position >= 0 && hotCue.window != nullptr)
+        {
+            if (fade)
+            {
+                beginFadeOut();
+            }
+            stopLoop();
+
+            // play the decoded window while the input buffers what comes after it
+            playFromMemory(hotCue.window.get(), position, position);
+        }
+    }
+
+    if (pendingLoopExit.exchange(false))
+    {
+        stopLoop();
+    }
+
+    if (pendingLoopStart.exchange(false) && loopBuffer != nullptr)
+    {
+        loopStart = getPlayPosition();
+        loopEnd = loopStart + loopBuffer->getNumSamples() - fadeLength;
+        capturedEnd = loopStart;
+        loopRunning = true;
+    }
+}
+
+void LoopCueSource::readLinear(AudioBuffer<float>& dest, int destStart, int numSamples)
+{
+    if (memoryBuffer == nullptr)
+    {
+        const int64 position = input->getNextReadPosition();
+        AudioSourceChannelInfo info(&dest, destStart, numSamples);
+        input->getNextAudioBlock(info);
+        captureLoop(dest, destStart, numSamples, position);
+    }
+    else
+    {
+        const int offset = (int) (memoryPosition - memoryStart);
+        for (int channel = 0; channel < dest.getNumChannels(); ++channel)
+        {
+            const int sourceChannel = jmin(channel, memoryBuffer->getNumChannels() - 1);
+            dest.copyFrom(channel, destStart, *memoryBuffer, sourceChannel, offset, numSamples);
+        }
+        captureLoop(dest, destStart, numSamples, memoryPosition);
+        memoryPosition += numSamples;
+    }
+}
+
+void LoopCueSource::captureLoop(const AudioBuffer<float>& source, int sourceStart, int numSamples, int64 position)
+{
+    if (!loopRunning || loopBuffer == nullptr)
+    {
+        return;
+    }
+
+    const int64 bufferEnd = loopStart + loopBuffer->getNumSamples();
+
+    // only audio that carries straight on from what we already have
+    if (capturedEnd >= bufferEnd || position > capturedEnd || position + numSamples <= capturedEnd)
+    {
+        return;
+    }
+
+    const int skip = (int) (capturedEnd - position);
+    const int numToCopy = (int) jmin((int64) (numSamples - skip), bufferEnd - capturedEnd);
+
+    for (int channel = 0; channel < loopBuffer->getNumChannels(); ++channel)
+    {
+        const int sourceChannel = jmin(channel, source.getNumChannels() - 1);
+        loopBuffer->copyFrom(channel, (int) (capturedEnd - loopStart),
+                             source, sourceChannel, sourceStart + skip, numToCopy);
+    }
+    capturedEnd += numToCopy;
+}
+
+void LoopCueSource::playFromMemory(const AudioBuffer<float>* buffer, int64 bufferStart, int64 position)
+{
+    memoryBuffer = buffer;
+    memoryStart = bufferStart;
+    memoryEnd = bufferStart + buffer->getNumSamples();
+    memoryPosition = position;
+    playingFromMemory = true;
+
+    // park the input where the memory runs out, so it is buffered by the time we get there
+    if (input->getNextReadPosition() != memoryEnd)
+    {
+        input->setNextReadPosition(memoryEnd);
+    }
+}
+
+void LoopCueSource::beginFadeOut()
+{
+    // render what would have come next, to be faded out over the new position
+    int filled = 0;
+    while (filled < fadeLength)
+    {
+        int numThisTime = fadeLength - filled;
+
+        if (memoryBuffer != nullptr)
+        {
+            if (memoryPosition >= memoryEnd)
+            {
+                memoryBuffer = nullptr;
+                playingFromMemory = false;
+                continue;
+            }
+            numThisTime = (int) jmin((int64) numThisTime, memoryEnd - memoryPosition);
+        }
+
+        readLinear(fadeBuffer, filled, numThisTime);
+        filled += numThisTime;
+    }
+
+    fadeRemaining = fadeLength;
+}
+
+void LoopCueSource::mixFadeOut(AudioBuffer<float>& dest, int destStart, int numSamples)
+{
+    const int numToMix = jmin(numSamples, fadeRemaining);
+    const int offset = fadeLength - fadeRemaining;
+    const float outStart = (float) fadeRemaining / (float) fadeLength;
+    const float outEnd = (float) (fadeRemaining - numToMix) / (float) fadeLength;
+
+    for (int channel = 0; channel < dest.getNumChannels(); ++channel)
+    {
+        const int fadeChannel = jmin(channel, fadeBuffer.getNumChannels() - 1);
+        dest.applyGainRamp(channel, destStart, numToMix, 1.0f - outStart, 1.0f - outEnd);
+        dest.addFromWithRamp(channel, destStart, fadeBuffer.getReadPointer(fadeChannel, offset),
+                             numToMix, outStart, outEnd);
+    }
+
+    fadeRemaining -= numToMix;
+}
+
+void LoopCueSource::stopLoop()
+{
+    // if we're inside the loop's memory it plays on to the end of it, then the input takes over
+    loopRunning = false;
+}
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    LoopCueSource.h
+    Created: 19 Oct 2026 1:05:31pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Hot cues and loops, performed by the audio thread at the exact sample.
+
+    Sits between the transport and the track source. Normally it just passes
+    the track through, but it can also play from memory:
+
+    - a loop records the samples passing through it on its first pass, so
+      every later pass is played from RAM and never waits on the decoder
+    - every hot cue keeps a few seconds of decoded audio after the cue, so a
+      jump plays from memory while the track source buffers the rest
+
+    Every jump fades the old position out over a few milliseconds while the
+    new one fades in, so there's no click.
+
+    The message thread only swaps buffers in and out under the lock, all the
+    decisions are made on the audio thread at the start of each block. The
+    audio thread only tries the lock, and skips a block rather than wait.
+*/
+class LoopCueSource : public PositionableAudioSource
+{
+public:
+    static constexpr int numHotCues = 4;
+    static constexpr int fadeLength = 256;
+
+    explicit LoopCueSource(PositionableAudioSource* inputSource);
+    ~LoopCueSource() override;
+
+    // store a hot cue and the audio decoded from it onwards (message thread)
+    void setHotCue(int index, int64 position, std::unique_ptr<AudioBuffer<float>> window);
+    void clearHotCue(int index);
+    void clearHotCues();
+    bool hasHotCue(int index) const;
+
+    // jump to a hot cue at the start of the next block. fade should be false if
+    // nothing is playing, so the stale position isn't heard when playback starts
+    void jumpToHotCue(int index, bool fade);
+
+    // loop lengthInSamples starting from the playhead at the next block
+    void startLoop(int64 lengthInSamples);
+    void exitLoop();
+    bool isLoopActive() const { return loopActive.load(); }
+
+    // the next seek made through setNextReadPosition() should (not) be faded
+    void setFadeNextSeek(bool shouldFade) { fadeNextSeek = shouldFade; }
+
+    // the input moved on to another track, forget anything that belonged to the
+    // old one. Any thread, the audio thread catches up at its next block
+    void inputTrackChanged();
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition(int64 newPosition) override;
+    int64 getNextReadPosition() const override;
+    int64 getTotalLength() const override;
+    bool isLooping() const override { return false; }
+
+private:
+    struct HotCue
+    {
+        std::atomic<int64> position{ -1 };
+        std::unique_ptr<AudioBuffer<float>> window;
+    };
+
+    // everything below runs on the audio thread with the lock held
+    int64 getPlayPosition() const;
+    void applyPendingCommands();
+    void readLinear(AudioBuffer<float>& dest, int destStart, int numSamples);
+    void captureLoop(const AudioBuffer<float>& source, int sourceStart, int numSamples, int64 position);
+    void playFromMemory(const AudioBuffer<float>* buffer, int64 bufferStart, int64 position);
+    void beginFadeOut();
+    void mixFadeOut(AudioBuffer<float>& dest, int destStart, int numSamples);
+    void stopLoop();
+
+    PositionableAudioSource* input;
+
+    // held by the message thread to swap buffers, the audio thread only tries it
+    SpinLock lock;
+
+    HotCue hotCues[numHotCues];
+
+    // two loop buffers, so a new loop can be recorded while the old one is still playing
+    std::unique_ptr<AudioBuffer<float>> loopBuffers[2];
+    AudioBuffer<float>* loopBuffer = nullptr;
+    int64 loopStart = 0;
+    int64 loopEnd = 0;
+    int64 capturedEnd = 0;
+    bool loopRunning = false;
+
+    // playing from memory rather than the input
+    const AudioBuffer<float>* memoryBuffer = nullptr;
+    int64 memoryStart = 0;
+    int64 memoryEnd = 0;
+    int64 memoryPosition = 0;
+
+    AudioBuffer<float> fadeBuffer;
+    int fadeRemaining = 0;
+
+    // requests from the message thread, picked up at the start of the next block
+    std::atomic<int64> pendingSeek{ -1 };
+    std::atomic<int> pendingCueJump{ -1 };
+    std::atomic<bool> pendingFade{ true };
+    std::atomic<bool> fadeNextSeek{ true };
+    std::atomic<bool> pendingLoopStart{ false };
+    std::atomic<bool> pendingLoopExit{ false };
+    std::atomic<bool> pendingTrackChange{ false };
+
+    std::atomic<bool> loopActive{ false };
+    std::atomic<bool> playingFromMemory{ false };
+    std::atomic<int64> reportedPosition{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopCueSource)
+};
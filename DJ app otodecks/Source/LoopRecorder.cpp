@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    LoopRecorder.cpp
+    Created: 20 Oct 2026 10:48:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "LoopRecorder.h"
+
+//==============================================================================
+void LoopRecorder::setLength(double seconds)
+{
+    lengthSeconds = jlimit(0.0, maxSeconds, seconds);
+    allocate();
+}
+
+double LoopRecorder::getLength() const
+{
+    return lengthSeconds.load();
+}
+
+void LoopRecorder::prepareToPlay(double newSampleRate)
+{
+    if (newSampleRate != sampleRate.load())
+    {
+        sampleRate = newSampleRate;
+        allocate();
+    }
+}
+
+void LoopRecorder::allocate()
+{
+    const double seconds = lengthSeconds.load();
+    const int size = seconds > 0 ? (int) (seconds * sampleRate.load()) : 0;
+
+    // what was in it belongs to the old size or rate
+    const ScopedLock sl(ringLock);
+    ring.setSize(numChannels, size);
+    ring.clear();
+    samplesWritten = 0;
+}
+
+//==============================================================================
+void LoopRecorder::push(const AudioBuffer<float>& source, int startSample, int numSamples)
+{
+    const ScopedTryLock sl(ringLock);
+    const int size = ring.getNumSamples();
+    if (!sl.isLocked() || size == 0 || source.getNumChannels() == 0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    // a longer block than the ring just keeps its end
+    int64 written = samplesWritten.load();
+    if (numSamples > size)
+    {
+        startSample += numSamples - size;
+        written += numSamples - size;
+        numSamples = size;
+    }
+
+    const int start = (int) (written % size);
+    const int first = jmin(numSamples, size - start);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const int sourceChannel = jmin(channel, source.getNumChannels() - 1);
+        ring.copyFrom(channel, start, source, sourceChannel, startSample, first);
+        if (first < numSamples)
+        {
+            ring.copyFrom(channel, 0, source, sourceChannel, startSample + first, numSamples - first);
+        }
+    }
+
+    samplesWritten = written + numSamples;
+}
+
+bool LoopRecorder::capture(double seconds, AudioBuffer<float>& destination) const
+{
+    // the input misses the ring for a block at most while this is copied
+    const ScopedLock sl(ringLock);
+    const int size = ring.getNumSamples();
+    const int64 written = samplesWritten.load();
+    const int64 wanted = (int64) (jlimit(0.0, lengthSeconds.load(), seconds) * sampleRate.load());
+    const int count = (int) jmin(wanted, written, (int64) size);
+    if (count <= 0)
+    {
+        return false;
+    }
+
+    destination.setSize(numChannels, count);
+    const int start = (int) ((written - count) % size);
+    const int first = jmin(count, size - start);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        destination.copyFrom(channel, 0, ring, channel, start, first);
+        if (first < count)
+        {
+            destination.copyFrom(channel, first, ring, channel, 0, count - first);
+        }
+    }
+    return true;
+}
+
+bool LoopRecorder::captureToFile(double seconds, const File& file) const
+{
+    AudioBuffer<float> loop;
+    if (!capture(seconds, loop))
+    {
+        return false;
+    }
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    WavAudioFormat wav;
+    auto* stream = new FileOutputStream(file);
+    std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(stream, sampleRate.load(), (unsigned int) numChannels,
+                                                                  24, {}, 0));
+    if (writer == nullptr)
+    {
+        delete stream;
+        return false;
+    }
+    return writer->writeFromAudioSampleBuffer(loop, 0, loop.getNumSamples());
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    LoopRecorder.h
+    Created: 20 Oct 2026 10:48:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Keeps the last few seconds of a deck's line input, so a phrase that has
+    just been played can be saved as a loop.
+
+    Off until it is given a length. The audio thread copies each block into a
+    ring, skipping it if the message thread is resizing the ring or copying
+    the latest stretch out of it at that moment. It never waits.
+*/
+class LoopRecorder
+{
+public:
+    static constexpr double maxSeconds = 60.0;
+
+    // message thread. 0 turns it off and frees the memory
+    void setLength(double seconds);
+    double getLength() const;
+    bool isEnabled() const { return getLength() > 0; }
+
+    void prepareToPlay(double sampleRate);
+
+    // audio thread: the next stretch of input, never blocks
+    void push(const AudioBuffer<float>& source, int startSample, int numSamples);
+
+    // message thread: the last seconds heard, fewer if it hasn't heard that
+    // many yet. False if it is off or has heard nothing
+    bool capture(double seconds, AudioBuffer<float>& destination) const;
+
+    // the same, written to a WAV file
+    bool captureToFile(double seconds, const File& file) const;
+
+    double getSampleRate() const { return sampleRate.load(); }
+
+private:
+    void allocate();
+
+    // held by the message thread while the ring is resized or read, the audio thread only tries it
+    mutable CriticalSection ringLock;
+    AudioBuffer<float> ring;
+    std::atomic<int64> samplesWritten{ 0 };
+
+    std::atomic<double> lengthSeconds{ 0 };
+    std::atomic<double> sampleRate{ 44100.0 };
+
+    static constexpr int numChannels = 2;
+};
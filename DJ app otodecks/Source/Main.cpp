@@ -10,6 +10,7 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "RealtimeLog.h"
 
 //==============================================================================
 class OtoDecksApplication  : public JUCEApplication
@@ -25,6 +26,7 @@ public:
     void initialise (const String& commandLine) override
     {
         //application's initialisation code
+        logWriter.reset (new RealtimeLog::Writer (std::cout));
 
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
@@ -34,6 +36,7 @@ public:
         //application's shutdown code here
 
         mainWindow = nullptr; // (deletes window)
+        logWriter = nullptr;
     }
 
     //==============================================================================
@@ -89,6 +92,7 @@ public:
     };
 
 private:
+    std::unique_ptr<RealtimeLog::Writer> logWriter;
     std::unique_ptr<MainWindow> mainWindow;
 };
 
@@ -7,6 +7,10 @@
 */
 
 #include "MainComponent.h"
+#include "LimiterPanel.h"
+#include "MidiPanel.h"
+#include "SamplerPanel.h"
+#include "RealtimeLog.h"
 
 //==============================================================================
 MainComponent::MainComponent()
@@ -14,29 +18,118 @@ MainComponent::MainComponent()
     //size of the component 
     setSize (800, 600);
 
+    // --virtual-audio swaps the sound card for a simulated one, for glitch testing
+    VirtualAudioDevice::Settings virtualSettings;
+    if (VirtualAudioDeviceType::parseCommandLine(JUCEApplicationBase::getCommandLineParameterArray(), virtualSettings))
+    {
+        deviceManager.addAudioDeviceType(std::make_unique<VirtualAudioDeviceType>(virtualSettings));
+        setAudioChannels (2, 4, VirtualAudioDeviceType::createDeviceSetup(virtualSettings).get());
+        quitWhenVirtualDeviceStops = virtualSettings.numBlocks > 0;
+    }
     // Some platforms require permissions to open input channels so request that here
-    if (RuntimePermissions::isRequired (RuntimePermissions::recordAudio)
+    else if (RuntimePermissions::isRequired (RuntimePermissions::recordAudio)
         && ! RuntimePermissions::isGranted (RuntimePermissions::recordAudio))
     {
         RuntimePermissions::request (RuntimePermissions::recordAudio,
-                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 2); });
+                                     [&] (bool granted) { if (granted)  setAudioChannels (2, 4); });
     }  
     else
     {
-        //the number of input and output channels that we want to open
-        setAudioChannels (0, 2);
+        //the number of input and output channels that we want to open,
+        //outputs 3/4 are the headphone cue on devices that have them.
+        //the inputs are opened now for LINE, so switching to it never restarts the device mid-set
+        setAudioChannels (2, 4);
     }  
 
     addAndMakeVisible(deckGUI1); 
     addAndMakeVisible(deckGUI2);
+    deckGUI1.setPartnerDeck(&player2);
+    deckGUI2.setPartnerDeck(&player1);
     
     addAndMakeVisible(playlistComponent);
 
+    addAndMakeVisible(recordButton);
+    addAndMakeVisible(flacToggle);
+    addAndMakeVisible(recordStatusLabel);
+    addAndMakeVisible(ecoKeyLockToggle);
+    addAndMakeVisible(compactTracksToggle);
+    addAndMakeVisible(masterMeterDisplay);
+    addAndMakeVisible(limiterButton);
+
+    recordButton.addListener(this);
+    ecoKeyLockToggle.addListener(this);
+    compactTracksToggle.addListener(this);
+    limiterButton.addListener(this);
+    ecoKeyLockToggle.setColour(ToggleButton::textColourId, Colours::white);
+    compactTracksToggle.setColour(ToggleButton::textColourId, Colours::white);
+    recordButton.setColour(TextButton::buttonColourId, Colours::darkred);
+    recordButton.setColour(TextButton::textColourOffId, Colours::white);
+    flacToggle.setColour(ToggleButton::textColourId, Colours::white);
+    recordStatusLabel.setColour(Label::textColourId, Colours::white);
+    recordStatusLabel.setFont(Font(12.0f));
+
+    // the crossfader, and MIDI learn and the sample pads beside it
+    crossfaderSlider.setRange(0.0, 1.0);
+    crossfaderSlider.setValue(0.5, dontSendNotification);
+    crossfaderSlider.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.setColour(Slider::thumbColourId, Colours::white);
+    crossfaderSlider.addListener(this);
+    addAndMakeVisible(crossfaderSlider);
+    midiButton.addListener(this);
+    addAndMakeVisible(midiButton);
+    padsButton.addListener(this);
+    addAndMakeVisible(padsButton);
+
+    // headphone cue: PFL either side of the crossfader, the cue/master blend after it
+    for (TextButton* cueButton : { &cueButton1, &cueButton2 })
+    {
+        cueButton->setClickingTogglesState(true);
+        cueButton->setColour(TextButton::buttonOnColourId, Colours::darkorange);
+        cueButton->addListener(this);
+        addAndMakeVisible(cueButton);
+    }
+    cueMixSlider.setRange(0.0, 1.0);
+    cueMixSlider.setValue(deckMixer.getCueMix(), dontSendNotification);
+    cueMixSlider.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+    cueMixSlider.setColour(Slider::thumbColourId, Colours::orange);
+    cueMixSlider.addListener(this);
+    addAndMakeVisible(cueMixSlider);
+    splitCueToggle.setColour(ToggleButton::textColourId, Colours::white);
+    splitCueToggle.addListener(this);
+    addAndMakeVisible(splitCueToggle);
+
+    // every controller that is plugged in, straight to the MIDI thread
+    for (const MidiDeviceInfo& device : MidiInput::getAvailableDevices())
+    {
+        deviceManager.setMidiInputDeviceEnabled(device.identifier, true);
+    }
+    deviceManager.addMidiInputDeviceCallback({}, &midiController);
+
+    oscServer.start(OscServer::defaultPort);
+
     formatManager.registerBasicFormats();
+    sampler.loadPads();
+
+    startTimer(250);
 }
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+    recordButton.removeListener(this);
+    ecoKeyLockToggle.removeListener(this);
+    compactTracksToggle.removeListener(this);
+    limiterButton.removeListener(this);
+    midiButton.removeListener(this);
+    padsButton.removeListener(this);
+    cueButton1.removeListener(this);
+    cueButton2.removeListener(this);
+    splitCueToggle.removeListener(this);
+    crossfaderSlider.removeListener(this);
+    cueMixSlider.removeListener(this);
+    deviceManager.removeMidiInputDeviceCallback({}, &midiController);
+    oscServer.stop();
+
     //shuts down the audio device and clears the audio source.
     shutdownAudio();
 }
@@ -47,15 +140,31 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
     player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
     
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);
-
+    // the limiter first, the cue is delayed to match it
+    limiter.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    deckMixer.setCueDelay(limiter.getLatencyInSamples());
+    deckMixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    sampler.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    masterMeter.prepareToPlay(sampleRate);
+    RealtimeLog::write(RealtimeLog::info, "Master limiter latency %d samples (%.2f ms)",
+                       limiter.getLatencyInSamples(), limiter.getLatencyInSamples() * 1000.0 / sampleRate);
+    recorder.prepareToPlay(samplesPerBlockExpected, sampleRate);
  }
 void MainComponent::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    applyControllerEvents();
+    applyRemoteCommands();
+
+    deckMixer.getNextAudioBlock(bufferToFill);
+    sampler.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+    limiter.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+    masterMeter.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    // the recorder only copies into its FIFO, the file is written on its own thread
+    recorder.pushBlock(bufferToFill);
+
+    // last, a split cue takes over the master pair
+    deckMixer.routeCue(bufferToFill);
 }
 
 void MainComponent::releaseResources()
@@ -65,7 +174,8 @@ void MainComponent::releaseResources()
 
     player1.releaseResources();
     player2.releaseResources();
-    mixerSource.releaseResources();
+    deckMixer.releaseResources();
+    recorder.releaseResources();
 }
 
 //==============================================================================
@@ -76,18 +186,361 @@ void MainComponent::paint (Graphics& g)
 
     g.setColour(Colours::white);
     g.setFont(14.0f);
-    g.drawText("DJ Mixer Application", getLocalBounds().removeFromTop(20), Justification::centred, true);
+    // between the master controls and the recorder status
+    g.drawText("DJ Mixer Application", 510, 0, getWidth() - 265 - 510, topBarHeight, Justification::centred, true);
     
 }
 
 void MainComponent::resized()
 {
+    // Record controls along the top
+    recordButton.setBounds(5, 3, 50, topBarHeight - 6);
+    flacToggle.setBounds(60, 3, 60, topBarHeight - 6);
+    ecoKeyLockToggle.setBounds(125, 3, 110, topBarHeight - 6);
+    masterMeterDisplay.setBounds(240, 8, 90, topBarHeight - 16);
+    limiterButton.setBounds(335, 3, 70, topBarHeight - 6);
+    compactTracksToggle.setBounds(410, 3, 95, topBarHeight - 6);
+    recordStatusLabel.setBounds(getWidth() - 265, 0, 260, topBarHeight);
+
     // Adjust the proportions - where 2/3 of the height to the decks and 1/3 to the playlist
-    int deckHeight = getHeight() * 2 / 3;
-    int playlistHeight = getHeight() - deckHeight;
+    int deckHeight = (getHeight() - topBarHeight - crossfaderHeight) * 2 / 3;
+    int playlistHeight = getHeight() - topBarHeight - crossfaderHeight - deckHeight;
+
+    deckGUI1.setBounds(0, topBarHeight, getWidth() / 2, deckHeight);
+    deckGUI2.setBounds(getWidth() / 2, topBarHeight, getWidth() / 2, deckHeight);
+
+    // crossfader in the middle under the decks, MIDI learn and pads at the left
+    int crossfaderY = topBarHeight + deckHeight;
+    midiButton.setBounds(5, crossfaderY + 2, 50, crossfaderHeight - 4);
+    padsButton.setBounds(60, crossfaderY + 2, 50, crossfaderHeight - 4);
+    crossfaderSlider.setBounds(getWidth() / 3, crossfaderY, getWidth() / 3, crossfaderHeight);
+    cueButton1.setBounds(getWidth() / 3 - 45, crossfaderY + 2, 40, crossfaderHeight - 4);
+    cueButton2.setBounds(getWidth() * 2 / 3 + 5, crossfaderY + 2, 40, crossfaderHeight - 4);
+    cueMixSlider.setBounds(getWidth() * 2 / 3 + 50, crossfaderY, getWidth() / 3 - 120, crossfaderHeight);
+    splitCueToggle.setBounds(getWidth() - 65, crossfaderY + 2, 60, crossfaderHeight - 4);
+
+    playlistComponent.setBounds(0, crossfaderY + crossfaderHeight, getWidth(), playlistHeight);
+}
+
+void MainComponent::buttonClicked(Button* button)
+{
+    if (button == &recordButton)
+    {
+        if (recorder.isRecording())
+        {
+            recorder.stopRecording();
+            RealtimeLog::write(RealtimeLog::info, "Recording saved to %s",
+                               recorder.getRecordingFile().getFullPathName().toRawUTF8());
+        }
+        else
+        {
+            recorder.startRecording(getNewRecordingFile());
+        }
+        timerCallback();
+    }
+
+    if (button == &ecoKeyLockToggle)
+    {
+        // shorter frames and a narrower search, for when several decks are key locked
+        auto quality = ecoKeyLockToggle.getToggleState() ? TimeStretchSource::Quality::eco
+                                                          : TimeStretchSource::Quality::high;
+        player1.setKeyLockQuality(quality);
+        player2.setKeyLockQuality(quality);
+    }
+
+    if (button == &compactTracksToggle)
+    {
+        // tracks loaded from now on, the ones in memory stay as they are
+        decoder.setCompactStorage(compactTracksToggle.getToggleState());
+    }
+
+    if (button == &cueButton1)
+    {
+        player1.setCueEnabled(cueButton1.getToggleState());
+    }
+
+    if (button == &cueButton2)
+    {
+        player2.setCueEnabled(cueButton2.getToggleState());
+    }
+
+    if (button == &splitCueToggle)
+    {
+        deckMixer.setSplitCue(splitCueToggle.getToggleState());
+    }
+
+    if (button == &limiterButton)
+    {
+        CallOutBox::launchAsynchronously(std::make_unique<LimiterPanel>(limiter),
+                                         limiterButton.getScreenBounds(), nullptr);
+    }
+
+    if (button == &midiButton || button == &padsButton)
+    {
+        double blockMs = 0;
+        if (auto* device = deviceManager.getCurrentAudioDevice())
+        {
+            blockMs = device->getCurrentBufferSizeSamples() * 1000.0 / device->getCurrentSampleRate();
+        }
+
+        if (button == &midiButton)
+        {
+            CallOutBox::launchAsynchronously(std::make_unique<MidiPanel>(midiController, blockMs),
+                                             midiButton.getScreenBounds(), nullptr);
+        }
+        else
+        {
+            CallOutBox::launchAsynchronously(std::make_unique<SamplerPanel>(sampler, blockMs),
+                                             padsButton.getScreenBounds(), nullptr);
+        }
+    }
+}
+
+void MainComponent::sliderValueChanged(Slider* slider)
+{
+    if (slider == &crossfaderSlider)
+    {
+        setCrossfader((float) crossfaderSlider.getValue());
+    }
+
+    if (slider == &cueMixSlider)
+    {
+        deckMixer.setCueMix((float) cueMixSlider.getValue());
+    }
+}
+
+void MainComponent::setCrossfader(float position)
+{
+    position = jlimit(0.0f, 1.0f, position);
+    crossfaderPosition = position;
+    player1.setCrossfaderGain(jmin(1.0f, 2.0f * (1.0f - position)));
+    player2.setCrossfaderGain(jmin(1.0f, 2.0f * position));
+}
+
+void MainComponent::applyControllerEvents()
+{
+    MidiController::Event event;
+    while (midiController.popEvent(event))
+    {
+        if (event.target == MidiController::crossfader)
+        {
+            setCrossfader(event.value);
+            midiController.reportApplied(event);
+            continue;
+        }
+
+        const int deck = event.target / MidiController::numDeckTargets;
+        DJAudioPlayer& player = deck == 0 ? player1 : player2;
+        const bool pressed = event.value > 0;
+
+        switch (event.target % MidiController::numDeckTargets)
+        {
+            case MidiController::play:
+                if (pressed)
+                {
+                    player.isPlaying() ? player.stop() : player.start();
+                }
+                break;
+            case MidiController::cue1:
+            case MidiController::cue2:
+            case MidiController::cue3:
+            case MidiController::cue4:
+            {
+                const int cue = event.target % MidiController::numDeckTargets - MidiController::cue1;
+                if (pressed && player.hasHotCue(cue))
+                {
+                    player.jumpToHotCue(cue);
+                }
+                break;
+            }
+            case MidiController::jog:
+                if (!controllerJogging[deck])
+                {
+                    player.startJog();
+                    controllerJogging[deck] = true;
+                }
+                player.setJogVelocity((player.isPlaying() ? player.getSpeed() : 0.0)
+                                      + event.value * jogSpeedPerTick);
+                lastJogMs[deck] = event.arrivalMs;
+                break;
+            case MidiController::volume:
+                player.setGain(event.value);
+                break;
+            case MidiController::speed:
+                player.setSpeed(jmap((double) event.value, 1.0 - controllerPitchRange, 1.0 + controllerPitchRange));
+                break;
+            default:
+                break;
+        }
+        midiController.reportApplied(event);
+    }
+
+    // the wheel has stopped, carry on from where it got to
+    const double now = Time::getMillisecondCounterHiRes();
+    for (int deck = 0; deck < MidiController::numDecks; ++deck)
+    {
+        if (controllerJogging[deck] && now - lastJogMs[deck] > jogReleaseMs)
+        {
+            (deck == 0 ? player1 : player2).stopJog();
+            controllerJogging[deck] = false;
+        }
+    }
+}
+
+void MainComponent::applyRemoteCommands()
+{
+    OscServer::Command command;
+    while (oscServer.popCommand(command))
+    {
+        DJAudioPlayer& player = command.deck == 0 ? player1 : player2;
+        switch (command.type)
+        {
+            case OscServer::CommandType::play:
+                player.start();
+                break;
+            case OscServer::CommandType::stop:
+                player.stop();
+                break;
+            case OscServer::CommandType::cue:
+                if (player.hasHotCue((int) command.value))
+                {
+                    player.jumpToHotCue((int) command.value);
+                }
+                break;
+            case OscServer::CommandType::gain:
+                player.setGain(command.value);
+                break;
+            case OscServer::CommandType::speed:
+                player.setSpeed(command.value);
+                break;
+            case OscServer::CommandType::position:
+                player.setPositionRelative(command.value);
+                break;
+            case OscServer::CommandType::crossfader:
+                setCrossfader(command.value);
+                break;
+        }
+    }
+}
+
+void MainComponent::timerCallback()
+{
+    // how hard the limiter is working
+    const float reduction = limiter.takeGainReductionDecibels();
+    limiterButton.setButtonText(reduction < -0.1f ? "LIMIT " + String(reduction, 1) : "LIMIT");
+
+    // the controller may have moved it
+    if (!crossfaderSlider.isMouseButtonDown())
+    {
+        crossfaderSlider.setValue(crossfaderPosition.load(), dontSendNotification);
+    }
+
+    // splitting is only for devices without their own headphone outputs
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        // a deck switched to LINE on a device that started without its inputs
+        if ((player1.isLineInput() || player2.isLineInput()) && device->getActiveInputChannels().isZero()
+            && !lineInputsRequested)
+        {
+            lineInputsRequested = true;
+            openLineInputs();
+        }
+
+        splitCueToggle.setEnabled(!DeckMixer::hasCueOutputs(device->getActiveOutputChannels().countNumberOfSetBits()));
+
+        // a scripted run on the virtual device is over, closing it writes the report
+        if (quitWhenVirtualDeviceStops && !device->isPlaying())
+        {
+            quitWhenVirtualDeviceStops = false;
+            JUCEApplication::getInstance()->systemRequestedQuit();
+        }
+    }
+
+    if (!recorder.isRecording())
+    {
+        recordButton.setButtonText("REC");
+        recordStatusLabel.setText({}, dontSendNotification);
+        return;
+    }
+
+    MasterRecorder::Stats stats = recorder.getStats();
+    int seconds = static_cast<int>(stats.secondsRecorded);
+    String timeStr = String(seconds / 3600) + ":" + String((seconds / 60) % 60).paddedLeft('0', 2)
+                   + ":" + String(seconds % 60).paddedLeft('0', 2);
+
+    // FIFO use and high-water mark as a percentage, so a struggling disk shows up early
+    int used = stats.fifoSize > 0 ? stats.fifoUsed * 100 / stats.fifoSize : 0;
+    int peak = stats.fifoSize > 0 ? stats.fifoHighWaterMark * 100 / stats.fifoSize : 0;
+
+    recordButton.setButtonText("STOP");
+    recordStatusLabel.setText("REC " + timeStr
+                              + "  buffer " + String(used) + "% (max " + String(peak) + "%)"
+                              + "  dropped " + String(stats.droppedBlocks),
+                              dontSendNotification);
+}
+
+void MainComponent::openLineInputs()
+{
+    if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio)
+        && !RuntimePermissions::isGranted(RuntimePermissions::recordAudio))
+    {
+        Component::SafePointer<MainComponent> safeThis(this);
+        RuntimePermissions::request(RuntimePermissions::recordAudio,
+                                    [safeThis] (bool granted)
+                                    {
+                                        if (granted && safeThis != nullptr)
+                                        {
+                                            safeThis->openLineInputs();
+                                        }
+                                    });
+        return;
+    }
+
+    // reopening the device drops both decks for a moment, so ask before doing it mid-set
+    if (player1.isPlaying() || player2.isPlaying() || recorder.isRecording())
+    {
+        Component::SafePointer<MainComponent> safeThis(this);
+        AlertWindow::showOkCancelBox(AlertWindow::QuestionIcon, "Open the line inputs",
+                                     "The audio device has to restart to open its inputs, "
+                                     "which drops the output for a moment.",
+                                     "Restart now", "Not now", this,
+                                     ModalCallbackFunction::create([safeThis] (int result)
+                                     {
+                                         if (result != 0 && safeThis != nullptr)
+                                         {
+                                             safeThis->reopenWithLineInputs();
+                                         }
+                                     }));
+        return;
+    }
+
+    reopenWithLineInputs();
+}
+
+void MainComponent::reopenWithLineInputs()
+{
+    // the first pair of the device the user picked, the outputs left as they are
+    AudioDeviceManager::AudioDeviceSetup setup;
+    deviceManager.getAudioDeviceSetup(setup);
+    setup.useDefaultInputChannels = false;
+    setup.inputChannels.clear();
+    setup.inputChannels.setRange(0, 2, true);
+
+    const String error = deviceManager.setAudioDeviceSetup(setup, true);
+    if (error.isNotEmpty())
+    {
+        RealtimeLog::write(RealtimeLog::warning, "MainComponent::openLineInputs couldn't open the inputs: %s",
+                           error.toRawUTF8());
+    }
+}
+
+File MainComponent::getNewRecordingFile() const
+{
+    String name = "OtoDecks " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S")
+                + (flacToggle.getToggleState() ? ".flac" : ".wav");
 
-    deckGUI1.setBounds(0, 0, getWidth() / 2, deckHeight);
-    deckGUI2.setBounds(getWidth() / 2, 0, getWidth() / 2, deckHeight);
-    playlistComponent.setBounds(0, deckHeight, getWidth(), playlistHeight);
+    return File::getSpecialLocation(File::userMusicDirectory)
+        .getChildFile("OtoDecks Recordings")
+        .getChildFile(name);
 }
 
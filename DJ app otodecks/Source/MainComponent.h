@@ -12,13 +12,23 @@
 #include "DJAudioPlayer.h"
 #include "DeckGUI.h"
 #include "PlaylistComponent.h"
+#include "MasterRecorder.h"
+#include "MasterLimiter.h"
+#include "MidiController.h"
+#include "OscServer.h"
+#include "SamplerBank.h"
+#include "DeckMixer.h"
+#include "VirtualAudioDevice.h"
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent   : public AudioAppComponent
+class MainComponent   : public AudioAppComponent,
+                        public Button::Listener,
+                        public Slider::Listener,
+                        public Timer
 {
 public:
     //==============================================================================
@@ -34,22 +44,105 @@ public:
     void paint (Graphics& g) override;
     void resized() override;
 
+    /** implement Button::Listener */
+    void buttonClicked (Button* button) override;
+
+    /** implement Slider::Listener, for the crossfader and cue mix */
+    void sliderValueChanged (Slider* slider) override;
+
+    /** implement Timer, keeps the recorder and limiter status up to date */
+    void timerCallback() override;
+
 private:
+    // where a new recording of the set goes
+    File getNewRecordingFile() const;
+
+    // the first two inputs of the current device, for the decks' LINE mode
+    void openLineInputs();
+    void reopenWithLineInputs();
+
+    // controller events that arrived since the last block (audio thread)
+    void applyControllerEvents();
+
+    // and deck commands from OSC
+    void applyRemoteCommands();
+
+    // 0 is all deck 1, 1 all deck 2, both full in the middle. Any thread
+    void setCrossfader(float position);
+
+    // height of the strip with the title and record controls
+    static constexpr int topBarHeight = 30;
+
+    // and of the one with the crossfader, between the decks and the playlist
+    static constexpr int crossfaderHeight = 26;
+
+    // controller speed faders cover +-8% like a turntable's pitch fader
+    static constexpr double controllerPitchRange = 0.08;
+
+    // how much each jog wheel tick adds to the speed, and how long after the
+    // last one the wheel counts as let go
+    static constexpr double jogSpeedPerTick = 0.1;
+    static constexpr double jogReleaseMs = 100.0;
+
     //==============================================================================
     // Your private member variables go here...
      
     AudioFormatManager formatManager;
     AudioThumbnailCache thumbCache{100}; 
 
-    DJAudioPlayer player1{formatManager};
-    DeckGUI deckGUI1{&player1, formatManager, thumbCache}; 
+    // every track is opened and decoded once, here, for the decks, waveforms and playlist
+    TrackDecoder decoder{formatManager};
+
+    DJAudioPlayer player1{decoder};
+    DeckGUI deckGUI1{&player1, decoder}; 
+
+    DJAudioPlayer player2{decoder};
+    DeckGUI deckGUI2{&player2, decoder}; 
+
+    // the master and, in the same pass, the headphone cue
+    DeckMixer deckMixer{ &player1, &player2 };
+    TextButton cueButton1{"PFL"};
+    TextButton cueButton2{"PFL"};
+    Slider cueMixSlider;
+    ToggleButton splitCueToggle{"Split"};
+
+    // keeps the mix from clipping, before it is metered and recorded
+    MasterLimiter limiter;
+    TextButton limiterButton{"LIMIT"};
+
+    // one-shots played over the mix, ahead of the limiter
+    SamplerBank sampler{decoder};
+    TextButton padsButton{"PADS"};
 
-    DJAudioPlayer player2{formatManager};
-    DeckGUI deckGUI2{&player2, formatManager, thumbCache}; 
+    LevelMeter masterMeter;
+    LevelMeterComponent masterMeterDisplay{masterMeter};
 
-    MixerAudioSource mixerSource; 
+    MasterRecorder recorder;
+    TextButton recordButton{"REC"};
+    ToggleButton flacToggle{"FLAC"};
+    ToggleButton ecoKeyLockToggle{"Eco key lock"};
+    ToggleButton compactTracksToggle{"16-bit RAM"};
+    Label recordStatusLabel;
+
+    MidiController midiController;
+    TextButton midiButton{"MIDI"};
+    Slider crossfaderSlider;
+    std::atomic<float> crossfaderPosition{0.5f};
+
+    // a controller's jog wheel, let go of once it stops sending (audio thread)
+    bool controllerJogging[MidiController::numDecks] = {};
+    double lastJogMs[MidiController::numDecks] = {};
     
-    PlaylistComponent playlistComponent{ &player1, &player2, &deckGUI1, &deckGUI2, formatManager, thumbCache };
+    PlaylistComponent playlistComponent{ &player1, &player2, &deckGUI1, &deckGUI2, decoder, thumbCache };
+
+    // automation from other apps on this machine, after the playlist it can drive
+    OscServer oscServer{ player1, player2, deckGUI1, deckGUI2, playlistComponent, masterMeter };
+
+    // started with --virtual-audio --blocks N, the app quits after them
+    bool quitWhenVirtualDeviceStops = false;
+
+    // asked once, the user can change them in the device settings after that
+    bool lineInputsRequested = false;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
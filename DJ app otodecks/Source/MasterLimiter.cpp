@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    MasterLimiter.cpp
+    Created: 20 Oct 2026 2:51:06am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "MasterLimiter.h"
+#include <cstring>
+
+namespace
+{
+    // long enough to ramp down without audible distortion, short enough not to be heard as delay
+    const double lookaheadSeconds = 0.0015;
+}
+
+//==============================================================================
+MasterLimiter::MasterLimiter()
+{
+    // the points 1/4, 2/4 and 3/4 of the way between two samples, Hann windowed
+    for (int phase = 0; phase < oversampling - 1; ++phase)
+    {
+        const double fraction = (phase + 1) / (double) oversampling;
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const double x = tap - detectorDelay + fraction;
+            const double sinc = std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+            const double window = 0.5 * (1.0 + std::cos(MathConstants<double>::pi * x / detectorDelay));
+            phaseCoefficients[phase][tap] = (float) (sinc * window);
+        }
+    }
+}
+
+void MasterLimiter::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    lookahead = jmax(tapsPerPhase, roundToInt(lookaheadSeconds * sampleRate));
+    latency = lookahead + detectorDelay;
+    chunkSize = jmax(64, samplesPerBlockExpected);
+
+    lines.setSize(maxChannels, latency + chunkSize);
+    lines.clear();
+    peaks.allocate((size_t) chunkSize, true);
+    phaseOutput.allocate((size_t) chunkSize, true);
+    gains.allocate((size_t) chunkSize, true);
+
+    minimumCapacity = lookahead + 2;
+    minimumValues.allocate((size_t) minimumCapacity, true);
+    minimumPositions.allocate((size_t) minimumCapacity, true);
+    minimumHead = 0;
+    minimumCount = 0;
+
+    averageHistory.allocate((size_t) lookahead, false);
+    for (int i = 0; i < lookahead; ++i)
+    {
+        averageHistory[i] = 1.0f;
+    }
+    averagePosition = 0;
+    averageSum = lookahead;
+
+    position = 0;
+    previousPeak = 0;
+    envelope = 1.0f;
+}
+
+void MasterLimiter::process(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    jassert(chunkSize > 0);
+
+    // blocks can be bigger than promised, they're done in pieces rather than allocating
+    for (int done = 0; done < numSamples; done += chunkSize)
+    {
+        processChunk(buffer, startSample + done, jmin(chunkSize, numSamples - done));
+    }
+}
+
+//==============================================================================
+void MasterLimiter::processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numChannels = jmin(maxChannels, buffer.getNumChannels());
+
+    // the highest true peak of all channels, detectorDelay samples behind the input
+    FloatVectorOperations::clear(peaks, numSamples);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* line = lines.getWritePointer(channel);
+        const float* input = line + latency;
+        FloatVectorOperations::copy(line + latency, buffer.getReadPointer(channel, startSample), numSamples);
+
+        FloatVectorOperations::abs(phaseOutput, input - detectorDelay, numSamples);
+        FloatVectorOperations::max(peaks, peaks, phaseOutput, numSamples);
+
+        // one pass over the whole chunk per tap, which vectorises however small the block
+        for (int phase = 0; phase < oversampling - 1; ++phase)
+        {
+            FloatVectorOperations::clear(phaseOutput, numSamples);
+            for (int tap = 0; tap < tapsPerPhase; ++tap)
+            {
+                FloatVectorOperations::addWithMultiply(phaseOutput, input - tap, phaseCoefficients[phase][tap],
+                                                       numSamples);
+            }
+            FloatVectorOperations::abs(phaseOutput, phaseOutput, numSamples);
+            FloatVectorOperations::max(peaks, peaks, phaseOutput, numSamples);
+        }
+    }
+
+    const float ceiling = enabled.load() ? Decibels::decibelsToGain(ceilingDecibels.load()) : 1.0e6f;
+    const float release = (float) std::exp(-1.0 / (releaseMs.load() * 0.001 * sampleRate));
+    float lowest = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // a sample is in the stretch before it and the one after, so it has to
+        // be quiet enough for both
+        const float peak = jmax(peaks[i], previousPeak);
+        previousPeak = peaks[i];
+        const float required = peak > ceiling ? ceiling / peak : 1.0f;
+
+        // lowest required gain over the next lookahead samples
+        while (minimumCount > 0
+               && minimumValues[(minimumHead + minimumCount - 1) % minimumCapacity] >= required)
+        {
+            --minimumCount;
+        }
+        const int back = (minimumHead + minimumCount) % minimumCapacity;
+        minimumValues[back] = required;
+        minimumPositions[back] = position;
+        ++minimumCount;
+
+        if (minimumPositions[minimumHead] <= position - (lookahead + 1))
+        {
+            minimumHead = (minimumHead + 1) % minimumCapacity;
+            --minimumCount;
+        }
+        ++position;
+
+        // averaging it over the lookahead ramps the gain down so it gets there
+        // just as the peak comes out of the delay
+        const float windowMinimum = minimumValues[minimumHead];
+        averageSum += windowMinimum - averageHistory[averagePosition];
+        averageHistory[averagePosition] = windowMinimum;
+        averagePosition = (averagePosition + 1) % lookahead;
+        const float target = (float) (averageSum / lookahead);
+
+        envelope = target < envelope ? target : target + release * (envelope - target);
+        gains[i] = envelope;
+        lowest = jmin(lowest, envelope);
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* line = lines.getWritePointer(channel);
+        FloatVectorOperations::multiply(buffer.getWritePointer(channel, startSample), line, gains, numSamples);
+        std::memmove(line, line + numSamples, sizeof(float) * (size_t) latency);
+    }
+
+    float previous = lowestGain.load(std::memory_order_relaxed);
+    while (lowest < previous && !lowestGain.compare_exchange_weak(previous, lowest, std::memory_order_relaxed))
+    {
+    }
+}
+
+//==============================================================================
+void MasterLimiter::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+}
+
+bool MasterLimiter::isEnabled() const
+{
+    return enabled.load();
+}
+
+void MasterLimiter::setCeilingDecibels(float decibels)
+{
+    ceilingDecibels = jlimit(-12.0f, 0.0f, decibels);
+}
+
+float MasterLimiter::getCeilingDecibels() const
+{
+    return ceilingDecibels.load();
+}
+
+void MasterLimiter::setReleaseMs(float milliseconds)
+{
+    releaseMs = jlimit(10.0f, 1000.0f, milliseconds);
+}
+
+float MasterLimiter::getReleaseMs() const
+{
+    return releaseMs.load();
+}
+
+int MasterLimiter::getLatencyInSamples() const
+{
+    return latency;
+}
+
+float MasterLimiter::takeGainReductionDecibels()
+{
+    return Decibels::gainToDecibels(lowestGain.exchange(1.0f, std::memory_order_relaxed));
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    MasterLimiter.h
+    Created: 20 Oct 2026 2:51:06am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A brickwall limiter for the master bus. Peaks are found at 4x the sample
+    rate, so the ones that only appear between samples after conversion are
+    caught too, and the audio is delayed so the gain can come down smoothly
+    before a peak arrives instead of clipping it. The delay is the same
+    whether it's enabled or not, so switching it doesn't jump.
+
+    Everything is allocated in prepareToPlay. Settings can be changed from
+    any thread.
+*/
+class MasterLimiter
+{
+public:
+    MasterLimiter();
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // audio thread. Limits the first two channels together
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const;
+
+    // the highest the output may reach, in dBTP
+    void setCeilingDecibels(float decibels);
+    float getCeilingDecibels() const;
+
+    // how long the gain takes to come back up after a peak
+    void setReleaseMs(float milliseconds);
+    float getReleaseMs() const;
+
+    // how far the output is behind the input. Fixed once prepared
+    int getLatencyInSamples() const;
+
+    // the most the gain came down since the last call, in dB (0 or less). GUI thread
+    float takeGainReductionDecibels();
+
+    static constexpr int maxChannels = 2;
+
+private:
+    void processChunk(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // 4x oversampled peaks from a short windowed sinc per in-between point
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int detectorDelay = tapsPerPhase / 2;
+
+    float phaseCoefficients[oversampling - 1][tapsPerPhase];
+
+    double sampleRate = 44100.0;
+    int lookahead = 0;
+    int latency = 0;
+    int chunkSize = 0;
+
+    // per channel, the last latency samples of input followed by the current chunk
+    AudioBuffer<float> lines;
+    HeapBlock<float> peaks, phaseOutput, gains;
+
+    // the lowest gain needed over the lookahead, as a queue of candidates
+    HeapBlock<float> minimumValues;
+    HeapBlock<int64> minimumPositions;
+    int minimumHead = 0, minimumCount = 0, minimumCapacity = 0;
+
+    // then averaged over the lookahead, so it ramps down in time
+    HeapBlock<float> averageHistory;
+    int averagePosition = 0;
+    double averageSum = 0;
+
+    int64 position = 0;
+    float previousPeak = 0;
+    float envelope = 1.0f;
+
+    std::atomic<bool> enabled{ true };
+    std::atomic<float> ceilingDecibels{ -1.0f };
+    std::atomic<float> releaseMs{ 100.0f };
+    std::atomic<float> lowestGain{ 1.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterLimiter)
+};
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.cpp
+    Created: 19 Oct 2026 11:20:47am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "MasterRecorder.h"
+#include "RealtimeLog.h"
+
+//==============================================================================
+MasterRecorder::MasterRecorder()
+{
+    writerThread.startThread();
+}
+
+MasterRecorder::~MasterRecorder()
+{
+    stopRecording();
+}
+
+void MasterRecorder::prepareToPlay(int samplesPerBlockExpected, double newSampleRate)
+{
+    // a device restarted at another rate can't go on in the same file
+    if (recording.load() && newSampleRate != sampleRate)
+    {
+        stopRecording();
+    }
+
+    // a new recording picks this up
+    sampleRate = newSampleRate;
+}
+
+void MasterRecorder::releaseResources()
+{
+    // the device may only be restarting, so the file stays open. It is
+    // finished by stopRecording or when the recorder goes away
+}
+
+bool MasterRecorder::startRecording(const File& file)
+{
+    stopRecording();
+
+    std::unique_ptr<AudioFormat> format;
+    if (file.hasFileExtension(".flac"))
+    {
+        format = std::make_unique<FlacAudioFormat>();
+    }
+    else
+    {
+        format = std::make_unique<WavAudioFormat>();
+    }
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+    if (stream == nullptr)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "MasterRecorder::startRecording could not create %s",
+                           file.getFullPathName().toRawUTF8());
+        return false;
+    }
+
+    // WAV switches to RF64 by itself once it passes 4GB, so long sets are fine
+    AudioFormatWriter* writer = format->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels, 24, {}, 0);
+    if (writer == nullptr)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "MasterRecorder::startRecording format can't write at %.0f Hz", sampleRate);
+        return false;
+    }
+    stream.release(); // the writer owns the stream now
+
+    fifoSize = (int) (sampleRate * fifoSeconds);
+    samplesPushed = 0;
+    samplesWritten = 0;
+    fifoHighWaterMark = 0;
+    droppedBlocks = 0;
+    droppedSamples = 0;
+
+    threadedWriter = std::make_unique<AudioFormatWriter::ThreadedWriter>(writer, writerThread, fifoSize);
+    threadedWriter->setDataReceiver(this);
+    recordingFile = file;
+
+    {
+        const ScopedLock sl(writerLock);
+        activeWriter = threadedWriter.get();
+    }
+    recording = true;
+    return true;
+}
+
+void MasterRecorder::stopRecording()
+{
+    recording = false;
+
+    {
+        const ScopedLock sl(writerLock);
+        activeWriter = nullptr;
+    }
+
+    // deleting the writer flushes whatever is left in the FIFO and closes the file
+    threadedWriter = nullptr;
+}
+
+void MasterRecorder::pushBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    if (!recording.load())
+    {
+        return;
+    }
+
+    const ScopedTryLock sl(writerLock);
+    AudioFormatWriter::ThreadedWriter* writer = activeWriter.load();
+
+    if (!sl.isLocked() || writer == nullptr || bufferToFill.buffer->getNumChannels() == 0)
+    {
+        return;
+    }
+
+    const float* channels[numChannels];
+    for (int i = 0; i < numChannels; ++i)
+    {
+        // a mono device gets its one channel written to both sides
+        const int sourceChannel = jmin(i, bufferToFill.buffer->getNumChannels() - 1);
+        channels[i] = bufferToFill.buffer->getReadPointer(sourceChannel, bufferToFill.startSample);
+    }
+
+    if (writer->write(channels, bufferToFill.numSamples))
+    {
+        const int64 pushed = samplesPushed += bufferToFill.numSamples;
+        const int used = (int) (pushed - samplesWritten.load());
+
+        int highWaterMark = fifoHighWaterMark.load();
+        while (used > highWaterMark && !fifoHighWaterMark.compare_exchange_weak(highWaterMark, used))
+        {
+        }
+    }
+    else
+    {
+        // the disk fell behind and the FIFO is full
+        ++droppedBlocks;
+        droppedSamples += bufferToFill.numSamples;
+    }
+}
+
+MasterRecorder::Stats MasterRecorder::getStats() const
+{
+    Stats stats;
+    stats.secondsRecorded = sampleRate > 0 ? samplesWritten.load() / sampleRate : 0;
+    stats.fifoSize = fifoSize;
+    stats.fifoUsed = (int) jmax((int64) 0, samplesPushed.load() - samplesWritten.load());
+    stats.fifoHighWaterMark = fifoHighWaterMark.load();
+    stats.droppedBlocks = droppedBlocks.load();
+    stats.droppedSamples = droppedSamples.load();
+    return stats;
+}
+
+//==============================================================================
+void MasterRecorder::reset(int, double, int64)
+{
+}
+
+void MasterRecorder::addBlock(int64, const AudioBuffer<float>&, int, int numSamples)
+{
+    // called on writerThread once a chunk has gone to the file
+    samplesWritten += numSamples;
+}
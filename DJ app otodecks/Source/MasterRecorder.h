@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    MasterRecorder.h
+    Created: 19 Oct 2026 11:20:47am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/*
+    Records the master output to a WAV or FLAC file.
+
+    The audio thread hands each block to an AudioFormatWriter::ThreadedWriter,
+    whose lock-free FIFO is drained and encoded on writerThread. The FIFO has a
+    fixed size, so memory stays bounded however long the set runs; if the disk
+    falls behind, blocks are dropped and counted rather than waited for.
+*/
+class MasterRecorder : private AudioFormatWriter::ThreadedWriter::IncomingDataReceiver
+{
+public:
+    MasterRecorder();
+    ~MasterRecorder() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void releaseResources();
+
+    // start a new recording, FLAC if the file ends in .flac, otherwise WAV
+    bool startRecording(const File& file);
+    void stopRecording();
+    bool isRecording() const { return recording.load(); }
+    File getRecordingFile() const { return recordingFile; }
+
+    // copy a block of the master output into the FIFO (audio thread, never blocks)
+    void pushBlock(const AudioSourceChannelInfo& bufferToFill);
+
+    struct Stats
+    {
+        double secondsRecorded = 0;
+        int fifoSize = 0;          // samples per channel
+        int fifoUsed = 0;
+        int fifoHighWaterMark = 0; // most the FIFO has held since recording started
+        int droppedBlocks = 0;
+        int64 droppedSamples = 0;
+    };
+    Stats getStats() const;
+
+private:
+    /** implement IncomingDataReceiver, the threaded writer reports what it has written */
+    void reset(int numChannels, double sampleRate, int64 totalSamplesInSource) override;
+    void addBlock(int64 sampleNumberInSource, const AudioBuffer<float>& newData,
+                  int startOffsetInBuffer, int numSamples) override;
+
+    // seconds of audio the FIFO can hold before blocks get dropped
+    static constexpr double fifoSeconds = 4.0;
+    static constexpr int numChannels = 2;
+
+    TimeSliceThread writerThread{ "Master recorder" };
+    std::unique_ptr<AudioFormatWriter::ThreadedWriter> threadedWriter;
+
+    // held by the message thread while the writer is swapped, the audio thread only tries it
+    CriticalSection writerLock;
+    std::atomic<AudioFormatWriter::ThreadedWriter*> activeWriter{ nullptr };
+
+    std::atomic<bool> recording{ false };
+    File recordingFile;
+    double sampleRate = 44100.0;
+    int fifoSize = 0;
+
+    std::atomic<int64> samplesPushed{ 0 };
+    std::atomic<int64> samplesWritten{ 0 };
+    std::atomic<int> fifoHighWaterMark{ 0 };
+    std::atomic<int> droppedBlocks{ 0 };
+    std::atomic<int64> droppedSamples{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MasterRecorder)
+};
@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    MidiController.cpp
+    Created: 20 Oct 2026 5:06:41am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "MidiController.h"
+#include "RealtimeLog.h"
+
+//==============================================================================
+MidiController::MidiController()
+{
+    for (auto& mapping : mappings)
+    {
+        mapping = 0;
+    }
+    loadMappings();
+
+    // not every platform can make one
+    virtualInput = MidiInput::createNewDevice("OtoDecks Control", this);
+    if (virtualInput != nullptr)
+    {
+        virtualInput->start();
+    }
+}
+
+MidiController::~MidiController()
+{
+    if (virtualInput != nullptr)
+    {
+        virtualInput->stop();
+    }
+    cancelPendingUpdate();
+}
+
+String MidiController::getTargetName(int target)
+{
+    if (target == crossfader)
+    {
+        return "Crossfader";
+    }
+
+    static const char* const names[] = { "Play", "Cue 1", "Cue 2", "Cue 3", "Cue 4", "Jog", "Volume", "Speed" };
+    return "Deck " + String(target / numDeckTargets + 1) + " " + names[target % numDeckTargets];
+}
+
+//==============================================================================
+void MidiController::handleIncomingMidiMessage(MidiInput*, const MidiMessage& message)
+{
+    const double arrivalMs = Time::getMillisecondCounterHiRes();
+
+    const int key = getKey(message);
+    if (key < 0)
+    {
+        return;
+    }
+
+    const int learning = learningTarget.load();
+    if (learning >= 0 && (message.isController() || message.isNoteOn()))
+    {
+        // one control per target
+        for (auto& mapping : mappings)
+        {
+            if (mapping.load() == learning + 1)
+            {
+                mapping = 0;
+            }
+        }
+        mappings[key] = (int16) (learning + 1);
+        learningTarget = -1;
+        triggerAsyncUpdate();
+        return;
+    }
+
+    const int target = mappings[key].load() - 1;
+    if (target < 0)
+    {
+        return;
+    }
+
+    Event event;
+    event.target = target;
+    event.arrivalMs = arrivalMs;
+
+    if (message.isController() && target != crossfader && target % numDeckTargets == jog)
+    {
+        // relative, 1-63 forwards and 65-127 backwards
+        const int value = message.getControllerValue();
+        event.value = (float) (value < 64 ? value : value - 128);
+    }
+    else if (message.isController())
+    {
+        event.value = message.getControllerValue() / 127.0f;
+    }
+    else
+    {
+        event.value = message.isNoteOn() ? 1.0f : 0.0f;
+    }
+
+    const SpinLock::ScopedLockType sl(pushLock);
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "MidiController queue is full, %s was dropped",
+                           getTargetName(target).toRawUTF8());
+        return;
+    }
+    queue[size1 > 0 ? start1 : start2] = event;
+    fifo.finishedWrite(1);
+}
+
+int MidiController::getKey(const MidiMessage& message)
+{
+    const int channel = message.getChannel() - 1;
+    if (message.isController())
+    {
+        return (channel * 2 + 1) * 128 + message.getControllerNumber();
+    }
+    if (message.isNoteOnOrOff())
+    {
+        return channel * 2 * 128 + message.getNoteNumber();
+    }
+    return -1;
+}
+
+String MidiController::getKeyDescription(int key)
+{
+    const int channel = key / 256 + 1;
+    const bool isController = (key / 128) % 2 == 1;
+    return (isController ? "CC " : "Note ") + String(key % 128) + " ch " + String(channel);
+}
+
+//==============================================================================
+void MidiController::learn(int target)
+{
+    learningTarget = target;
+    sendChangeMessage();
+}
+
+void MidiController::cancelLearn()
+{
+    learningTarget = -1;
+    sendChangeMessage();
+}
+
+void MidiController::clearMapping(int target)
+{
+    for (auto& mapping : mappings)
+    {
+        if (mapping.load() == target + 1)
+        {
+            mapping = 0;
+        }
+    }
+    saveMappings();
+    sendChangeMessage();
+}
+
+String MidiController::getMappingDescription(int target) const
+{
+    for (int key = 0; key < numKeys; ++key)
+    {
+        if (mappings[key].load() == target + 1)
+        {
+            return getKeyDescription(key);
+        }
+    }
+    return {};
+}
+
+void MidiController::handleAsyncUpdate()
+{
+    // something was learned
+    saveMappings();
+    sendChangeMessage();
+}
+
+//==============================================================================
+bool MidiController::popEvent(Event& event)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        return false;
+    }
+    event = queue[size1 > 0 ? start1 : start2];
+    fifo.finishedRead(1);
+    return true;
+}
+
+//==============================================================================
+File MidiController::getMappingsFile()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("MidiMappings.xml");
+}
+
+void MidiController::loadMappings()
+{
+    std::unique_ptr<XmlElement> xml = XmlDocument::parse(getMappingsFile());
+    if (xml == nullptr)
+    {
+        return;
+    }
+
+    for (auto* mapping : xml->getChildWithTagNameIterator("MAPPING"))
+    {
+        const int key = mapping->getIntAttribute("key", -1);
+        const int target = mapping->getIntAttribute("target", -1);
+        if (key >= 0 && key < numKeys && target >= 0 && target < numTargets)
+        {
+            mappings[key] = (int16) (target + 1);
+        }
+    }
+}
+
+void MidiController::saveMappings() const
+{
+    XmlElement xml("MIDIMAPPINGS");
+    for (int key = 0; key < numKeys; ++key)
+    {
+        const int target = mappings[key].load() - 1;
+        if (target >= 0)
+        {
+            auto* mapping = xml.createNewChildElement("MAPPING");
+            mapping->setAttribute("key", key);
+            mapping->setAttribute("target", target);
+        }
+    }
+
+    getMappingsFile().getParentDirectory().createDirectory();
+    xml.writeTo(getMappingsFile());
+}
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    MidiController.h
+    Created: 20 Oct 2026 5:06:41am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LatencyMeter.h"
+
+//==============================================================================
+/*
+    Hardware controller input. Incoming notes and CCs are looked up in a
+    learnable table on the MIDI thread, stamped with when they arrived and
+    queued for the audio thread, which applies them at the start of its next
+    block without going through the message thread.
+
+    The audio thread reports back when it applied each one, so the time from
+    the controller to the audio engine can be shown against the block length.
+
+    A virtual input called "OtoDecks Control" is created where the platform
+    allows it, so anything that can send MIDI can drive the decks.
+*/
+class MidiController : public MidiInputCallback,
+                       public ChangeBroadcaster,
+                       private AsyncUpdater
+{
+public:
+    // what a control can be mapped to, for each deck
+    enum DeckTarget
+    {
+        play,
+        cue1,
+        cue2,
+        cue3,
+        cue4,
+        jog,
+        volume,
+        speed,
+        numDeckTargets
+    };
+
+    static constexpr int numDecks = 2;
+    static constexpr int crossfader = numDecks * numDeckTargets;
+    static constexpr int numTargets = crossfader + 1;
+
+    static int getTarget(int deck, DeckTarget target) { return deck * numDeckTargets + target; }
+    static String getTargetName(int target);
+
+    struct Event
+    {
+        int target = 0;
+
+        // 0 to 1 for faders and knobs, 1 or 0 for buttons pressed or released,
+        // and for the jog the number of ticks, negative for backwards
+        float value = 0;
+
+        // Time::getMillisecondCounterHiRes when it arrived
+        double arrivalMs = 0;
+    };
+
+    using LatencyStats = LatencyMeter::Stats;
+
+    MidiController();
+    ~MidiController() override;
+
+    /** implement MidiInputCallback, from the MIDI thread */
+    void handleIncomingMidiMessage(MidiInput* source, const MidiMessage& message) override;
+
+    // the next note or CC that comes in is mapped to target. Message thread
+    void learn(int target);
+    void cancelLearn();
+    int getLearningTarget() const { return learningTarget.load(); }
+    void clearMapping(int target);
+
+    // e.g. "CC 7 ch 1", or empty if it isn't mapped
+    String getMappingDescription(int target) const;
+
+    // audio thread: the next event waiting, if there is one
+    bool popEvent(Event& event);
+
+    // audio thread: event was applied now
+    void reportApplied(const Event& event) { latency.report(event.arrivalMs); }
+
+    // since the last call. Message thread
+    LatencyStats takeLatencyStats() { return latency.take(); }
+
+    static File getMappingsFile();
+
+    static constexpr int queueSize = 256;
+
+private:
+    // notes and CCs on each channel, the index into the mapping table
+    static constexpr int numKeys = 16 * 2 * 128;
+    static int getKey(const MidiMessage& message);
+    static String getKeyDescription(int key);
+
+    void handleAsyncUpdate() override;
+    void loadMappings();
+    void saveMappings() const;
+
+    // target + 1 for every key, 0 where it isn't mapped
+    std::atomic<int16> mappings[numKeys];
+    std::atomic<int> learningTarget{ -1 };
+
+    AbstractFifo fifo{ queueSize };
+    Event queue[queueSize];
+    SpinLock pushLock;
+
+    LatencyMeter latency;
+
+    std::unique_ptr<MidiInput> virtualInput;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiController)
+};
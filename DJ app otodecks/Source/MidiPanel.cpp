@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    MidiPanel.cpp
+    Created: 20 Oct 2026 5:41:03am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "MidiPanel.h"
+
+//==============================================================================
+MidiPanel::MidiPanel(MidiController& controllerToEdit, double blockLengthMs)
+    : controller(controllerToEdit),
+      blockMs(blockLengthMs)
+{
+    for (int target = 0; target < MidiController::numTargets; ++target)
+    {
+        auto* name = nameLabels.add(new Label({}, MidiController::getTargetName(target)));
+        name->setColour(Label::textColourId, Colours::white);
+        addAndMakeVisible(name);
+
+        auto* mapping = mappingLabels.add(new Label());
+        mapping->setColour(Label::textColourId, Colours::lightgrey);
+        addAndMakeVisible(mapping);
+
+        auto* learn = learnButtons.add(new TextButton("Learn"));
+        learn->addListener(this);
+        addAndMakeVisible(learn);
+
+        auto* clear = clearButtons.add(new TextButton("Clear"));
+        clear->addListener(this);
+        addAndMakeVisible(clear);
+    }
+
+    latencyLabel.setText("Controller to audio: no messages yet (block " + String(blockMs, 1) + " ms)",
+                         dontSendNotification);
+    latencyLabel.setColour(Label::textColourId, Colours::white);
+    latencyLabel.setFont(Font(12.0f));
+    addAndMakeVisible(latencyLabel);
+
+    controller.addChangeListener(this);
+    updateMappings();
+    timerCallback();
+    startTimer(500);
+
+    setSize(360, (MidiController::numTargets + 1) * rowHeight + 10);
+}
+
+MidiPanel::~MidiPanel()
+{
+    stopTimer();
+    controller.removeChangeListener(this);
+
+    // nothing is left waiting for a control once the panel has gone
+    controller.cancelLearn();
+}
+
+void MidiPanel::paint(Graphics& g)
+{
+    g.fillAll(Colours::slategrey);
+}
+
+void MidiPanel::resized()
+{
+    for (int target = 0; target < MidiController::numTargets; ++target)
+    {
+        const int y = 5 + target * rowHeight;
+        nameLabels[target]->setBounds(5, y, 130, rowHeight);
+        mappingLabels[target]->setBounds(135, y, 100, rowHeight);
+        learnButtons[target]->setBounds(240, y + 1, 55, rowHeight - 2);
+        clearButtons[target]->setBounds(300, y + 1, 55, rowHeight - 2);
+    }
+    latencyLabel.setBounds(5, 5 + MidiController::numTargets * rowHeight, getWidth() - 10, rowHeight);
+}
+
+void MidiPanel::buttonClicked(Button* button)
+{
+    for (int target = 0; target < MidiController::numTargets; ++target)
+    {
+        if (button == learnButtons[target])
+        {
+            if (controller.getLearningTarget() == target)
+            {
+                controller.cancelLearn();
+            }
+            else
+            {
+                controller.learn(target);
+            }
+        }
+        if (button == clearButtons[target])
+        {
+            controller.clearMapping(target);
+        }
+    }
+}
+
+void MidiPanel::changeListenerCallback(ChangeBroadcaster*)
+{
+    updateMappings();
+}
+
+void MidiPanel::updateMappings()
+{
+    const int learning = controller.getLearningTarget();
+    for (int target = 0; target < MidiController::numTargets; ++target)
+    {
+        const bool isLearning = target == learning;
+        mappingLabels[target]->setText(isLearning ? "move a control..." : controller.getMappingDescription(target),
+                                       dontSendNotification);
+        learnButtons[target]->setColour(TextButton::buttonColourId,
+                                        isLearning ? Colours::darkorange : Colours::darkslategrey);
+    }
+}
+
+void MidiPanel::timerCallback()
+{
+    const MidiController::LatencyStats stats = controller.takeLatencyStats();
+    if (stats.count == 0)
+    {
+        // keep showing the last lot
+        return;
+    }
+
+    latencyLabel.setText("Controller to audio: avg " + String(stats.averageMs, 2) + " ms, max "
+                         + String(stats.maxMs, 2) + " ms (block " + String(blockMs, 1) + " ms)",
+                         dontSendNotification);
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    MidiPanel.h
+    Created: 20 Oct 2026 5:41:03am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MidiController.h"
+
+//==============================================================================
+/*
+    MIDI learn for every control, shown in a call-out from the MIDI button,
+    and how long controller messages take to reach the audio engine.
+*/
+class MidiPanel : public Component,
+                  public Button::Listener,
+                  private ChangeListener,
+                  private Timer
+{
+public:
+    // blockMs is the audio device's block length, to compare the latency with
+    MidiPanel(MidiController& controllerToEdit, double blockMs);
+    ~MidiPanel();
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    /** implement Button::Listener */
+    void buttonClicked(Button* button) override;
+
+private:
+    /** implement ChangeListener, something was learned */
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    /** implement Timer, refreshes the latency */
+    void timerCallback() override;
+
+    void updateMappings();
+
+    MidiController& controller;
+    double blockMs;
+
+    OwnedArray<Label> nameLabels;
+    OwnedArray<Label> mappingLabels;
+    OwnedArray<TextButton> learnButtons;
+    OwnedArray<TextButton> clearButtons;
+    Label latencyLabel;
+
+    static constexpr int rowHeight = 22;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiPanel)
+};
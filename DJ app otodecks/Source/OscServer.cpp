@@ -0,0 +1,470 @@
+/*
+  ==============================================================================
+
+    OscServer.cpp
+    Created: 20 Oct 2026 6:12:27am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "OscServer.h"
+#include "RealtimeLog.h"
+
+namespace
+{
+    const int numHotCues = 4;
+
+    // how often the track names the decks show are checked
+    const int trackNameCheckMs = 250;
+}
+
+//==============================================================================
+OscServer::OscServer(DJAudioPlayer& player1, DJAudioPlayer& player2,
+                     DeckGUI& deckGUI1, DeckGUI& deckGUI2,
+                     PlaylistComponent& playlistToControl, LevelMeter& masterMeterToStream)
+    : Thread("OSC stream"),
+      players{ &player1, &player2 },
+      deckGUIs{ &deckGUI1, &deckGUI2 },
+      playlist(playlistToControl),
+      masterMeter(masterMeterToStream)
+{
+    receiver.addListener(this);
+    startTimer(trackNameCheckMs);
+}
+
+OscServer::~OscServer()
+{
+    stopTimer();
+    stop();
+    receiver.removeListener(this);
+}
+
+bool OscServer::start(int port)
+{
+    stop();
+
+    // bound to the loopback address, so nothing else on the network can reach it
+    socket = std::make_unique<DatagramSocket>(false);
+    if (!socket->bindToPort(port, "127.0.0.1") || !receiver.connectToSocket(*socket))
+    {
+        RealtimeLog::write(RealtimeLog::error, "OscServer could not listen on port %d", port);
+        socket = nullptr;
+        return false;
+    }
+
+    listeningPort = port;
+#if JUCE_MAJOR_VERSION >= 7
+    startThread(Thread::Priority::low);
+#else
+    startThread(3);
+#endif
+    RealtimeLog::write(RealtimeLog::info, "OSC on 127.0.0.1:%d", port);
+    return true;
+}
+
+void OscServer::stop()
+{
+    receiver.disconnect();
+    socket = nullptr;
+    listeningPort = 0;
+
+    stopThread(2000);
+    const ScopedLock sl(subscriberLock);
+    subscribers.clear();
+}
+
+//==============================================================================
+void OscServer::oscBundleReceived(const OSCBundle& bundle)
+{
+    for (const OSCBundle::Element& element : bundle)
+    {
+        if (element.isMessage())
+        {
+            oscMessageReceived(element.getMessage());
+        }
+        else if (element.isBundle())
+        {
+            oscBundleReceived(element.getBundle());
+        }
+    }
+}
+
+void OscServer::oscMessageReceived(const OSCMessage& message)
+{
+    const StringArray parts = StringArray::fromTokens(message.getAddressPattern().toString(), "/", {});
+
+    // the first part is empty, before the leading slash
+    const String root = parts[1];
+    const int deck = parts[2].getIntValue() - 1;
+    const bool hasDeck = parts.size() == 4 && deck >= 0 && deck < numDecks;
+
+    if (root == "deck" && hasDeck)
+    {
+        handleDeckMessage(deck, parts[3], message);
+    }
+    else if (root == "queue" && hasDeck)
+    {
+        handleQueueMessage(deck, parts[3], message);
+    }
+    else if (root == "playlist" && parts.size() == 3)
+    {
+        handlePlaylistMessage(parts[2], message);
+    }
+    else if (root == "crossfader" && parts.size() == 2)
+    {
+        float value;
+        if (getNumber(message, 0, value))
+        {
+            pushCommand(CommandType::crossfader, 0, jlimit(0.0f, 1.0f, value));
+        }
+    }
+    else if (root == "subscribe" && parts.size() == 2)
+    {
+        float port, hz = (float) defaultStreamHz;
+        if (getNumber(message, 0, port))
+        {
+            getNumber(message, 1, hz);
+            subscribe((int) port, hz);
+        }
+    }
+    else if (root == "unsubscribe" && parts.size() == 2)
+    {
+        float port;
+        if (getNumber(message, 0, port))
+        {
+            unsubscribe((int) port);
+        }
+    }
+    else
+    {
+        RealtimeLog::write(RealtimeLog::debug, "OscServer ignored %s",
+                           message.getAddressPattern().toString().toRawUTF8());
+    }
+}
+
+void OscServer::handleDeckMessage(int deck, const String& command, const OSCMessage& message)
+{
+    float value = 0;
+    if (command == "play")
+    {
+        pushCommand(CommandType::play, deck, 0);
+    }
+    else if (command == "stop")
+    {
+        pushCommand(CommandType::stop, deck, 0);
+    }
+    else if (command == "cue" && getNumber(message, 0, value) && value >= 1 && value <= numHotCues)
+    {
+        pushCommand(CommandType::cue, deck, (float) ((int) value - 1));
+    }
+    else if (command == "gain" && getNumber(message, 0, value))
+    {
+        pushCommand(CommandType::gain, deck, jlimit(0.0f, 1.0f, value));
+    }
+    else if (command == "speed" && getNumber(message, 0, value))
+    {
+        pushCommand(CommandType::speed, deck, jlimit(0.0f, 3.0f, value));
+    }
+    else if (command == "position" && getNumber(message, 0, value))
+    {
+        pushCommand(CommandType::position, deck, jlimit(0.0f, 1.0f, value));
+    }
+    else if (command == "load")
+    {
+        String text;
+        const URL url = getString(message, 0, text) ? toURL(text) : URL();
+        if (url.isEmpty())
+        {
+            return;
+        }
+
+        WeakReference<OscServer> server(this);
+        MessageManager::callAsync([server, deck, url]
+        {
+            if (server != nullptr)
+            {
+                server->playlist.loadToDeck(deck + 1, url);
+            }
+        });
+    }
+}
+
+void OscServer::handleQueueMessage(int deck, const String& command, const OSCMessage& message)
+{
+    URL url;
+    if (command == "add")
+    {
+        String text;
+        url = getString(message, 0, text) ? toURL(text) : URL();
+        if (url.isEmpty())
+        {
+            return;
+        }
+    }
+    else if (command != "next" && command != "clear")
+    {
+        return;
+    }
+
+    WeakReference<OscServer> server(this);
+    MessageManager::callAsync([server, deck, command, url]
+    {
+        if (server == nullptr)
+        {
+            return;
+        }
+
+        DeckGUI& deckGUI = *server->deckGUIs[deck];
+        if (command == "add")
+        {
+            deckGUI.addToQueue(url, URL::removeEscapeChars(url.getFileName()).upToLastOccurrenceOf(".", false, false));
+        }
+        else if (command == "next")
+        {
+            deckGUI.playNextInQueue();
+        }
+        else
+        {
+            deckGUI.clearQueue();
+        }
+    });
+}
+
+void OscServer::handlePlaylistMessage(const String& command, const OSCMessage& message)
+{
+    WeakReference<OscServer> server(this);
+    String text;
+    float row, deck;
+
+    if (command == "add" && getString(message, 0, text) && File::isAbsolutePath(text))
+    {
+        const File file(text);
+        MessageManager::callAsync([server, file]
+        {
+            if (server != nullptr)
+            {
+                server->playlist.addToPlaylist(file);
+            }
+        });
+    }
+    else if (command == "load" && getNumber(message, 0, row) && getNumber(message, 1, deck)
+             && deck >= 1 && deck <= numDecks)
+    {
+        MessageManager::callAsync([server, row, deck]
+        {
+            if (server == nullptr)
+            {
+                return;
+            }
+
+            const URL url = server->playlist.getTrackURL((int) row);
+            if (!url.isEmpty())
+            {
+                server->playlist.loadToDeck((int) deck, url);
+            }
+        });
+    }
+}
+
+void OscServer::pushCommand(CommandType type, int deck, float value)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "OscServer queue is full, a command was dropped");
+        return;
+    }
+
+    Command& command = queue[size1 > 0 ? start1 : start2];
+    command.type = type;
+    command.deck = deck;
+    command.value = value;
+    fifo.finishedWrite(1);
+}
+
+bool OscServer::popCommand(Command& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+    {
+        return false;
+    }
+    command = queue[size1 > 0 ? start1 : start2];
+    fifo.finishedRead(1);
+    return true;
+}
+
+//==============================================================================
+void OscServer::subscribe(int port, double hz)
+{
+    if (port <= 0 || port > 65535)
+    {
+        return;
+    }
+
+    const ScopedLock sl(subscriberLock);
+    unsubscribe(port);
+    if (subscribers.size() >= maxSubscribers)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "OscServer has %d subscribers already, %d was refused",
+                           maxSubscribers, port);
+        return;
+    }
+
+    auto subscriber = std::make_unique<Subscriber>();
+    if (!subscriber->sender.connect("127.0.0.1", port))
+    {
+        return;
+    }
+    subscriber->port = port;
+    subscriber->intervalMs = 1000.0 / jlimit(1.0, maxStreamHz, hz);
+    subscriber->nextDueMs = Time::getMillisecondCounterHiRes();
+    subscribers.add(subscriber.release());
+
+    // send the first bundle now rather than after whatever it was waiting for
+    notify();
+}
+
+void OscServer::unsubscribe(int port)
+{
+    const ScopedLock sl(subscriberLock);
+    for (int i = subscribers.size(); --i >= 0;)
+    {
+        if (subscribers[i]->port == port)
+        {
+            subscribers.remove(i);
+        }
+    }
+}
+
+void OscServer::run()
+{
+    while (!threadShouldExit())
+    {
+        double waitMs = 1000.0;
+        {
+            const ScopedLock sl(subscriberLock);
+            const double now = Time::getMillisecondCounterHiRes();
+            for (auto* subscriber : subscribers)
+            {
+                if (now >= subscriber->nextDueMs)
+                {
+                    send(*subscriber);
+
+                    // stay on the subscriber's beat, but don't try to catch up after a stall
+                    subscriber->nextDueMs = jmax(subscriber->nextDueMs + subscriber->intervalMs, now);
+                }
+                waitMs = jmin(waitMs, subscriber->nextDueMs - now);
+            }
+        }
+        wait(jmax(1, (int) waitMs));
+    }
+}
+
+void OscServer::send(Subscriber& subscriber)
+{
+    OSCBundle bundle;
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        const String address = "/deck/" + String(deck + 1);
+        DJAudioPlayer& player = *players[deck];
+        const DeckScheduler::Timeline& timeline = player.getTimeline();
+
+        bundle.addElement(OSCMessage(address + "/state",
+                                     (int32) (timeline.isPlaying() ? 1 : 0),
+                                     (float) timeline.getTrackSeconds(),
+                                     (float) timeline.getTrackLengthSeconds(),
+                                     (float) player.getGain(),
+                                     (float) player.getSpeed()));
+        addLevels(bundle, address + "/level", player.getMeter());
+
+        const int version = trackVersions[deck].load();
+        if (version != subscriber.trackVersions[deck])
+        {
+            String name;
+            {
+                const SpinLock::ScopedLockType sl(trackNameLock);
+                name = trackNames[deck];
+            }
+            bundle.addElement(OSCMessage(address + "/track", name));
+            subscriber.trackVersions[deck] = version;
+        }
+    }
+    addLevels(bundle, "/master/level", masterMeter);
+
+    subscriber.sender.send(bundle);
+}
+
+void OscServer::addLevels(OSCBundle& bundle, const String& address, const LevelMeter& meter) const
+{
+    bundle.addElement(OSCMessage(address,
+                                 meter.getRMS(0), meter.getRMS(1),
+                                 meter.getBlockPeak(0), meter.getBlockPeak(1)));
+}
+
+void OscServer::timerCallback()
+{
+    for (int deck = 0; deck < numDecks; ++deck)
+    {
+        const String name = deckGUIs[deck]->getTrackName();
+        if (name != trackNames[deck])
+        {
+            {
+                const SpinLock::ScopedLockType sl(trackNameLock);
+                trackNames[deck] = name;
+            }
+            ++trackVersions[deck];
+        }
+    }
+}
+
+//==============================================================================
+bool OscServer::getNumber(const OSCMessage& message, int index, float& value)
+{
+    if (index >= message.size())
+    {
+        return false;
+    }
+
+    const OSCArgument& argument = message[index];
+    if (argument.isFloat32())
+    {
+        value = argument.getFloat32();
+        return true;
+    }
+    if (argument.isInt32())
+    {
+        value = (float) argument.getInt32();
+        return true;
+    }
+    return false;
+}
+
+bool OscServer::getString(const OSCMessage& message, int index, String& value)
+{
+    if (index >= message.size() || !message[index].isString())
+    {
+        return false;
+    }
+    value = message[index].getString();
+    return true;
+}
+
+URL OscServer::toURL(const String& text)
+{
+    if (text.startsWithIgnoreCase("http://") || text.startsWithIgnoreCase("https://"))
+    {
+        return URL(text);
+    }
+    if (File::isAbsolutePath(text))
+    {
+        return URL(File(text));
+    }
+
+    RealtimeLog::write(RealtimeLog::warning, "OscServer needs an absolute path or a link, got %s",
+                       text.toRawUTF8());
+    return {};
+}
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    OscServer.h
+    Created: 20 Oct 2026 6:12:27am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+#include "PlaylistComponent.h"
+
+//==============================================================================
+/*
+    OSC over UDP on localhost, for lighting desks, streaming software and
+    scripts on the same machine. Decks are numbered from 1.
+
+      /deck/N/play, /deck/N/stop
+      /deck/N/cue i          jump to hot cue 1-4
+      /deck/N/gain f         0 to 1
+      /deck/N/speed f        0 to 3, 1 is normal
+      /deck/N/position f     0 to 1 through the track
+      /deck/N/load s         a file path or http(s) link
+      /crossfader f          0 is all deck 1, 1 all deck 2
+      /queue/N/add s, /queue/N/next, /queue/N/clear
+      /playlist/add s        a file path
+      /playlist/load i i     playlist row (from 0) onto a deck
+      /subscribe i [f]       stream state to this port on localhost, at f Hz
+      /unsubscribe i
+
+    Messages are handled on the receiver's own thread. Deck and crossfader
+    commands go through a lock-free queue that the audio thread empties at
+    the start of each block, like the MIDI ones. Queue and playlist changes
+    are posted to the message thread. Neither ever waits for the other.
+
+    Subscribers get a bundle at their rate with, for each deck,
+      /deck/N/state i f f f f   playing, seconds in, track length, gain, speed
+      /deck/N/level f f f f     RMS left and right, then the last block's peaks
+      /deck/N/track s           when the track changes, and in the first bundle
+    and /master/level like a deck's. All of it is read from what the audio
+    thread publishes in atomics, so streaming never touches the audio either.
+*/
+class OscServer : private OSCReceiver::Listener<OSCReceiver::RealtimeCallback>,
+                  private Thread,
+                  private Timer
+{
+public:
+    enum class CommandType
+    {
+        play,
+        stop,
+        cue,
+        gain,
+        speed,
+        position,
+        crossfader
+    };
+
+    struct Command
+    {
+        CommandType type = CommandType::play;
+
+        // from 0, not used for the crossfader
+        int deck = 0;
+
+        // the hot cue from 0 for cue, otherwise the message's argument
+        float value = 0;
+    };
+
+    static constexpr int numDecks = 2;
+
+    OscServer(DJAudioPlayer& player1, DJAudioPlayer& player2,
+              DeckGUI& deckGUI1, DeckGUI& deckGUI2,
+              PlaylistComponent& playlistToControl, LevelMeter& masterMeterToStream);
+    ~OscServer() override;
+
+    // listen on 127.0.0.1 only. False if the port can't be opened
+    bool start(int port);
+    void stop();
+    int getPort() const { return listeningPort; }
+
+    // audio thread: the next deck or crossfader command, if there is one
+    bool popCommand(Command& command);
+
+    static constexpr int defaultPort = 9000;
+    static constexpr int queueSize = 256;
+    static constexpr int maxSubscribers = 8;
+    static constexpr double defaultStreamHz = 30.0;
+    static constexpr double maxStreamHz = 100.0;
+
+private:
+    struct Subscriber
+    {
+        int port = 0;
+        double intervalMs = 0;
+        double nextDueMs = 0;
+        OSCSender sender;
+
+        // which of each deck's track names it has been sent, -1 for none yet
+        int trackVersions[numDecks] = { -1, -1 };
+    };
+
+    /** implement OSCReceiver::Listener, on the receiver's thread */
+    void oscMessageReceived(const OSCMessage& message) override;
+    void oscBundleReceived(const OSCBundle& bundle) override;
+
+    /** implement Thread, sends to the subscribers */
+    void run() override;
+
+    /** implement Timer, picks up what the decks are showing as playing */
+    void timerCallback() override;
+
+    void handleDeckMessage(int deck, const String& command, const OSCMessage& message);
+    void handleQueueMessage(int deck, const String& command, const OSCMessage& message);
+    void handlePlaylistMessage(const String& command, const OSCMessage& message);
+    void pushCommand(CommandType type, int deck, float value);
+
+    void subscribe(int port, double hz);
+    void unsubscribe(int port);
+    void send(Subscriber& subscriber);
+    void addLevels(OSCBundle& bundle, const String& address, const LevelMeter& meter) const;
+
+    // a number argument whether it was sent as an int or a float
+    static bool getNumber(const OSCMessage& message, int index, float& value);
+    static bool getString(const OSCMessage& message, int index, String& value);
+
+    // an absolute file path or a link, an empty URL for anything else
+    static URL toURL(const String& text);
+
+    DJAudioPlayer* players[numDecks];
+    DeckGUI* deckGUIs[numDecks];
+    PlaylistComponent& playlist;
+    LevelMeter& masterMeter;
+
+    OSCReceiver receiver;
+    std::unique_ptr<DatagramSocket> socket;
+    int listeningPort = 0;
+
+    // written by the receiver thread only, so it needs no lock
+    AbstractFifo fifo{ queueSize };
+    Command queue[queueSize];
+
+    // shared by the receiver and streaming threads. The message thread only
+    // takes it when starting or stopping, the audio thread never
+    CriticalSection subscriberLock;
+    OwnedArray<Subscriber> subscribers;
+
+    // set on the message thread, copied by the streaming one when the version moves on
+    SpinLock trackNameLock;
+    String trackNames[numDecks];
+    std::atomic<int> trackVersions[numDecks]{ { 0 }, { 0 } };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(OscServer)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscServer)
+};
@@ -12,18 +12,26 @@
 #include "PlaylistComponent.h"
 #include "DeckGUI.h"
 
+namespace
+{
+    // how long each timer tick may spend applying library changes
+    const double libraryTimeSliceMs = 20.0;
+}
+
 PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
     DJAudioPlayer* _player2,
     DeckGUI* _deckGUI1,
     DeckGUI* _deckGUI2,
-    AudioFormatManager& formatManagerToUse,
-    AudioThumbnailCache& cacheToUse)
+    TrackDecoder& decoderToUse,
+    AudioThumbnailCache& cacheToUse,
+    File playlistFileToUse)
     : player1(_player1),
     player2(_player2),
     deckGUI1(_deckGUI1),
     deckGUI2(_deckGUI2),
-    formatManager(formatManagerToUse),
-    thumbCache(cacheToUse)
+    decoder(decoderToUse),
+    thumbCache(cacheToUse),
+    playlistFile(playlistFileToUse)
 {
 
     // In your constructor, you should add any child components, and
@@ -31,6 +39,7 @@ PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
     // Initialize the table with appropriate columns
     tableComponent.getHeader().addColumn("Track Title", 1, 200);
     tableComponent.getHeader().addColumn("Length", 2, 100);
+    tableComponent.getHeader().addColumn("Overview", 8, 150);
     tableComponent.getHeader().addColumn("Deck 1", 3, 100);
     tableComponent.getHeader().addColumn("Deck 2", 4, 100);
     tableComponent.getHeader().addColumn("Queue 1", 5, 100);
@@ -38,11 +47,17 @@ PlaylistComponent::PlaylistComponent(DJAudioPlayer* _player1,
     tableComponent.getHeader().addColumn("Delete", 7, 80);
 
     tableComponent.setModel(this);
+    overviews.addChangeListener(this);
 
     addAndMakeVisible(tableComponent);
 
+    watchedFoldersButton.addListener(this);
+    addAndMakeVisible(watchedFoldersButton);
+
     // load an existing playlist
     loadPlaylist();
+
+    startTimer(250);
 }
 
 PlaylistComponent::~PlaylistComponent()
@@ -64,11 +79,14 @@ void PlaylistComponent::resized()
     // Layout the components
     int margin = 10;
 
-    // Position the table to use the full component height
+    int headerHeight = 30;
+    watchedFoldersButton.setBounds(getWidth() - margin - 140, 5, 140, 20);
+
+    // Position the table to use the rest of the component height
     tableComponent.setBounds(margin,
-        margin,
+        headerHeight,
         getWidth() - (margin * 2),
-        getHeight() - (margin * 2));
+        getHeight() - headerHeight - margin);
 }
 
 int PlaylistComponent::getNumRows()
@@ -107,6 +125,13 @@ void PlaylistComponent::paintCell(Graphics& g,
             String timeStr = String(minutes) + ":" + (seconds < 10 ? "0" : "") + String(seconds);
             g.drawText(timeStr, 2, 0, width - 4, height, Justification::centred, true);
         }
+        else if (columnId == 8) // Overview, asked for the first time the row is drawn
+        {
+            if (const TrackOverviews::Overview* overview = overviews.getOverview(trackURLs[rowNumber]))
+            {
+                TrackOverviews::draw(g, *overview, Rectangle<float>(2.0f, 2.0f, width - 4.0f, height - 4.0f));
+            }
+        }
     }
 }
 
@@ -178,6 +203,12 @@ Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
 
 void PlaylistComponent::buttonClicked(Button* button)
 {
+    if (button == &watchedFoldersButton)
+    {
+        showWatchedFoldersMenu();
+        return;
+    }
+
     String id = button->getComponentID();
 
     if (id.startsWith("deck1_"))
@@ -229,11 +260,20 @@ void PlaylistComponent::buttonClicked(Button* button)
             {
                 trackLengths.erase(trackLengths.begin() + rowNumber);
             }
+            rebuildRowIndex();
             tableComponent.updateContent();
         }
     }
 }
 
+void PlaylistComponent::changeListenerCallback(ChangeBroadcaster* source)
+{
+    if (source == &overviews)
+    {
+        tableComponent.repaint();
+    }
+}
+
 bool PlaylistComponent::isInterestedInFileDrag(const StringArray& files)
 {
     // Accept files with audio extensions
@@ -306,9 +346,12 @@ void PlaylistComponent::savePlaylist()
         }
     }
 
+    for (const File& folder : libraryWatcher.getRoots())
+    {
+        playlist->createNewChildElement("WATCH")->setAttribute("path", folder.getFullPathName());
+    }
+
     // Save the XML to a file
-    File playlistFile(File::getSpecialLocation(File::userDocumentsDirectory)
-        .getChildFile("DJPlaylist.xml"));
     playlist->writeToFile(playlistFile, "");
 }
 
@@ -318,11 +361,9 @@ void PlaylistComponent::loadPlaylist()
     trackTitles.clear();
     trackURLs.clear();
     trackLengths.clear();
+    Array<File> watchedFolders;
 
     // Load from XML file
-    File playlistFile(File::getSpecialLocation(File::userDocumentsDirectory)
-        .getChildFile("DJPlaylist.xml"));
-
     if (playlistFile.existsAsFile())
     {
         std::unique_ptr<XmlElement> playlistElement = XmlDocument::parse(playlistFile);
@@ -348,55 +389,62 @@ void PlaylistComponent::loadPlaylist()
                             trackLengths.push_back(length);
                         }
                     }
+                    else if (trackElement->hasTagName("WATCH"))
+                    {
+                        watchedFolders.add(File(trackElement->getStringAttribute("path")));
+                    }
                 }
             }
         }
     }
 
+    rebuildRowIndex();
     tableComponent.updateContent();
+
+    libraryWatcher.setRoots(watchedFolders);
 }
 
 void PlaylistComponent::addToPlaylist(File file)
 {
-    if (file.existsAsFile())
+    if (addTrack(file))
     {
-        URL audioURL = URL(file);
+        tableComponent.updateContent();
+    }
+}
 
-        // Get the track title
-        String title = file.getFileNameWithoutExtension();
+bool PlaylistComponent::addTrack(const File& file)
+{
+    if (!file.existsAsFile())
+    {
+        return false;
+    }
 
-        // Check if the track is already in the playlist
-        bool isDuplicate = false;
-        for (const URL& url : trackURLs)
-        {
-            if (url.toString(false) == audioURL.toString(false))
-            {
-                isDuplicate = true;
-                break;
-            }
-        }
+    URL audioURL = URL(file);
 
-        if (!isDuplicate)
-        {
-            // Add the track to the playlist
-            trackTitles.push_back(title.toStdString());
-            trackURLs.push_back(audioURL);
+    // Check if the track is already in the playlist
+    const String key = audioURL.toString(false);
+    if (rowForURL.count(key) > 0)
+    {
+        return false;
+    }
 
-            // Calculate track length
-            std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
-            if (reader != nullptr)
-            {
-                double lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
-                trackLengths.push_back(lengthInSeconds);
-            }
-            else
-            {
-                trackLengths.push_back(0.0);
-            }
+    // Add the track to the playlist
+    rowForURL[key] = trackURLs.size();
+    trackTitles.push_back(file.getFileNameWithoutExtension().toStdString());
+    trackURLs.push_back(audioURL);
 
-            tableComponent.updateContent();
-        }
+    // Calculate track length, from a deck's decode if it has the track open
+    TrackInfo info;
+    if (decoder.getInfo(audioURL, info))
+    {
+        trackLengths.push_back(info.lengthInSeconds);
+    }
+    else
+    {
+        trackLengths.push_back(0.0);
     }
+
+    return true;
 }
 
 void PlaylistComponent::removeFromPlaylist()
@@ -412,19 +460,28 @@ void PlaylistComponent::removeFromPlaylist()
             trackLengths.erase(trackLengths.begin() + selectedRow);
         }
 
+        rebuildRowIndex();
         tableComponent.updateContent();
     }
 }
 
+URL PlaylistComponent::getTrackURL(int row) const
+{
+    if (row < 0 || row >= (int) trackURLs.size())
+    {
+        return {};
+    }
+    return trackURLs[row];
+}
+
 String PlaylistComponent::getTrackLength(URL audioURL)
 {
     // Get the length of the audio file
-    File file = audioURL.getLocalFile();
-    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    TrackInfo info;
 
-    if (reader != nullptr)
+    if (decoder.getInfo(audioURL, info))
     {
-        double lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+        double lengthInSeconds = info.lengthInSeconds;
         int minutes = static_cast<int>(lengthInSeconds) / 60;
         int seconds = static_cast<int>(lengthInSeconds) % 60;
 
@@ -432,4 +489,190 @@ String PlaylistComponent::getTrackLength(URL audioURL)
     }
 
     return "0:00";
-}
\ No newline at end of file
+}
+
+File PlaylistComponent::getDefaultPlaylistFile()
+{
+    return File::getSpecialLocation(File::userDocumentsDirectory)
+        .getChildFile("DJPlaylist.xml");
+}
+
+void PlaylistComponent::setWatchedFolders(const Array<File>& folders)
+{
+    libraryWatcher.setRoots(folders);
+    savePlaylist();
+}
+
+void PlaylistComponent::showWatchedFoldersMenu()
+{
+    Array<File> folders = getWatchedFolders();
+
+    PopupMenu menu;
+    menu.addItem(1, "Watch a folder...");
+    if (!folders.isEmpty())
+    {
+        menu.addSeparator();
+    }
+    for (int i = 0; i < folders.size(); ++i)
+    {
+        menu.addItem(2 + i, "Stop watching " + folders[i].getFullPathName());
+    }
+
+    menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&watchedFoldersButton),
+        [this, folders](int result)
+        {
+            if (result == 1)
+            {
+                auto chooserFlags = FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories;
+                folderChooser.launchAsync(chooserFlags, [this](const FileChooser& chooser)
+                    {
+                        File folder = chooser.getResult();
+                        if (folder.isDirectory())
+                        {
+                            Array<File> newFolders = getWatchedFolders();
+                            newFolders.addIfNotAlreadyThere(folder);
+                            setWatchedFolders(newFolders);
+                        }
+                    });
+            }
+            else if (result >= 2)
+            {
+                Array<File> newFolders = folders;
+                newFolders.remove(result - 2);
+                setWatchedFolders(newFolders);
+            }
+        });
+}
+
+void PlaylistComponent::timerCallback()
+{
+    // overviews for rows that have scrolled away aren't needed any more
+    const int rowHeight = tableComponent.getRowHeight();
+    const int firstVisible = tableComponent.getViewport()->getViewPositionY() / rowHeight;
+    const int lastVisible = jmin((int) trackURLs.size(),
+                                 firstVisible + tableComponent.getViewport()->getViewHeight() / rowHeight + 2);
+    StringArray visibleURLs;
+    for (int row = firstVisible; row < lastVisible; ++row)
+    {
+        visibleURLs.add(trackURLs[row].toString(false));
+    }
+    overviews.keepOnly(visibleURLs);
+
+    libraryChanges.addArray(libraryWatcher.takeChanges());
+    if (nextLibraryChange >= libraryChanges.size())
+    {
+        return;
+    }
+
+    // a slice at a time, so importing a big folder doesn't hold up the GUI
+    const double endTime = Time::getMillisecondCounterHiRes() + libraryTimeSliceMs;
+    while (nextLibraryChange < libraryChanges.size() && Time::getMillisecondCounterHiRes() < endTime)
+    {
+        applyLibraryChange(libraryChanges.getReference(nextLibraryChange++));
+    }
+
+    // removed together, each one on its own would shift every row after it
+    if (!pendingRemovals.empty())
+    {
+        removeTracks(pendingRemovals);
+        pendingRemovals.clear();
+    }
+
+    if (nextLibraryChange >= libraryChanges.size())
+    {
+        libraryChanges.clearQuick();
+        nextLibraryChange = 0;
+
+        // on disk before the watcher may save its snapshot, or a crash would lose them for good
+        savePlaylist();
+        libraryWatcher.changesSaved();
+    }
+
+    tableComponent.updateContent();
+    tableComponent.repaint();
+}
+
+void PlaylistComponent::applyLibraryChange(const LibraryWatcher::Change& change)
+{
+    const String key = URL(change.file).toString(false);
+
+    if (change.type == LibraryWatcher::Change::added)
+    {
+        pendingRemovals.erase(key);
+        addTrack(change.file);
+    }
+    else if (change.type == LibraryWatcher::Change::removed)
+    {
+        if (rowForURL.count(key) > 0)
+        {
+            pendingRemovals.insert(key);
+        }
+    }
+    else if (change.type == LibraryWatcher::Change::modified)
+    {
+        auto row = rowForURL.find(key);
+        TrackInfo info;
+        if (row != rowForURL.end() && decoder.getInfo(URL(change.file), info))
+        {
+            trackLengths[row->second] = info.lengthInSeconds;
+        }
+    }
+    else if (change.type == LibraryWatcher::Change::renamed)
+    {
+        auto row = rowForURL.find(URL(change.oldFile).toString(false));
+        if (row == rowForURL.end())
+        {
+            addTrack(change.file);
+        }
+        else if (rowForURL.count(key) > 0)
+        {
+            // already in the playlist under the new name
+            pendingRemovals.insert(row->first);
+        }
+        else
+        {
+            // keeps its place in the playlist
+            const size_t index = row->second;
+            rowForURL.erase(row);
+            rowForURL[key] = index;
+            trackURLs[index] = URL(change.file);
+            trackTitles[index] = change.file.getFileNameWithoutExtension().toStdString();
+        }
+    }
+}
+
+void PlaylistComponent::removeTracks(const std::unordered_set<String, LibraryWatcher::PathHash>& urls)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < trackURLs.size(); ++i)
+    {
+        if (urls.count(trackURLs[i].toString(false)) > 0)
+        {
+            continue;
+        }
+        if (kept != i)
+        {
+            trackTitles[kept] = std::move(trackTitles[i]);
+            trackURLs[kept] = trackURLs[i];
+            trackLengths[kept] = trackLengths[i];
+        }
+        ++kept;
+    }
+
+    trackTitles.erase(trackTitles.begin() + kept, trackTitles.end());
+    trackURLs.erase(trackURLs.begin() + kept, trackURLs.end());
+    trackLengths.erase(trackLengths.begin() + kept, trackLengths.end());
+
+    rebuildRowIndex();
+}
+
+void PlaylistComponent::rebuildRowIndex()
+{
+    rowForURL.clear();
+    rowForURL.reserve(trackURLs.size());
+
+    for (size_t i = 0; i < trackURLs.size(); ++i)
+    {
+        rowForURL[trackURLs[i].toString(false)] = i;
+    }
+}
@@ -13,23 +13,28 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <string>
+#include <unordered_set>
 #include "DJAudioPlayer.h"
 #include "WaveformDisplay.h"
 #include "DeckGUI.h" 
+#include "LibraryWatcher.h"
+#include "TrackOverviews.h"
 
 
 //==============================================================================
 /*
 */
-class PlaylistComponent  : public juce::Component, public TableListBoxModel, public Button::Listener, public FileDragAndDropTarget
+class PlaylistComponent  : public juce::Component, public TableListBoxModel, public Button::Listener, public FileDragAndDropTarget,
+                           public ChangeListener, private Timer
 {
 public:
     PlaylistComponent(DJAudioPlayer* _player1,
         DJAudioPlayer* _player2,
         DeckGUI* _deckGUI1,
         DeckGUI* _deckGUI2,
-        AudioFormatManager& formatManagerToUse,
-        AudioThumbnailCache& cacheToUse);
+        TrackDecoder& decoderToUse,
+        AudioThumbnailCache& cacheToUse,
+        File playlistFileToUse = getDefaultPlaylistFile());
     ~PlaylistComponent() override;
 
     void paint (juce::Graphics&) override;
@@ -43,6 +48,9 @@ public:
     
     void buttonClicked(Button * button) override;
 
+    // an overview has been worked out
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
     // File drag and drop methods
     bool isInterestedInFileDrag(const StringArray& files) override;
     void filesDropped(const StringArray& files, int x, int y) override;
@@ -55,20 +63,58 @@ public:
     void loadPlaylist();
     void addToPlaylist(File file);
     void removeFromPlaylist();
+
+    // the track in a row, or an empty URL past the end
+    URL getTrackURL(int row) const;
+
+    // the XML file the playlist is saved to and restored from
+    static File getDefaultPlaylistFile();
+
+    // folders whose audio files are kept in the playlist as they change
+    void setWatchedFolders(const Array<File>& folders);
+    Array<File> getWatchedFolders() const { return libraryWatcher.getRoots(); }
     
 private:
+    void timerCallback() override;
+
+    // adds a row without refreshing the table, false for a duplicate
+    bool addTrack(const File& file);
+
+    void applyLibraryChange(const LibraryWatcher::Change& change);
+
+    // drops these rows in one pass and renumbers the rest
+    void removeTracks(const std::unordered_set<String, LibraryWatcher::PathHash>& urls);
+    void rebuildRowIndex();
+
+    void showWatchedFoldersMenu();
+
     TableListBox tableComponent;
     std::vector<std::string> trackTitles;
 
     std::vector<URL> trackURLs;
     std::vector<double> trackLengths;
 
+    // row of each track by URL, for duplicates and library changes
+    std::unordered_map<String, size_t, LibraryWatcher::PathHash> rowForURL;
+
+    LibraryWatcher libraryWatcher;
+    Array<LibraryWatcher::Change> libraryChanges;
+    int nextLibraryChange = 0;
+    std::unordered_set<String, LibraryWatcher::PathHash> pendingRemovals;
+
+    TextButton watchedFoldersButton{ "Watched Folders..." };
+    FileChooser folderChooser{ "Watch a folder..." };
+
     DJAudioPlayer* player1;
     DJAudioPlayer* player2;
     DeckGUI* deckGUI1; 
     DeckGUI* deckGUI2;  
-    AudioFormatManager& formatManager;
+    TrackDecoder& decoder;
     AudioThumbnailCache& thumbCache;
+    File playlistFile;
+
+    // the mini waveforms in the Overview column, only for rows that get drawn
+    TrackOverviews overviews{ decoder };
 
     String getTrackLength(URL audioURL);
     
@@ -12,6 +12,12 @@
 #include "Queue.h"
 #include "DeckGUI.h"
 
+namespace
+{
+    // length of the automatic crossfade between queued tracks
+    const double autoCrossfadeSeconds = 4.0;
+}
+
 //==============================================================================
 Queue::Queue(DJAudioPlayer* _player, Component* _parentDeckGUI)
     : player(_player),
@@ -28,9 +34,17 @@ Queue::Queue(DJAudioPlayer* _player, Component* _parentDeckGUI)
     // Add buttons
     addAndMakeVisible(playNextButton);
     addAndMakeVisible(clearQueueButton);
+    addAndMakeVisible(crossfadeToggle);
 
     playNextButton.addListener(this);
     clearQueueButton.addListener(this);
+    crossfadeToggle.addListener(this);
+
+    crossfadeToggle.setColour(ToggleButton::textColourId, Colours::white);
+    crossfadeToggle.setColour(ToggleButton::tickColourId, Colours::skyblue);
+
+    player->addChangeListener(this);
+    lastTrackChangeCount = player->getTrackChangeCount();
 
     // Styling
     playNextButton.setColour(TextButton::buttonColourId, Colours::skyblue);
@@ -42,8 +56,10 @@ Queue::Queue(DJAudioPlayer* _player, Component* _parentDeckGUI)
 
 Queue::~Queue()
 {
+    player->removeChangeListener(this);
     playNextButton.removeListener(this);
     clearQueueButton.removeListener(this);
+    crossfadeToggle.removeListener(this);
 }
 
 void Queue::paint(Graphics& g)
@@ -59,11 +75,12 @@ void Queue::resized()
     // Layout components
     int margin = 5;
     int buttonHeight = 25;
-    int buttonWidth = (getWidth() - margin * 3) / 2; // Half width minus margins
+    int buttonWidth = (getWidth() - margin * 4) / 3; // Third of the width minus margins
 
     // Buttons at the top
     playNextButton.setBounds(margin, margin, buttonWidth, buttonHeight);
     clearQueueButton.setBounds(margin * 2 + buttonWidth, margin, buttonWidth, buttonHeight);
+    crossfadeToggle.setBounds(margin * 3 + buttonWidth * 2, margin, buttonWidth, buttonHeight);
 
     // Table for rest of the space
     queueTable.setBounds(margin,
@@ -139,6 +156,10 @@ void Queue::buttonClicked(Button* button)
     {
         clearQueue();
     }
+    else if (button == &crossfadeToggle)
+    {
+        player->setAutoCrossfade(crossfadeToggle.getToggleState() ? autoCrossfadeSeconds : 0.0);
+    }
     else
     {
         String id = button->getComponentID();
@@ -154,19 +175,13 @@ void Queue::buttonClicked(Button* button)
                 // Load and play the track
                 player->loadURL(url);
                 player->start();
-
-                // Update DeckGUI
-                if (DeckGUI* deckGUI = dynamic_cast<DeckGUI*>(parentDeckGUI))
-                {
-                    deckGUI->updateWaveformDisplay(url);
-                    File file = url.getLocalFile();
-                    deckGUI->updateTrackName(file.getFileNameWithoutExtension());
-                }
+                showTrackOnDeck(url);
 
                 // Remove from queue
                 queuedURLs.erase(queuedURLs.begin() + rowNumber);
                 queuedTrackNames.erase(queuedTrackNames.begin() + rowNumber);
                 queueTable.updateContent();
+                preloadQueueHead();
             }
         }
         else if (id.startsWith("remove_"))
@@ -178,6 +193,7 @@ void Queue::buttonClicked(Button* button)
                 queuedURLs.erase(queuedURLs.begin() + rowNumber);
                 queuedTrackNames.erase(queuedTrackNames.begin() + rowNumber);
                 queueTable.updateContent();
+                preloadQueueHead();
             }
         }
     }
@@ -191,6 +207,7 @@ void Queue::addToQueue(const URL& url, const String& trackName)
 
     // Update the table
     queueTable.updateContent();
+    preloadQueueHead();
 }
 
 void Queue::clearQueue()
@@ -198,30 +215,94 @@ void Queue::clearQueue()
     queuedURLs.clear();
     queuedTrackNames.clear();
     queueTable.updateContent();
+    preloadQueueHead();
 }
 
 void Queue::playNextInQueue()
 {
     if (!queuedURLs.empty())
     {
+        // The head is normally already buffered in the player, in which case it takes
+        // over straight away and changeListenerCallback() updates the queue
+        if (preloadedURL == queuedURLs[0] && player->playPreloadedTrack())
+        {
+            return;
+        }
+
         // Get the next track
         URL url = queuedURLs[0];
 
         // Load and play the track
         player->loadURL(url);
         player->start();
-
-        // Update DeckGUI
-        if (DeckGUI* deckGUI = dynamic_cast<DeckGUI*>(parentDeckGUI))
-        {
-            deckGUI->updateWaveformDisplay(url);
-            File file = url.getLocalFile();
-            deckGUI->updateTrackName(file.getFileNameWithoutExtension());
-        }
+        showTrackOnDeck(url);
 
         // Remove from queue
         queuedURLs.erase(queuedURLs.begin());
         queuedTrackNames.erase(queuedTrackNames.begin());
         queueTable.updateContent();
+        preloadQueueHead();
+    }
+}
+
+void Queue::changeListenerCallback(ChangeBroadcaster* source)
+{
+    int tracksAdvanced = player->getTrackChangeCount() - lastTrackChangeCount;
+    lastTrackChangeCount = player->getTrackChangeCount();
+
+    if (tracksAdvanced <= 0)
+    {
+        return;
+    }
+
+    // the preloaded head is playing now
+    preloadedURL = URL();
+    while (tracksAdvanced-- > 0 && !queuedURLs.empty())
+    {
+        showTrackOnDeck(queuedURLs[0]);
+        queuedURLs.erase(queuedURLs.begin());
+        queuedTrackNames.erase(queuedTrackNames.begin());
+    }
+
+    queueTable.updateContent();
+    preloadQueueHead();
+}
+
+void Queue::preloadQueueHead()
+{
+    if (queuedURLs.empty())
+    {
+        if (!preloadedURL.isEmpty())
+        {
+            player->clearPreloadedTrack();
+            preloadedURL = URL();
+        }
+        return;
+    }
+
+    if (queuedURLs[0] == preloadedURL)
+    {
+        return;
+    }
+
+    if (player->preloadNextURL(queuedURLs[0]))
+    {
+        preloadedURL = queuedURLs[0];
+    }
+    else
+    {
+        player->clearPreloadedTrack();
+        preloadedURL = URL();
+    }
+}
+
+void Queue::showTrackOnDeck(const URL& url)
+{
+    // Update DeckGUI
+    if (DeckGUI* deckGUI = dynamic_cast<DeckGUI*>(parentDeckGUI))
+    {
+        deckGUI->updateWaveformDisplay(url);
+        File file = url.getLocalFile();
+        deckGUI->updateTrackName(file.getFileNameWithoutExtension());
     }
 }
@@ -19,7 +19,8 @@
 
 class Queue : public Component,
     public TableListBoxModel,
-    public Button::Listener
+    public Button::Listener,
+    public ChangeListener
 {
 public:
     Queue(DJAudioPlayer* player, Component* parentDeckGUI);
@@ -35,6 +36,9 @@ public:
 
     void buttonClicked(Button* button) override;
 
+    // the player moved on to the track we preloaded for it
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
     // Queue management
     void addToQueue(const URL& url, const String& trackName);
     void clearQueue();
@@ -42,6 +46,12 @@ public:
     bool hasTracksInQueue() const { return !queuedURLs.empty(); }
 
 private:
+    // keep the head of the queue open and buffered in the player
+    void preloadQueueHead();
+
+    // show a track that just started playing on the parent deck
+    void showTrackOnDeck(const URL& url);
+
     TableListBox queueTable;
     std::vector<URL> queuedURLs;
     std::vector<String> queuedTrackNames;
@@ -49,8 +59,12 @@ private:
     DJAudioPlayer* player;
     Component* parentDeckGUI;
 
+    URL preloadedURL;
+    int lastTrackChangeCount = 0;
+
     TextButton playNextButton{ "Play Next" };
     TextButton clearQueueButton{ "Clear Queue" };
+    ToggleButton crossfadeToggle{ "Auto X-Fade" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Queue)
 };
\ No newline at end of file
@@ -0,0 +1,503 @@
+/*
+  ==============================================================================
+
+    RangeCache.cpp
+    Created: 19 Oct 2026 9:41:27pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "RangeCache.h"
+#include "RealtimeLog.h"
+
+namespace
+{
+    const int mapMagic = 0x4f545243; // "OTRC"
+    const int connectTimeoutMs = 10000;
+    const int maxRetries = 3;
+    const int retryDelayMs = 1000;
+    const int64 maxCacheBytes = (int64) 2 * 1024 * 1024 * 1024;
+
+    // the data files of every cache that is open, which the purge mustn't touch
+    struct OpenCaches
+    {
+        CriticalSection lock;
+        Array<File> dataFiles;
+    };
+
+    OpenCaches& getOpenCaches()
+    {
+        static OpenCaches openCaches;
+        return openCaches;
+    }
+
+    String getRangeHeader(int64 start, int64 end)
+    {
+        return "Range: bytes=" + String(start) + "-" + String(end);
+    }
+
+    // InputStream::read may stop short of what was asked for
+    int readFully(InputStream& stream, void* dest, int numBytes)
+    {
+        int done = 0;
+        while (done < numBytes)
+        {
+            const int num = stream.read(static_cast<char*>(dest) + done, numBytes - done);
+            if (num <= 0)
+            {
+                break;
+            }
+            done += num;
+        }
+        return done;
+    }
+}
+
+//==============================================================================
+class RangeCache::Stream : public InputStream
+{
+public:
+    Stream(RangeCache::Ptr cacheToRead)
+        : cache(cacheToRead)
+    {
+    }
+
+    int64 getTotalLength() override { return cache->getTotalLength(); }
+    bool isExhausted() override { return position >= cache->getTotalLength(); }
+    int64 getPosition() override { return position; }
+
+    bool setPosition(int64 newPosition) override
+    {
+        position = jlimit((int64) 0, cache->getTotalLength(), newPosition);
+        return true;
+    }
+
+    int read(void* dest, int numBytes) override
+    {
+        const int num = (int) jmin((int64) numBytes, cache->getTotalLength() - position);
+        if (num <= 0 || !cache->read(dest, position, num))
+        {
+            return 0;
+        }
+        position += num;
+        return num;
+    }
+
+private:
+    RangeCache::Ptr cache;
+    int64 position = 0;
+};
+
+//==============================================================================
+RangeCache::Ptr RangeCache::open(const URL& url, int timeoutMs)
+{
+    purgeCacheDirectory();
+
+    // ask for the first chunk, which also tells us the length and whether ranges work
+    StringPairArray responseHeaders;
+    int statusCode = 0;
+    auto stream = url.createInputStream(false, nullptr, nullptr, getRangeHeader(0, chunkSize - 1),
+                                        connectTimeoutMs, &responseHeaders, &statusCode);
+    if (stream == nullptr)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "RangeCache::open could not connect to %s", url.toString(false).toRawUTF8());
+        return nullptr;
+    }
+
+    const bool rangesSupported = statusCode == 206;
+    const int64 totalLength = rangesSupported
+        ? responseHeaders["Content-Range"].fromLastOccurrenceOf("/", false, false).getLargeIntValue()
+        : stream->getTotalLength();
+
+    if ((statusCode != 200 && statusCode != 206) || totalLength <= 0)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "RangeCache::open got status %d and no length for %s", statusCode,
+                           url.toString(false).toRawUTF8());
+        return nullptr;
+    }
+
+    Ptr cache = new RangeCache(url, totalLength, rangesSupported);
+
+    // what's already on disk from last time, unless the file has changed size since
+    if (!cache->loadChunkMap())
+    {
+        cache->dataFile.deleteFile();
+    }
+
+    // the probe already brought the first chunk with it
+    if (rangesSupported && !cache->isChunkFetched(0))
+    {
+        const int firstChunkBytes = (int) jmin((int64) chunkSize, totalLength);
+        HeapBlock<char> data((size_t) firstChunkBytes);
+        if (readFully(*stream, data, firstChunkBytes) == firstChunkBytes)
+        {
+            cache->storeChunk(0, data, firstChunkBytes);
+        }
+    }
+    stream.reset();
+
+    cache->startThread();
+
+    // enough to read the header and get playback going
+    const int bufferChunks = (int) jmin((int64) cache->numChunks, minimumBufferBytes / chunkSize);
+    const uint32 giveUpTime = Time::getMillisecondCounter() + (uint32) timeoutMs;
+    for (int chunk = 0; chunk < bufferChunks && !cache->failed.load(); ++chunk)
+    {
+        while (!cache->isChunkFetched(chunk) && !cache->failed.load()
+               && Time::getMillisecondCounter() < giveUpTime)
+        {
+            cache->chunkArrived.wait(50);
+        }
+    }
+
+    if (cache->failed.load())
+    {
+        return nullptr;
+    }
+    return cache;
+}
+
+RangeCache::RangeCache(const URL& urlToFetch, int64 length, bool ranges)
+    : Thread("Range cache"),
+      url(urlToFetch),
+      totalLength(length),
+      rangesSupported(ranges),
+      numChunks((int) ((length + chunkSize - 1) / chunkSize))
+{
+    const String name = getCacheName(url);
+    dataFile = getCacheDirectory().getChildFile(name + ".data");
+    mapFile = getCacheDirectory().getChildFile(name + ".map");
+    getCacheDirectory().createDirectory();
+
+    chunkFetched.insertMultiple(0, false, numChunks);
+
+    OpenCaches& openCaches = getOpenCaches();
+    const ScopedLock sl(openCaches.lock);
+    openCaches.dataFiles.add(dataFile);
+}
+
+RangeCache::~RangeCache()
+{
+    stopThread(connectTimeoutMs + 1000);
+
+    OpenCaches& openCaches = getOpenCaches();
+    const ScopedLock sl(openCaches.lock);
+    openCaches.dataFiles.removeFirstMatchingValue(dataFile);
+}
+
+bool RangeCache::isFullyCached() const
+{
+    const ScopedLock sl(lock);
+    return !chunkFetched.contains(false);
+}
+
+bool RangeCache::read(void* dest, int64 offset, int numBytes)
+{
+    jassert(offset >= 0 && offset + numBytes <= totalLength);
+
+    const int lastChunk = (int) ((offset + numBytes - 1) / chunkSize);
+    for (int chunk = (int) (offset / chunkSize); chunk <= lastChunk; ++chunk)
+    {
+        if (!waitForChunk(chunk))
+        {
+            return false;
+        }
+    }
+
+    const ScopedLock sl(lock);
+    if (cacheReader == nullptr)
+    {
+        cacheReader.reset(new FileInputStream(dataFile));
+    }
+    return !cacheReader->failedToOpen()
+        && cacheReader->setPosition(offset)
+        && readFully(*cacheReader, dest, numBytes) == numBytes;
+}
+
+bool RangeCache::isCached(int64 offset, int64 numBytes)
+{
+    const int firstChunk = (int) jlimit((int64) 0, (int64) numChunks - 1, offset / chunkSize);
+    const int lastChunk = (int) jlimit((int64) 0, (int64) numChunks - 1, (offset + numBytes - 1) / chunkSize);
+
+    for (int chunk = firstChunk; chunk <= lastChunk; ++chunk)
+    {
+        if (!isChunkFetched(chunk))
+        {
+            requestedChunk = chunk;
+            return false;
+        }
+    }
+    return true;
+}
+
+void RangeCache::waitForChunks(int timeoutMs)
+{
+    chunkArrived.wait(timeoutMs);
+}
+
+std::unique_ptr<InputStream> RangeCache::createInputStream()
+{
+    // the format readers ask for a few bytes at a time
+    return std::make_unique<BufferedInputStream>(new Stream(this), 32768, true);
+}
+
+File RangeCache::getCacheDirectory()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("StreamCache");
+}
+
+void RangeCache::forget(const URL& url)
+{
+    const String name = getCacheName(url);
+    getCacheDirectory().getChildFile(name + ".data").deleteFile();
+    getCacheDirectory().getChildFile(name + ".map").deleteFile();
+}
+
+String RangeCache::getCacheName(const URL& url)
+{
+    return String::toHexString(url.toString(true).hashCode64());
+}
+
+//==============================================================================
+void RangeCache::run()
+{
+    if (isFullyCached())
+    {
+        return;
+    }
+
+    if (!rangesSupported)
+    {
+        if (!fetchWholeFile())
+        {
+            failed = true;
+            chunkArrived.signal();
+        }
+        return;
+    }
+
+    int failures = 0;
+    while (!threadShouldExit())
+    {
+        const int chunk = getNextChunkToFetch();
+        if (chunk < 0)
+        {
+            break;
+        }
+
+        if (fetchChunk(chunk))
+        {
+            failures = 0;
+        }
+        else if (++failures > maxRetries)
+        {
+            RealtimeLog::write(RealtimeLog::error, "RangeCache::run gave up on %s", url.toString(false).toRawUTF8());
+            failed = true;
+            chunkArrived.signal();
+            break;
+        }
+        else
+        {
+            wait(retryDelayMs);
+        }
+    }
+}
+
+bool RangeCache::fetchChunk(int chunk)
+{
+    const int64 start = (int64) chunk * chunkSize;
+    const int numBytes = (int) jmin((int64) chunkSize, totalLength - start);
+
+    int statusCode = 0;
+    auto stream = url.createInputStream(false, nullptr, nullptr, getRangeHeader(start, start + numBytes - 1),
+                                        connectTimeoutMs, nullptr, &statusCode);
+    if (stream == nullptr || statusCode != 206)
+    {
+        return false;
+    }
+
+    HeapBlock<char> data((size_t) numBytes);
+    return readFully(*stream, data, numBytes) == numBytes
+        && storeChunk(chunk, data, numBytes);
+}
+
+bool RangeCache::fetchWholeFile()
+{
+    auto stream = url.createInputStream(false, nullptr, nullptr, {}, connectTimeoutMs);
+    if (stream == nullptr)
+    {
+        return false;
+    }
+
+    HeapBlock<char> data((size_t) chunkSize);
+    for (int chunk = 0; chunk < numChunks && !threadShouldExit(); ++chunk)
+    {
+        const int numBytes = (int) jmin((int64) chunkSize, totalLength - (int64) chunk * chunkSize);
+        if (readFully(*stream, data, numBytes) != numBytes || !storeChunk(chunk, data, numBytes))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RangeCache::storeChunk(int chunk, const void* data, int numBytes)
+{
+    {
+        FileOutputStream out(dataFile);
+        if (out.failedToOpen() || !out.setPosition((int64) chunk * chunkSize) || !out.write(data, (size_t) numBytes))
+        {
+            RealtimeLog::write(RealtimeLog::warning, "RangeCache::storeChunk could not write %s",
+                               dataFile.getFullPathName().toRawUTF8());
+            return false;
+        }
+        out.flush();
+    }
+
+    {
+        const ScopedLock sl(lock);
+        chunkFetched.set(chunk, true);
+    }
+
+    saveChunkMap();
+    chunkArrived.signal();
+    return true;
+}
+
+bool RangeCache::waitForChunk(int chunk)
+{
+    while (!isChunkFetched(chunk))
+    {
+        if (failed.load())
+        {
+            return false;
+        }
+
+        // don't hold up the decoder shutting down
+        if (auto* job = ThreadPoolJob::getCurrentThreadPoolJob())
+        {
+            if (job->shouldExit())
+            {
+                return false;
+            }
+        }
+
+        requestedChunk = chunk;
+        chunkArrived.wait(50);
+    }
+    return true;
+}
+
+bool RangeCache::isChunkFetched(int chunk) const
+{
+    const ScopedLock sl(lock);
+    return chunkFetched[chunk];
+}
+
+int RangeCache::getNextChunkToFetch()
+{
+    // a reader is waiting for this one, and will most likely want the ones after it
+    const int requested = requestedChunk.exchange(-1);
+    if (requested >= 0 && !isChunkFetched(requested))
+    {
+        nextChunk = requested + 1;
+        return requested;
+    }
+
+    for (int i = 0; i < numChunks; ++i)
+    {
+        const int chunk = (nextChunk + i) % numChunks;
+        if (!isChunkFetched(chunk))
+        {
+            nextChunk = chunk + 1;
+            return chunk;
+        }
+    }
+    return -1;
+}
+
+//==============================================================================
+void RangeCache::saveChunkMap() const
+{
+    MemoryOutputStream out;
+    out.writeInt(mapMagic);
+    out.writeString(url.toString(true));
+    out.writeInt64(totalLength);
+    out.writeInt(numChunks);
+
+    {
+        const ScopedLock sl(lock);
+        for (bool fetched : chunkFetched)
+        {
+            out.writeBool(fetched);
+        }
+    }
+
+    mapFile.replaceWithData(out.getData(), out.getDataSize());
+}
+
+bool RangeCache::loadChunkMap()
+{
+    FileInputStream in(mapFile);
+    if (in.failedToOpen()
+        || in.readInt() != mapMagic
+        || in.readString() != url.toString(true)
+        || in.readInt64() != totalLength
+        || in.readInt() != numChunks
+        || in.getNumBytesRemaining() < numChunks
+        || !dataFile.existsAsFile())
+    {
+        return false;
+    }
+
+    const ScopedLock sl(lock);
+    for (int i = 0; i < numChunks; ++i)
+    {
+        chunkFetched.set(i, in.readBool());
+    }
+
+    // touched, so it's the last to be purged
+    mapFile.setLastModificationTime(Time::getCurrentTime());
+    return true;
+}
+
+void RangeCache::purgeCacheDirectory()
+{
+    Array<File> maps = getCacheDirectory().findChildFiles(File::findFiles, false, "*.map");
+
+    int64 totalBytes = 0;
+    for (const File& map : maps)
+    {
+        totalBytes += map.withFileExtension("data").getSize();
+    }
+
+    // oldest first
+    std::sort(maps.begin(), maps.end(), [](const File& a, const File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    OpenCaches& openCaches = getOpenCaches();
+    const ScopedLock sl(openCaches.lock);
+
+    for (const File& map : maps)
+    {
+        if (totalBytes <= maxCacheBytes)
+        {
+            break;
+        }
+
+        // a track that is playing keeps its cache, however old it is
+        const File data = map.withFileExtension("data");
+        if (openCaches.dataFiles.contains(data))
+        {
+            continue;
+        }
+        totalBytes -= data.getSize();
+        data.deleteFile();
+        map.deleteFile();
+    }
+}
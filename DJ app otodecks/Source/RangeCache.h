@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    RangeCache.h
+    Created: 19 Oct 2026 9:41:27pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A remote file fetched in chunks with HTTP range requests on a background
+    thread, into a cache file on disk. Chunks come in order from the start,
+    except that reading one that isn't there yet moves it to the front, and
+    the fetch carries on from there.
+
+    The cache survives restarts, so a track that was played once opens from
+    disk next time. Servers that ignore ranges still work, they are just
+    downloaded start to finish.
+*/
+class RangeCache : public ReferenceCountedObject,
+                   private Thread
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<RangeCache>;
+
+    // starts fetching and waits (up to timeoutMs) for the first minimumBufferBytes.
+    // nullptr if the server can't be reached or doesn't say how big the file is
+    static Ptr open(const URL& url, int timeoutMs);
+
+    ~RangeCache() override;
+
+    const URL& getURL() const { return url; }
+    int64 getTotalLength() const { return totalLength; }
+    bool isFullyCached() const;
+
+    // blocks until the bytes are in. False if fetching failed for good, or the
+    // thread pool job calling it has been asked to stop
+    bool read(void* dest, int64 offset, int numBytes);
+
+    // whether read() would return straight away. If not, the first missing
+    // chunk is fetched next, so a caller that mustn't wait can come back later
+    bool isCached(int64 offset, int64 numBytes);
+
+    // waits up to timeoutMs for another chunk to arrive
+    void waitForChunks(int timeoutMs);
+    bool hasFailed() const { return failed.load(); }
+
+    // reads through the cache, and keeps it alive
+    std::unique_ptr<InputStream> createInputStream();
+
+    static File getCacheDirectory();
+
+    // throws away what is on disk for url, so the next open starts cold. Not for
+    // a cache that is open
+    static void forget(const URL& url);
+
+    static constexpr int chunkSize = 256 * 1024;
+    static constexpr int64 minimumBufferBytes = 512 * 1024;
+
+private:
+    class Stream;
+
+    RangeCache(const URL& url, int64 totalLength, bool rangesSupported);
+
+    void run() override;
+
+    bool fetchChunk(int chunk);
+    bool fetchWholeFile();
+    bool storeChunk(int chunk, const void* data, int numBytes);
+    bool waitForChunk(int chunk);
+    bool isChunkFetched(int chunk) const;
+    int getNextChunkToFetch();
+
+    void saveChunkMap() const;
+    bool loadChunkMap();
+
+    // drop the least recently used files once the directory gets too big.
+    // Caches that are open are left alone
+    static void purgeCacheDirectory();
+    static String getCacheName(const URL& url);
+
+    URL url;
+    int64 totalLength;
+    bool rangesSupported;
+    int numChunks;
+    File dataFile, mapFile;
+
+    // guards the chunk flags and cacheReader
+    CriticalSection lock;
+    Array<bool> chunkFetched;
+    std::unique_ptr<FileInputStream> cacheReader;
+
+    int nextChunk = 0;
+    std::atomic<int> requestedChunk{ -1 };
+    std::atomic<bool> failed{ false };
+    WaitableEvent chunkArrived;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RangeCache)
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.cpp
+    Created: 20 Oct 2026 1:38:12am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "RealtimeLog.h"
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+    // how often the writer looks for messages. The audio thread can't wake it,
+    // that would mean taking a lock
+    const int drainIntervalMs = 20;
+
+    struct Record
+    {
+        std::atomic<size_t> sequence;
+        RealtimeLog::Level level;
+        uint32 time;
+        char text[RealtimeLog::maxLength];
+    };
+
+    /*  A bounded queue that any thread can add to and one thread takes from.
+        Each slot's sequence number says whether it is free for the writer
+        whose turn it is, or holds a finished record for the reader.
+    */
+    struct Queue
+    {
+        Queue()
+        {
+            for (size_t i = 0; i < (size_t) RealtimeLog::capacity; ++i)
+            {
+                records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // the slot to write into, or nullptr if the queue is full
+        Record* claim(size_t& position)
+        {
+            position = writePosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Record& record = records[position & mask];
+                const size_t sequence = record.sequence.load(std::memory_order_acquire);
+                const auto difference = (intptr_t) sequence - (intptr_t) position;
+
+                if (difference == 0)
+                {
+                    if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        return &record;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    position = writePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void publish(Record& record, size_t position)
+        {
+            record.sequence.store(position + 1, std::memory_order_release);
+        }
+
+        // the oldest finished record, or nullptr. Only ever called from the writer
+        Record* peek()
+        {
+            Record& record = records[readPosition & mask];
+            if (record.sequence.load(std::memory_order_acquire) != readPosition + 1)
+            {
+                return nullptr;
+            }
+            return &record;
+        }
+
+        void release(Record& record)
+        {
+            record.sequence.store(readPosition + (size_t) RealtimeLog::capacity, std::memory_order_release);
+            ++readPosition;
+        }
+
+        static constexpr size_t mask = (size_t) RealtimeLog::capacity - 1;
+        static_assert((RealtimeLog::capacity & (RealtimeLog::capacity - 1)) == 0,
+                      "capacity has to be a power of two");
+
+        Record records[RealtimeLog::capacity];
+        std::atomic<size_t> writePosition{ 0 };
+        size_t readPosition = 0;
+
+        std::atomic<int> minimumLevel{
+           #if JUCE_DEBUG
+            RealtimeLog::debug
+           #else
+            RealtimeLog::info
+           #endif
+        };
+        std::atomic<uint32> numDropped{ 0 };
+    };
+
+    Queue& getQueue()
+    {
+        static Queue queue;
+        return queue;
+    }
+
+    const char* getLevelName(RealtimeLog::Level level)
+    {
+        switch (level)
+        {
+            case RealtimeLog::debug:   return "debug";
+            case RealtimeLog::info:    return "info";
+            case RealtimeLog::warning: return "warning";
+            case RealtimeLog::error:   return "error";
+        }
+        return "";
+    }
+}
+
+//==============================================================================
+void RealtimeLog::write(Level level, const char* format, ...)
+{
+    Queue& queue = getQueue();
+    if (level < queue.minimumLevel.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    size_t position;
+    Record* record = queue.claim(position);
+    if (record == nullptr)
+    {
+        queue.numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record->level = level;
+    record->time = Time::getMillisecondCounter();
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record->text, sizeof(record->text), format, args);
+    va_end(args);
+
+    queue.publish(*record, position);
+}
+
+void RealtimeLog::setMinimumLevel(Level level)
+{
+    getQueue().minimumLevel = level;
+}
+
+//==============================================================================
+RealtimeLog::Writer::Writer(std::ostream& outputStream)
+    : Thread("Log writer"),
+      out(outputStream)
+{
+    getQueue();
+   #if JUCE_MAJOR_VERSION >= 7
+    startThread(Thread::Priority::background);
+   #else
+    startThread(1);
+   #endif
+}
+
+RealtimeLog::Writer::~Writer()
+{
+    stopThread(2000);
+
+    // whatever came in while stopping
+    drain();
+}
+
+void RealtimeLog::Writer::run()
+{
+    while (!threadShouldExit())
+    {
+        drain();
+        wait(drainIntervalMs);
+    }
+}
+
+void RealtimeLog::Writer::drain()
+{
+    Queue& queue = getQueue();
+    bool wroteAnything = false;
+
+    while (Record* record = queue.peek())
+    {
+        out << String(record->time / 1000.0, 3) << " " << getLevelName(record->level) << ": " << record->text << "\n";
+        queue.release(*record);
+        wroteAnything = true;
+    }
+
+    if (const uint32 dropped = queue.numDropped.exchange(0))
+    {
+        out << dropped << " log messages were dropped, the log was full\n";
+        wroteAnything = true;
+    }
+
+    if (wroteAnything)
+    {
+        out.flush();
+    }
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    RealtimeLog.h
+    Created: 20 Oct 2026 1:38:12am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <ostream>
+
+//==============================================================================
+/*
+    Logging that is safe from the audio thread. write() formats the message
+    straight into a slot of a fixed lock-free queue and returns, it never
+    allocates, locks or waits. A Writer empties the queue onto a stream from
+    its own thread. If the queue is full the message is dropped and counted.
+*/
+class RealtimeLog
+{
+public:
+    enum Level
+    {
+        debug,
+        info,
+        warning,
+        error
+    };
+
+    // printf style. Longer messages are cut at maxLength
+    static void write(Level level, const char* format, ...);
+
+    // anything below this is ignored, debug by default in debug builds
+    static void setMinimumLevel(Level level);
+
+    static constexpr int maxLength = 120;
+    static constexpr int capacity = 4096;
+
+    //==============================================================================
+    /*
+        Drains the log while it exists. There should only be one, the app owns it.
+    */
+    class Writer : private Thread
+    {
+    public:
+        Writer(std::ostream& out);
+        ~Writer() override;
+
+    private:
+        void run() override;
+        void drain();
+
+        std::ostream& out;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Writer)
+    };
+};
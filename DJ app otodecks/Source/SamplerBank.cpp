@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+    SamplerBank.cpp
+    Created: 20 Oct 2026 8:04:52am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "SamplerBank.h"
+
+namespace
+{
+    // how long a stolen voice takes to fade out, so it doesn't click
+    constexpr int stealFadeSamples = 128;
+}
+
+//==============================================================================
+SamplerBank::SamplerBank(TrackDecoder& decoderToUse)
+    : decoder(decoderToUse)
+{
+    for (auto& sample : padSamples)
+    {
+        sample = nullptr;
+    }
+
+    startTimer(500);
+}
+
+SamplerBank::~SamplerBank()
+{
+    stopTimer();
+}
+
+//==============================================================================
+bool SamplerBank::assign(int pad, const URL& url)
+{
+    if (!isPositiveAndBelow(pad, numPads))
+    {
+        return false;
+    }
+
+    DecodedTrack::Ptr sample = decoder.open(url);
+    if (sample == nullptr || sample->getLengthInSeconds() > maxSampleSeconds)
+    {
+        return false;
+    }
+
+    // the voices read straight from memory, so all of it has to be there
+    // first. The timer puts it on the pad once it is
+    loadingPads[pad] = sample;
+    savePads();
+    timerCallback();
+    return true;
+}
+
+void SamplerBank::clear(int pad)
+{
+    if (isPositiveAndBelow(pad, numPads) && (pads[pad] != nullptr || loadingPads[pad] != nullptr))
+    {
+        loadingPads[pad] = nullptr;
+        setSample(pad, nullptr);
+        savePads();
+    }
+}
+
+bool SamplerBank::hasSample(int pad) const
+{
+    return isPositiveAndBelow(pad, numPads) && pads[pad] != nullptr;
+}
+
+bool SamplerBank::isLoading(int pad) const
+{
+    return isPositiveAndBelow(pad, numPads) && loadingPads[pad] != nullptr;
+}
+
+String SamplerBank::getPadName(int pad) const
+{
+    if (!hasSample(pad))
+    {
+        return {};
+    }
+    return URL::removeEscapeChars(pads[pad]->getURL().getFileName()).upToLastOccurrenceOf(".", false, false);
+}
+
+void SamplerBank::setSample(int pad, DecodedTrack::Ptr sample)
+{
+    DecodedTrack::Ptr old = pads[pad];
+    pads[pad] = sample;
+    padSamples[pad].store(sample.get());
+
+    // a block that is running now may have just picked up the old one
+    if (old != nullptr)
+    {
+        retired.add(old);
+        retiredAtBlock.add(blocksRendered.load());
+    }
+}
+
+void SamplerBank::timerCallback()
+{
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        if (loadingPads[pad] != nullptr && loadingPads[pad]->isFullyDecoded())
+        {
+            setSample(pad, loadingPads[pad]);
+            loadingPads[pad] = nullptr;
+        }
+    }
+
+    const int64 blocks = blocksRendered.load();
+
+    for (int i = retired.size(); --i >= 0;)
+    {
+        // no block can see it on a pad any more, and no voice is playing it
+        if (blocks > retiredAtBlock[i] + 1 && retired.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+        {
+            retired.remove(i);
+            retiredAtBlock.remove(i);
+        }
+    }
+}
+
+//==============================================================================
+void SamplerBank::trigger(int pad, float velocity)
+{
+    if (!isPositiveAndBelow(pad, numPads))
+    {
+        return;
+    }
+
+    const SpinLock::ScopedLockType sl(triggerLock);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 > 0)
+    {
+        Trigger& trigger = triggers[start1];
+        trigger.pad = pad;
+        trigger.velocity = jlimit(0.0f, 1.0f, velocity);
+        trigger.arrivalMs = Time::getMillisecondCounterHiRes();
+    }
+    fifo.finishedWrite(size1);
+}
+
+void SamplerBank::setGain(float newGain)
+{
+    gain = jlimit(0.0f, 2.0f, newGain);
+}
+
+float SamplerBank::getGain() const
+{
+    return gain.load();
+}
+
+//==============================================================================
+void SamplerBank::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    outputSampleRate = sampleRate;
+    appliedGain = gain.load();
+    scratch.setSize(2, samplesPerBlockExpected);
+}
+
+void SamplerBank::process(AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // new triggers start at the top of this block
+    while (fifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        if (size1 > 0)
+        {
+            startVoice(triggers[start1]);
+        }
+        fifo.finishedRead(size1);
+    }
+
+    const float targetGain = gain.load();
+    int playing = 0;
+
+    for (auto& voice : voices)
+    {
+        if (voice.tail != nullptr)
+        {
+            const int count = jmin(numSamples, voice.tailRemaining);
+            const float endGain = voice.tailGain * (float) (voice.tailRemaining - count) / (float) voice.tailRemaining;
+            const bool more = render(*voice.tail, voice.tailPosition, buffer, startSample, count, voice.tailGain, endGain);
+
+            voice.tailGain = endGain;
+            voice.tailRemaining -= count;
+            if (!more || voice.tailRemaining <= 0)
+            {
+                voice.tail = nullptr;
+            }
+        }
+
+        if (voice.sample != nullptr)
+        {
+            if (render(*voice.sample, voice.position, buffer, startSample, numSamples,
+                       voice.gain * appliedGain, voice.gain * targetGain))
+            {
+                ++playing;
+            }
+            else
+            {
+                voice.sample = nullptr;
+            }
+        }
+    }
+
+    appliedGain = targetGain;
+    voicesPlaying = playing;
+    ++blocksRendered;
+}
+
+void SamplerBank::startVoice(const Trigger& trigger)
+{
+    latency.report(trigger.arrivalMs);
+
+    DecodedTrack* sample = padSamples[trigger.pad].load();
+    if (sample == nullptr)
+    {
+        return;
+    }
+
+    // a free voice, or else the one that has been playing longest
+    Voice* chosen = nullptr;
+    for (auto& voice : voices)
+    {
+        if (voice.sample == nullptr)
+        {
+            chosen = &voice;
+            break;
+        }
+        if (chosen == nullptr || nextOrder - voice.order > nextOrder - chosen->order)
+        {
+            chosen = &voice;
+        }
+    }
+
+    Voice& voice = *chosen;
+    if (voice.sample != nullptr)
+    {
+        // what it was playing fades out under the new sound
+        voice.tail = std::move(voice.sample);
+        voice.tailPosition = voice.position;
+        voice.tailGain = voice.gain * appliedGain;
+        voice.tailRemaining = stealFadeSamples;
+    }
+
+    // never the last reference: the pad or the retired list still has one
+    voice.sample = sample;
+    voice.position = 0;
+    voice.gain = trigger.velocity;
+    voice.order = nextOrder++;
+}
+
+bool SamplerBank::render(const DecodedTrack& sample, double& position, AudioBuffer<float>& buffer,
+                         int startSample, int numSamples, float startGain, float endGain)
+{
+    const int64 length = sample.getLengthInSamples();
+    const int numChannels = jmin(buffer.getNumChannels(), 2);
+    const int lastSourceChannel = sample.getNumChannels() - 1;
+    const double step = sample.getSampleRate() / outputSampleRate;
+
+    if (numSamples <= 0 || position >= (double) length)
+    {
+        return position < (double) length;
+    }
+
+    // the samples left before the end, at most a block
+    const int count = (int) jmin((int64) numSamples, (int64) std::ceil(((double) length - position) / step));
+    const float gainStep = (endGain - startGain) / (float) numSamples;
+
+    if (step == 1.0 && position == std::floor(position))
+    {
+        // same rate as the device, no interpolation. Read out as floats
+        // whichever way the sample is stored, in pieces the size scratch was
+        // prepared with rather than growing it here
+        const int chunkSize = scratch.getNumSamples();
+        jassert(chunkSize > 0);
+
+        for (int done = 0; done < count; done += chunkSize)
+        {
+            const int num = jmin(chunkSize, count - done);
+            const float chunkGain = startGain + gainStep * (float) done;
+
+            sample.read(scratch, 0, (int64) position + done, num);
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                buffer.addFromWithRamp(channel, startSample + done, scratch.getReadPointer(channel),
+                                       num, chunkGain, chunkGain + gainStep * (float) num);
+            }
+        }
+    }
+    else
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const int sourceChannel = jmin(channel, lastSourceChannel);
+            float* out = buffer.getWritePointer(channel, startSample);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const double where = position + step * i;
+                const int64 index = (int64) where;
+                const float frac = (float) (where - (double) index);
+                const float current = sample.getSample(sourceChannel, index);
+                const float next = index + 1 < length ? sample.getSample(sourceChannel, index + 1) : 0.0f;
+                out[i] += (current + frac * (next - current)) * (startGain + gainStep * (float) i);
+            }
+        }
+    }
+
+    position += step * count;
+    return position < (double) length;
+}
+
+//==============================================================================
+File SamplerBank::getPadsFile()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("SamplerPads.xml");
+}
+
+void SamplerBank::loadPads()
+{
+    std::unique_ptr<XmlElement> xml = XmlDocument::parse(getPadsFile());
+    if (xml == nullptr)
+    {
+        return;
+    }
+
+    for (auto* padXml : xml->getChildWithTagNameIterator("PAD"))
+    {
+        const int pad = padXml->getIntAttribute("index", -1);
+        const URL url(padXml->getStringAttribute("url"));
+        if (isPositiveAndBelow(pad, numPads) && !url.isEmpty())
+        {
+            // on their pads from the timer as they finish decoding
+            DecodedTrack::Ptr sample = decoder.open(url);
+            if (sample != nullptr && sample->getLengthInSeconds() <= maxSampleSeconds)
+            {
+                loadingPads[pad] = sample;
+            }
+        }
+    }
+}
+
+void SamplerBank::savePads() const
+{
+    XmlElement xml("SAMPLERPADS");
+    for (int pad = 0; pad < numPads; ++pad)
+    {
+        // what is about to go on the pad, if anything is still decoding
+        const DecodedTrack* sample = loadingPads[pad] != nullptr ? loadingPads[pad].get() : pads[pad].get();
+        if (sample != nullptr)
+        {
+            auto* padXml = xml.createNewChildElement("PAD");
+            padXml->setAttribute("index", pad);
+            padXml->setAttribute("url", sample->getURL().toString(false));
+        }
+    }
+
+    getPadsFile().getParentDirectory().createDirectory();
+    xml.writeTo(getPadsFile());
+}
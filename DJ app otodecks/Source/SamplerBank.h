@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    SamplerBank.h
+    Created: 20 Oct 2026 8:04:52am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LatencyMeter.h"
+#include "TrackDecoder.h"
+
+//==============================================================================
+/*
+    Sixteen one-shot pads for horns, drops and IDs, mixed into the master bus.
+
+    A sample is decoded completely into memory when it is assigned to a pad,
+    and only goes on the pad once it is all in. Nothing waits for that, a
+    timer puts it on.
+    Triggers are queued lock-free and start at the beginning of the next
+    audio block, on one of a fixed set of voices. When they are all busy
+    the oldest is faded out quickly and reused. Playing a pad never
+    allocates or reads the disk.
+
+    A sample taken off a pad is kept until the audio thread can't be using
+    it any more, so its memory is never freed on the audio thread.
+*/
+class SamplerBank : private Timer
+{
+public:
+    static constexpr int numPads = 16;
+    static constexpr int numVoices = 32;
+    static constexpr int maxTriggers = 64;
+
+    // longer than this isn't a one-shot, and would take a while to decode
+    static constexpr double maxSampleSeconds = 30.0;
+
+    using LatencyStats = LatencyMeter::Stats;
+
+    SamplerBank(TrackDecoder& decoderToUse);
+    ~SamplerBank() override;
+
+    // message thread. Starts decoding and returns, the sample goes on the pad
+    // once it is all in. False if it can't be read or is too long for a pad
+    bool assign(int pad, const URL& url);
+    void clear(int pad);
+    bool hasSample(int pad) const;
+
+    // a sample is decoding for this pad, and will go on it when it is done
+    bool isLoading(int pad) const;
+
+    // e.g. the file name without the extension, empty if there's nothing on it
+    String getPadName(int pad) const;
+
+    // play a pad from the start of the next block. Any thread but the audio one
+    void trigger(int pad, float velocity = 1.0f);
+
+    void setGain(float newGain);
+    float getGain() const;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+
+    // audio thread: adds the playing pads into the buffer
+    void process(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    int getNumVoicesPlaying() const { return voicesPlaying.load(); }
+
+    // trigger to the block it is heard in, since the last call. Message thread
+    LatencyStats takeLatencyStats() { return latency.take(); }
+
+    // puts back the samples from last time, once the decoder knows the formats
+    void loadPads();
+    static File getPadsFile();
+
+private:
+    struct Trigger
+    {
+        int pad = 0;
+        float velocity = 1.0f;
+        double arrivalMs = 0;
+    };
+
+    struct Voice
+    {
+        DecodedTrack::Ptr sample;
+        double position = 0;
+        float gain = 0;
+        uint32 order = 0;
+
+        // a stolen voice's old sample, fading out
+        DecodedTrack::Ptr tail;
+        double tailPosition = 0;
+        float tailGain = 0;
+        int tailRemaining = 0;
+    };
+
+    /** implement Timer, puts decoded samples on their pads and lets go of
+        samples the audio thread is done with */
+    void timerCallback() override;
+
+    void startVoice(const Trigger& trigger);
+
+    // adds sample into the buffer from position with a gain ramp, false once it has finished
+    bool render(const DecodedTrack& sample, double& position, AudioBuffer<float>& buffer,
+                int startSample, int numSamples, float startGain, float endGain);
+
+    void setSample(int pad, DecodedTrack::Ptr sample);
+    void savePads() const;
+
+    TrackDecoder& decoder;
+
+    // message thread: what's on each pad. The audio thread reads the raw pointers
+    DecodedTrack::Ptr pads[numPads];
+    std::atomic<DecodedTrack*> padSamples[numPads];
+
+    // message thread: samples still decoding, for the pads they'll go on
+    DecodedTrack::Ptr loadingPads[numPads];
+
+    // taken off a pad, with the block count at the time
+    ReferenceCountedArray<DecodedTrack> retired;
+    Array<int64> retiredAtBlock;
+    std::atomic<int64> blocksRendered{ 0 };
+
+    AbstractFifo fifo{ maxTriggers };
+    Trigger triggers[maxTriggers];
+    SpinLock triggerLock;
+
+    // audio thread only
+    Voice voices[numVoices];
+    uint32 nextOrder = 0;
+    double outputSampleRate = 44100.0;
+    float appliedGain = 1.0f;
+    AudioBuffer<float> scratch;
+
+    std::atomic<float> gain{ 1.0f };
+    std::atomic<int> voicesPlaying{ 0 };
+
+    LatencyMeter latency;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplerBank)
+};
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    SamplerPanel.cpp
+    Created: 20 Oct 2026 8:37:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "SamplerPanel.h"
+
+//==============================================================================
+SamplerPanel::SamplerPanel(SamplerBank& bankToPlay, double blockLengthMs)
+    : bank(bankToPlay),
+      blockMs(blockLengthMs)
+{
+    for (int pad = 0; pad < SamplerBank::numPads; ++pad)
+    {
+        auto* button = padButtons.add(new TextButton());
+
+        // fire as the pad goes down, not when it is let go
+        button->setTriggeredOnMouseDown(true);
+        button->addListener(this);
+        addAndMakeVisible(button);
+    }
+
+    gainSlider.setRange(0.0, 2.0);
+    gainSlider.setValue(bank.getGain(), dontSendNotification);
+    gainSlider.setTextBoxStyle(Slider::TextBoxRight, true, 50, 20);
+    gainSlider.setColour(Slider::thumbColourId, Colours::white);
+    gainSlider.addListener(this);
+    addAndMakeVisible(gainSlider);
+
+    statusLabel.setText("Pad to audio: nothing played yet (block " + String(blockMs, 1) + " ms)",
+                        dontSendNotification);
+    statusLabel.setColour(Label::textColourId, Colours::white);
+    statusLabel.setFont(Font(12.0f));
+    addAndMakeVisible(statusLabel);
+
+    updatePads();
+    startTimer(500);
+
+    setSize(padsPerRow * padSize + 10, (SamplerBank::numPads / padsPerRow) * padSize + 60);
+}
+
+SamplerPanel::~SamplerPanel()
+{
+    stopTimer();
+    gainSlider.removeListener(this);
+    for (auto* button : padButtons)
+    {
+        button->removeListener(this);
+    }
+}
+
+void SamplerPanel::paint(Graphics& g)
+{
+    g.fillAll(Colours::slategrey);
+}
+
+void SamplerPanel::resized()
+{
+    for (int pad = 0; pad < SamplerBank::numPads; ++pad)
+    {
+        const int x = 5 + (pad % padsPerRow) * padSize;
+        const int y = 5 + (pad / padsPerRow) * padSize;
+        padButtons[pad]->setBounds(x + 2, y + 2, padSize - 4, padSize - 4);
+    }
+
+    const int y = 5 + (SamplerBank::numPads / padsPerRow) * padSize;
+    gainSlider.setBounds(5, y, getWidth() - 10, 24);
+    statusLabel.setBounds(5, y + 26, getWidth() - 10, 24);
+}
+
+void SamplerPanel::buttonClicked(Button* button)
+{
+    const int pad = padButtons.indexOf(static_cast<TextButton*>(button));
+    if (pad < 0)
+    {
+        return;
+    }
+
+    const ModifierKeys mods = ModifierKeys::getCurrentModifiers();
+    if (mods.isShiftDown())
+    {
+        bank.clear(pad);
+        updatePads();
+    }
+    else if (mods.isPopupMenu() || (!bank.hasSample(pad) && !bank.isLoading(pad)))
+    {
+        // an empty pad asks for a sample rather than doing nothing
+        Component::SafePointer<SamplerPanel> safeThis(this);
+        chooser.launchAsync(FileBrowserComponent::openMode | FileBrowserComponent::canSelectFiles,
+                            [safeThis, pad](const FileChooser& fileChooser)
+                            {
+                                if (safeThis != nullptr && fileChooser.getResult().existsAsFile())
+                                {
+                                    safeThis->assign(pad, fileChooser.getResult());
+                                }
+                            });
+    }
+    else
+    {
+        bank.trigger(pad);
+    }
+}
+
+void SamplerPanel::sliderValueChanged(Slider* slider)
+{
+    if (slider == &gainSlider)
+    {
+        bank.setGain((float) gainSlider.getValue());
+    }
+}
+
+bool SamplerPanel::isInterestedInFileDrag(const StringArray& files)
+{
+    return files.size() == 1;
+}
+
+void SamplerPanel::filesDropped(const StringArray& files, int x, int y)
+{
+    for (int pad = 0; pad < SamplerBank::numPads; ++pad)
+    {
+        if (padButtons[pad]->getBounds().contains(x, y))
+        {
+            assign(pad, File(files[0]));
+        }
+    }
+}
+
+void SamplerPanel::assign(int pad, const File& file)
+{
+    if (!bank.assign(pad, URL(file)))
+    {
+        statusLabel.setText("Couldn't load " + file.getFileName() + " (up to "
+                            + String(SamplerBank::maxSampleSeconds, 0) + " s)", dontSendNotification);
+    }
+    updatePads();
+}
+
+void SamplerPanel::updatePads()
+{
+    for (int pad = 0; pad < SamplerBank::numPads; ++pad)
+    {
+        const bool loaded = bank.hasSample(pad);
+        padButtons[pad]->setButtonText(bank.isLoading(pad) ? "..." : loaded ? bank.getPadName(pad) : "+");
+        padButtons[pad]->setColour(TextButton::buttonColourId, loaded ? Colours::darkorange : Colours::darkslategrey);
+    }
+}
+
+void SamplerPanel::timerCallback()
+{
+    // a sample that was still decoding may have gone on its pad since
+    updatePads();
+
+    const SamplerBank::LatencyStats stats = bank.takeLatencyStats();
+    if (stats.count == 0)
+    {
+        // keep showing the last lot
+        return;
+    }
+
+    statusLabel.setText("Pad to audio: avg " + String(stats.averageMs, 2) + " ms, max "
+                        + String(stats.maxMs, 2) + " ms (block " + String(blockMs, 1) + " ms), "
+                        + String(bank.getNumVoicesPlaying()) + " voices",
+                        dontSendNotification);
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    SamplerPanel.h
+    Created: 20 Oct 2026 8:37:15am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SamplerBank.h"
+
+//==============================================================================
+/*
+    The sample pads, shown in a call-out from the PADS button. Clicking a pad
+    plays it, right-clicking or dropping a file on it loads a sample and
+    shift-clicking clears it.
+*/
+class SamplerPanel : public Component,
+                     public Button::Listener,
+                     public Slider::Listener,
+                     public FileDragAndDropTarget,
+                     private Timer
+{
+public:
+    // blockMs is the audio device's block length, to compare the latency with
+    SamplerPanel(SamplerBank& bankToPlay, double blockMs);
+    ~SamplerPanel();
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    /** implement Button::Listener */
+    void buttonClicked(Button* button) override;
+
+    /** implement Slider::Listener */
+    void sliderValueChanged(Slider* slider) override;
+
+    /** implement FileDragAndDropTarget, a file dropped on a pad goes on it */
+    bool isInterestedInFileDrag(const StringArray& files) override;
+    void filesDropped(const StringArray& files, int x, int y) override;
+
+private:
+    /** implement Timer, refreshes the pads, the latency and the voices */
+    void timerCallback() override;
+
+    void assign(int pad, const File& file);
+    void updatePads();
+
+    SamplerBank& bank;
+    double blockMs;
+
+    OwnedArray<TextButton> padButtons;
+    Slider gainSlider;
+    Label statusLabel;
+    FileChooser chooser{ "Select a sample...", {}, "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3" };
+
+    static constexpr int padSize = 80;
+    static constexpr int padsPerRow = 4;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplerPanel)
+};
@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    SeekIndex.cpp
+    Created: 19 Oct 2026 8:03:16pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "SeekIndex.h"
+#include "RealtimeLog.h"
+
+namespace
+{
+    const int cacheMagic = 0x4f545349; // "OTSI"
+    const int cacheVersion = 1;
+
+    struct FrameHeader
+    {
+        int length = 0;
+        int sampleRate = 0;
+        int samplesPerFrame = 0;
+        int numChannels = 0;
+    };
+
+    // MPEG audio layer III only, that's all the MP3 reader plays
+    bool parseHeader(const uint8* bytes, FrameHeader& header)
+    {
+        static const int mpeg1Bitrates[] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+        static const int mpeg2Bitrates[] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+        static const int mpeg1SampleRates[] = { 44100, 48000, 32000, 0 };
+
+        if (bytes[0] != 0xff || (bytes[1] & 0xe0) != 0xe0)
+        {
+            return false;
+        }
+
+        const int version = (bytes[1] >> 3) & 3; // 3 = MPEG 1, 2 = MPEG 2, 0 = MPEG 2.5
+        const int layer = (bytes[1] >> 1) & 3;   // 1 = layer III
+        const int bitrateIndex = (bytes[2] >> 4) & 15;
+        const int sampleRateIndex = (bytes[2] >> 2) & 3;
+        const int padding = (bytes[2] >> 1) & 1;
+
+        if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+        {
+            return false;
+        }
+
+        const bool mpeg1 = version == 3;
+        const int bitrate = (mpeg1 ? mpeg1Bitrates : mpeg2Bitrates)[bitrateIndex] * 1000;
+        header.sampleRate = mpeg1SampleRates[sampleRateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+        header.samplesPerFrame = mpeg1 ? 1152 : 576;
+        header.numChannels = ((bytes[3] >> 6) & 3) == 3 ? 1 : 2;
+        header.length = (mpeg1 ? 144 : 72) * bitrate / header.sampleRate + padding;
+        return true;
+    }
+}
+
+//==============================================================================
+std::unique_ptr<SeekIndex> SeekIndex::getFor(const File& file)
+{
+    if (auto cached = getCachedFor(file))
+    {
+        return cached;
+    }
+
+    auto index = build(file);
+    if (index != nullptr)
+    {
+        File cacheFile = getCacheFileFor(file);
+        if (!cacheFile.getParentDirectory().createDirectory() || !index->save(cacheFile, file))
+        {
+            RealtimeLog::write(RealtimeLog::warning, "SeekIndex::getFor could not save %s",
+                               cacheFile.getFullPathName().toRawUTF8());
+        }
+    }
+    return index;
+}
+
+std::unique_ptr<SeekIndex> SeekIndex::getCachedFor(const File& file)
+{
+    if (!canIndex(file))
+    {
+        return nullptr;
+    }
+    return load(getCacheFileFor(file), file);
+}
+
+bool SeekIndex::canIndex(const File& file)
+{
+    return file.hasFileExtension("mp3") && file.existsAsFile();
+}
+
+int SeekIndex::getFrameForSample(int64 sample) const
+{
+    return (int) jlimit((int64) 0, (int64) jmax(0, getNumFrames() - 1), sample / samplesPerFrame);
+}
+
+File SeekIndex::getCacheDirectory()
+{
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+        .getChildFile("OtoDecks")
+        .getChildFile("SeekIndex");
+}
+
+//==============================================================================
+std::unique_ptr<SeekIndex> SeekIndex::build(const File& file)
+{
+    MemoryBlock data;
+    if (!canIndex(file) || !file.loadFileAsData(data))
+    {
+        return nullptr;
+    }
+
+    const uint8* bytes = static_cast<const uint8*>(data.getData());
+    const int64 size = (int64) data.getSize();
+    int64 position = 0;
+
+    // skip an ID3v2 tag, its size is stored 7 bits to the byte
+    if (size > 10 && bytes[0] == 'I' && bytes[1] == 'D' && bytes[2] == '3')
+    {
+        position = 10 + ((bytes[6] & 0x7f) << 21 | (bytes[7] & 0x7f) << 14 | (bytes[8] & 0x7f) << 7 | (bytes[9] & 0x7f));
+        if ((bytes[5] & 0x10) != 0)
+        {
+            position += 10; // footer
+        }
+    }
+
+    std::unique_ptr<SeekIndex> index(new SeekIndex());
+    FrameHeader header;
+
+    while (position + 4 <= size)
+    {
+        if (!parseHeader(bytes + position, header)
+            || (index->sampleRate > 0 && header.sampleRate != (int) index->sampleRate))
+        {
+            // the trailing ID3v1 tag, or junk between frames. Resync on the next byte
+            if (size - position == 128 && bytes[position] == 'T' && bytes[position + 1] == 'A' && bytes[position + 2] == 'G')
+            {
+                break;
+            }
+            ++position;
+            continue;
+        }
+
+        // a frame that runs off the end of the file is a truncated download, leave it out
+        const int64 next = position + header.length;
+        if (next > size)
+        {
+            break;
+        }
+
+        // a real frame is followed by another one (or the end, or the ID3v1 tag),
+        // which rules out sync words that turn up by chance in the audio data
+        FrameHeader nextHeader;
+        if (next + 4 <= size && !parseHeader(bytes + next, nextHeader)
+            && !(bytes[next] == 'T' && bytes[next + 1] == 'A' && bytes[next + 2] == 'G'))
+        {
+            ++position;
+            continue;
+        }
+
+        if (index->frameOffsets.isEmpty())
+        {
+            index->sampleRate = header.sampleRate;
+            index->samplesPerFrame = header.samplesPerFrame;
+            index->numChannels = header.numChannels;
+        }
+
+        index->frameOffsets.add(position);
+        position = next;
+    }
+
+    if (index->frameOffsets.isEmpty())
+    {
+        return nullptr;
+    }
+    return index;
+}
+
+File SeekIndex::getCacheFileFor(const File& file)
+{
+    return getCacheDirectory().getChildFile(String::toHexString(file.getFullPathName().hashCode64()) + ".idx");
+}
+
+bool SeekIndex::save(const File& cacheFile, const File& sourceFile) const
+{
+    FileOutputStream out(cacheFile);
+    if (out.failedToOpen())
+    {
+        return false;
+    }
+    out.setPosition(0);
+    out.truncate();
+
+    out.writeInt(cacheMagic);
+    out.writeInt(cacheVersion);
+    out.writeString(sourceFile.getFullPathName());
+    out.writeInt64(sourceFile.getSize());
+    out.writeInt64(sourceFile.getLastModificationTime().toMilliseconds());
+    out.writeDouble(sampleRate);
+    out.writeInt(samplesPerFrame);
+    out.writeInt(numChannels);
+    out.writeInt(getNumFrames());
+    out.writeInt64(frameOffsets.getFirst());
+
+    // frames are at most a few kB, so the gaps between them fit in 16 bits
+    for (int i = 1; i < getNumFrames(); ++i)
+    {
+        out.writeShort((short) (uint16) (frameOffsets[i] - frameOffsets[i - 1]));
+    }
+
+    out.flush();
+    return out.getStatus().wasOk();
+}
+
+std::unique_ptr<SeekIndex> SeekIndex::load(const File& cacheFile, const File& sourceFile)
+{
+    FileInputStream in(cacheFile);
+    if (in.failedToOpen()
+        || in.readInt() != cacheMagic
+        || in.readInt() != cacheVersion
+        || in.readString() != sourceFile.getFullPathName()
+        || in.readInt64() != sourceFile.getSize()
+        || in.readInt64() != sourceFile.getLastModificationTime().toMilliseconds())
+    {
+        // missing, or the file has changed since
+        return nullptr;
+    }
+
+    std::unique_ptr<SeekIndex> index(new SeekIndex());
+    index->sampleRate = in.readDouble();
+    index->samplesPerFrame = in.readInt();
+    index->numChannels = in.readInt();
+    const int numFrames = in.readInt();
+
+    if (index->sampleRate <= 0 || index->samplesPerFrame <= 0 || index->numChannels <= 0 || numFrames <= 0)
+    {
+        return nullptr;
+    }
+
+    // a cache file cut short would otherwise read as zeros
+    if (in.getNumBytesRemaining() < 8 + (int64) (numFrames - 1) * 2)
+    {
+        return nullptr;
+    }
+
+    index->frameOffsets.ensureStorageAllocated(numFrames);
+    int64 offset = in.readInt64();
+    index->frameOffsets.add(offset);
+
+    for (int i = 1; i < numFrames; ++i)
+    {
+        offset += (uint16) in.readShort();
+        index->frameOffsets.add(offset);
+    }
+
+    return index;
+}
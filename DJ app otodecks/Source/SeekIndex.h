@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    SeekIndex.h
+    Created: 19 Oct 2026 8:03:16pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Where every frame of an MP3 starts in the file, so decoding can begin at any
+    sample without scanning the frame headers from the start, and so the length
+    is exact even for VBR files with no Xing header.
+
+    Built from the frame headers the first time a file is loaded and kept in
+    a cache directory, keyed by path, size and modification time.
+*/
+class SeekIndex
+{
+public:
+    // the cached index for this file, built and saved if there isn't one yet.
+    // nullptr for anything that isn't a readable MPEG layer III file
+    static std::unique_ptr<SeekIndex> getFor(const File& file);
+
+    // only the cached one, never scans the file
+    static std::unique_ptr<SeekIndex> getCachedFor(const File& file);
+
+    static bool canIndex(const File& file);
+
+    double getSampleRate() const { return sampleRate; }
+    int getSamplesPerFrame() const { return samplesPerFrame; }
+    int getNumChannels() const { return numChannels; }
+    int getNumFrames() const { return frameOffsets.size(); }
+
+    // the decoder produces samplesPerFrame samples for every frame, the Xing/Info frame included
+    int64 getLengthInSamples() const { return (int64) getNumFrames() * samplesPerFrame; }
+
+    // the frame holding this sample, and where it starts in the file and in samples
+    int getFrameForSample(int64 sample) const;
+    int64 getFrameOffset(int frame) const { return frameOffsets[frame]; }
+    int64 getFrameStartSample(int frame) const { return (int64) frame * samplesPerFrame; }
+
+    static File getCacheDirectory();
+
+private:
+    SeekIndex() = default;
+
+    // walk the frame headers
+    static std::unique_ptr<SeekIndex> build(const File& file);
+
+    static File getCacheFileFor(const File& file);
+    bool save(const File& cacheFile, const File& sourceFile) const;
+    static std::unique_ptr<SeekIndex> load(const File& cacheFile, const File& sourceFile);
+
+    double sampleRate = 0;
+    int samplesPerFrame = 0;
+    int numChannels = 0;
+    Array<int64> frameOffsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SeekIndex)
+};
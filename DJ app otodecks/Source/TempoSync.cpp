@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    TempoSync.cpp
+    Created: 20 Oct 2026 4:32:55am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "TempoSync.h"
+
+namespace
+{
+    // critically damped with the proportional term
+    const double integralGain = 1.0 / (4.0 * TempoSync::responseSeconds * TempoSync::responseSeconds);
+}
+
+//==============================================================================
+void TempoSync::reset()
+{
+    integral = 0;
+    phaseErrorMs = 0;
+}
+
+double TempoSync::process(const DeckScheduler::Timeline& follower, const DeckScheduler::Timeline& leader,
+                          int64 sampleTime, int numSamples, double sampleRate)
+{
+    // the leader's tempo, in beats per second of output
+    const double leaderBeatsPerSecond = leader.getBeatsPerSample() * sampleRate;
+
+    // nearest beat either way, so it never drags a whole beat round
+    double error = follower.getBeatsAt(sampleTime) - leader.getBeatsAt(sampleTime);
+    error -= std::round(error);
+    phaseErrorMs = error / leaderBeatsPerSecond * 1000.0;
+
+    const double blockSeconds = numSamples / sampleRate;
+    const double limit = maxCorrection * leaderBeatsPerSecond;
+    double correction = -(error / responseSeconds + integral * integralGain);
+
+    // don't wind up while the correction is held at its limit
+    if (std::abs(correction) < limit)
+    {
+        integral += error * blockSeconds;
+    }
+    correction = jlimit(-limit, limit, correction);
+
+    // speed is track seconds per second, a beat of the follower is getSecondsPerBeat of its track
+    return (leaderBeatsPerSecond + correction) * follower.getSecondsPerBeat();
+}
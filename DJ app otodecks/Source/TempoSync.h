@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    TempoSync.h
+    Created: 20 Oct 2026 4:32:55am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DeckScheduler.h"
+
+//==============================================================================
+/*
+    Keeps a follower deck on the leader's beat. Every block it works out the
+    speed that matches the leader's tempo, then nudges it by the distance
+    between the two decks' beats (proportional) and by how long they have
+    been apart (integral), so a constant offset like the resampler's
+    read-ahead is taken out too. The nudge is limited so it is never heard
+    as a pitch change.
+
+    Audio thread only, apart from getPhaseErrorMs.
+*/
+class TempoSync
+{
+public:
+    void reset();
+
+    // the speed the follower should play the next numSamples at
+    double process(const DeckScheduler::Timeline& follower, const DeckScheduler::Timeline& leader,
+                   int64 sampleTime, int numSamples, double sampleRate);
+
+    // how far the follower's beat was from the leader's at the last block, + for ahead
+    double getPhaseErrorMs() const { return phaseErrorMs.load(); }
+
+    // the controller's time constant, and the most the speed is moved off the leader's tempo
+    static constexpr double responseSeconds = 1.0;
+    static constexpr double maxCorrection = 0.04;
+
+private:
+    // integral of the phase error in beat-seconds
+    double integral = 0;
+
+    std::atomic<double> phaseErrorMs{ 0 };
+};
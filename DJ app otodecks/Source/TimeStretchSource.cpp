@@ -0,0 +1,306 @@
+/*
+  ==============================================================================
+
+    TimeStretchSource.cpp
+    Created: 19 Oct 2026 6:21:54pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "TimeStretchSource.h"
+
+namespace
+{
+    int getOrderFor(int size)
+    {
+        int order = 0;
+        while ((1 << order) < size)
+        {
+            ++order;
+        }
+        return order;
+    }
+}
+
+//==============================================================================
+TimeStretchSource::TimeStretchSource(AudioSource* inputSource)
+    : input(inputSource)
+{
+}
+
+TimeStretchSource::~TimeStretchSource()
+{
+}
+
+void TimeStretchSource::setTempo(double newTempo)
+{
+    tempo = jlimit(0.0, maxTempo, newTempo);
+}
+
+void TimeStretchSource::setQuality(Quality newQuality)
+{
+    quality = (int) newQuality;
+}
+
+void TimeStretchSource::reset()
+{
+    resetPending = true;
+}
+
+//==============================================================================
+void TimeStretchSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    // the frame sizes are for 44.1/48kHz, scaled up so they stay the same length in time
+    const int scale = jlimit(1, 4, roundToInt(sampleRate / 44100.0));
+
+    settings[(int) Quality::high] = { 2048 * scale, 1024 * scale, 512 * scale, 0 };
+    settings[(int) Quality::eco] = { 1024 * scale, 512 * scale, 256 * scale, 0 };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        // room to correlate the frame tail against every offset without wrapping round
+        Settings& s = settings[i];
+        s.fftOrder = getOrderFor(2 * s.searchRange + 2 * s.hop);
+        ffts[i] = std::make_unique<dsp::FFT>(s.fftOrder);
+    }
+
+    // sized for the biggest settings, so switching quality never allocates
+    const Settings& largest = settings[(int) Quality::high];
+    const int largestFFTSize = 1 << largest.fftOrder;
+
+    inputBuffer.setSize(2, largest.frameSize + 2 * largest.searchRange + pullChunkSize);
+    accumulator.setSize(2, largest.frameSize);
+    outputBuffer.setSize(2, largest.hop);
+    window.allocate((size_t) largest.frameSize, true);
+    frameTail.allocate((size_t) largest.hop, true);
+    templateSpectrum.allocate((size_t) largestFFTSize * 2, true);
+    regionSpectrum.allocate((size_t) largestFFTSize * 2, true);
+    energies.allocate((size_t) (2 * largest.searchRange + largest.hop + 1), true);
+
+    appliedQuality = -1;
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void TimeStretchSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void TimeStretchSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+    const int newQuality = quality.load();
+    if (newQuality != appliedQuality)
+    {
+        applySettings((Quality) newQuality);
+    }
+    if (resetPending.exchange(false))
+    {
+        clearState();
+    }
+
+    const double currentTempo = tempo.load();
+    if (currentTempo < minTempo || fft == nullptr)
+    {
+        // stopped, and the input stays where it is
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    AudioBuffer<float>& buffer = *bufferToFill.buffer;
+    int done = 0;
+
+    while (done < bufferToFill.numSamples)
+    {
+        if (outputAvailable == 0)
+        {
+            processFrame(currentTempo);
+        }
+
+        const int numThisTime = jmin(bufferToFill.numSamples - done, outputAvailable);
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.copyFrom(channel, bufferToFill.startSample + done,
+                            outputBuffer, jmin(channel, 1), outputReadPosition, numThisTime);
+        }
+
+        outputReadPosition += numThisTime;
+        outputAvailable -= numThisTime;
+        done += numThisTime;
+    }
+}
+
+//==============================================================================
+void TimeStretchSource::applySettings(Quality newQuality)
+{
+    appliedQuality = (int) newQuality;
+    current = settings[appliedQuality];
+    fft = ffts[appliedQuality].get();
+
+    // periodic Hann, which sums to exactly one at 50% overlap
+    for (int i = 0; i < current.frameSize; ++i)
+    {
+        window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float) i / (float) current.frameSize);
+    }
+
+    clearState();
+}
+
+void TimeStretchSource::clearState()
+{
+    inputBuffer.clear();
+    accumulator.clear();
+    outputReadPosition = 0;
+    outputAvailable = 0;
+    samplesToSkip = 0;
+    hasPreviousFrame = false;
+
+    // start with searchRange of silence, so the first frame can sit at the very start of the input
+    inputStart = 0;
+    inputFill = current.searchRange;
+    analysisPosition = current.searchRange;
+}
+
+void TimeStretchSource::processFrame(double frameTempo)
+{
+    const int frameSize = current.frameSize;
+    const int hop = current.hop;
+    const int searchRange = current.searchRange;
+
+    // the frame may start anywhere from searchRange before the ideal position to searchRange after it
+    const int64 regionStart = (int64) std::llround(analysisPosition) - searchRange;
+    discardInputBefore(regionStart);
+    pullInput(regionStart + 2 * searchRange + frameSize);
+
+    const int regionIndex = (int) (regionStart - inputStart);
+    const int frameIndex = regionIndex + (hasPreviousFrame ? findBestOffset(regionIndex) : searchRange);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        FloatVectorOperations::addWithMultiply(accumulator.getWritePointer(channel),
+                                               inputBuffer.getReadPointer(channel, frameIndex),
+                                               window.getData(), frameSize);
+    }
+
+    // the next frame has to line up with how this one carries on
+    FloatVectorOperations::copyWithMultiply(frameTail.getData(), inputBuffer.getReadPointer(0, frameIndex + hop), 0.5f, hop);
+    FloatVectorOperations::addWithMultiply(frameTail.getData(), inputBuffer.getReadPointer(1, frameIndex + hop), 0.5f, hop);
+
+    // the first hop of the accumulator has had both its frames added now
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* data = accumulator.getWritePointer(channel);
+        outputBuffer.copyFrom(channel, 0, data, hop);
+        FloatVectorOperations::copy(data, data + hop, frameSize - hop);
+        FloatVectorOperations::clear(data + frameSize - hop, hop);
+    }
+
+    outputReadPosition = 0;
+    outputAvailable = hop;
+    analysisPosition += hop * frameTempo;
+    hasPreviousFrame = true;
+}
+
+int TimeStretchSource::findBestOffset(int regionIndex)
+{
+    const int hop = current.hop;
+    const int searchRange = current.searchRange;
+    const int regionLength = 2 * searchRange + hop;
+    const int fftSize = fft->getSize();
+
+    float* templateData = templateSpectrum.getData();
+    float* regionData = regionSpectrum.getData();
+
+    FloatVectorOperations::clear(templateData, fftSize * 2);
+    FloatVectorOperations::clear(regionData, fftSize * 2);
+    FloatVectorOperations::copy(templateData, frameTail.getData(), hop);
+    FloatVectorOperations::copyWithMultiply(regionData, inputBuffer.getReadPointer(0, regionIndex), 0.5f, regionLength);
+    FloatVectorOperations::addWithMultiply(regionData, inputBuffer.getReadPointer(1, regionIndex), 0.5f, regionLength);
+
+    // running energy of the region, to normalise each candidate's correlation
+    energies[0] = 0.0f;
+    for (int i = 0; i < regionLength; ++i)
+    {
+        energies[i + 1] = energies[i] + regionData[i] * regionData[i];
+    }
+
+    fft->performRealOnlyForwardTransform(templateData);
+    fft->performRealOnlyForwardTransform(regionData);
+
+    // conj(template) * region, which comes back as the correlation at every offset
+    for (int bin = 0; bin < fftSize; ++bin)
+    {
+        const float tr = templateData[bin * 2];
+        const float ti = templateData[bin * 2 + 1];
+        const float rr = regionData[bin * 2];
+        const float ri = regionData[bin * 2 + 1];
+        regionData[bin * 2] = tr * rr + ti * ri;
+        regionData[bin * 2 + 1] = tr * ri - ti * rr;
+    }
+
+    fft->performRealOnlyInverseTransform(regionData);
+
+    // no better match than the ideal position means no shift
+    auto score = [&] (int offset)
+    {
+        const float energy = energies[offset + hop] - energies[offset];
+        return regionData[offset] / std::sqrt(jmax(energy, 1.0e-6f));
+    };
+
+    int bestOffset = searchRange;
+    float bestScore = score(searchRange);
+    for (int offset = 0; offset <= 2 * searchRange; ++offset)
+    {
+        const float s = score(offset);
+        if (s > bestScore)
+        {
+            bestScore = s;
+            bestOffset = offset;
+        }
+    }
+    return bestOffset;
+}
+
+void TimeStretchSource::pullInput(int64 requiredEnd)
+{
+    // fast tempos can run past everything buffered, what's in between is read and dropped
+    while (samplesToSkip > 0)
+    {
+        const int numThisTime = (int) jmin(samplesToSkip, (int64) inputBuffer.getNumSamples());
+        AudioSourceChannelInfo info(&inputBuffer, 0, numThisTime);
+        input->getNextAudioBlock(info);
+        samplesToSkip -= numThisTime;
+    }
+
+    while (inputStart + inputFill < requiredEnd)
+    {
+        const int numThisTime = (int) jmin((int64) pullChunkSize, requiredEnd - (inputStart + inputFill));
+        AudioSourceChannelInfo info(&inputBuffer, inputFill, numThisTime);
+        input->getNextAudioBlock(info);
+        inputFill += numThisTime;
+    }
+}
+
+void TimeStretchSource::discardInputBefore(int64 keepFrom)
+{
+    const int64 inputEnd = inputStart + inputFill;
+    if (keepFrom >= inputEnd)
+    {
+        samplesToSkip += keepFrom - inputEnd;
+        inputStart = keepFrom;
+        inputFill = 0;
+        return;
+    }
+
+    const int numToDrop = (int) (keepFrom - inputStart);
+    if (numToDrop > 0)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            float* data = inputBuffer.getWritePointer(channel);
+            std::memmove(data, data + numToDrop, sizeof(float) * (size_t) (inputFill - numToDrop));
+        }
+        inputStart = keepFrom;
+        inputFill -= numToDrop;
+    }
+}
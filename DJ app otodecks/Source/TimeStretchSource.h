@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    TimeStretchSource.h
+    Created: 19 Oct 2026 6:21:54pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Changes the tempo of its input without changing the pitch (key lock), using
+    WSOLA: Hann-windowed frames are overlap-added at a fixed hop, and each one is
+    taken from near where the tempo says it should come from, at the offset that
+    lines up best with the frame before it. The best offset is found with an FFT
+    cross-correlation.
+
+    Everything is allocated in prepareToPlay. The aim is to stay under 2% of
+    one core per deck in high quality at 44.1/48kHz, and under half that in
+    eco, so four key-locked decks fit easily in a single core. That is a
+    target, not a measurement: check it on the machine in question with the
+    TimeStretchSource::getNextAudioBlock benchmark.
+*/
+class TimeStretchSource : public AudioSource
+{
+public:
+    enum class Quality
+    {
+        high, // 46ms frames, wide search: fewest artefacts
+        eco   // 23ms frames, narrow search: less CPU
+    };
+
+    TimeStretchSource(AudioSource* inputSource);
+    ~TimeStretchSource();
+
+    // playback speed with the pitch left alone, 1 is normal
+    void setTempo(double newTempo);
+    double getTempo() const { return tempo.load(); }
+
+    // takes effect at the start of the next block
+    void setQuality(Quality newQuality);
+    Quality getQuality() const { return (Quality) quality.load(); }
+
+    // forget everything buffered, at the start of the next block
+    void reset();
+
+    //==============================================================================
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+    // the range setTempo is held to. Below minTempo the output is silent
+    static constexpr double minTempo = 0.05;
+    static constexpr double maxTempo = 4.0;
+
+private:
+    struct Settings
+    {
+        int frameSize = 0;   // N, the length of a windowed frame
+        int hop = 0;         // output hop, N / 2
+        int searchRange = 0; // how far either side of the ideal position a frame may come from
+        int fftOrder = 0;
+    };
+
+    // audio thread
+    void applySettings(Quality newQuality);
+    void clearState();
+    void processFrame(double frameTempo);
+    int findBestOffset(int regionIndex);
+    void pullInput(int64 requiredEnd);
+    void discardInputBefore(int64 keepFrom);
+
+    AudioSource* input;
+
+    std::atomic<double> tempo{ 1.0 };
+    std::atomic<int> quality{ (int) Quality::high };
+    std::atomic<bool> resetPending{ false };
+
+    Settings settings[2];
+    std::unique_ptr<dsp::FFT> ffts[2];
+    Settings current;
+    dsp::FFT* fft = nullptr;
+    int appliedQuality = -1;
+
+    // input, addressed by absolute sample number from inputStart
+    AudioBuffer<float> inputBuffer;
+    int64 inputStart = 0;
+    int inputFill = 0;
+    int64 samplesToSkip = 0;
+
+    AudioBuffer<float> accumulator; // overlap-add of the frames so far
+    AudioBuffer<float> outputBuffer; // the finished hop being played out
+    int outputReadPosition = 0;
+    int outputAvailable = 0;
+
+    HeapBlock<float> window;
+    HeapBlock<float> frameTail;  // the end of the last frame, mono: what the next one should match
+    HeapBlock<float> templateSpectrum;
+    HeapBlock<float> regionSpectrum;
+    HeapBlock<float> energies;
+
+    double analysisPosition = 0;
+    bool hasPreviousFrame = false;
+
+    static constexpr int pullChunkSize = 512;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretchSource)
+};
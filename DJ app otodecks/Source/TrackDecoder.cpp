@@ -0,0 +1,631 @@
+/*
+  ==============================================================================
+
+    TrackDecoder.cpp
+    Created: 19 Oct 2026 4:40:07pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "TrackDecoder.h"
+#include "RealtimeLog.h"
+
+namespace
+{
+    // how much is decoded from a seek before going back to filling in from the start
+    const int seekWindowChunks = 4;
+
+    // frames decoded and thrown away before a seek, so the MP3 bit reservoir
+    // and overlap have settled by the first sample that is kept
+    const int prerollFrames = 10;
+
+    // how long opening a remote track may wait for its first few hundred kB
+    const int remoteOpenTimeoutMs = 15000;
+
+    // a remote decode whose bytes aren't in yet waits this long for them, then
+    // goes to the back of the queue
+    const int remoteWaitMs = 20;
+
+    // scaled and rounded, on the decoder's threads. The scale keeps the chunk's
+    // peak in range, the limit only catches rounding
+    void convertToInt16(const float* source, int16* dest, int numSamples, float scale)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float sample = jlimit(-32767.0f, 32767.0f, source[i] * scale);
+            dest[i] = (int16) (sample + (sample < 0.0f ? -0.5f : 0.5f));
+        }
+    }
+
+    // on the audio thread for every block, a plain loop the compiler vectorises
+    void convertToFloat(const int16* source, float* dest, int numSamples, float scale)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = (float) source[i] * scale;
+        }
+    }
+}
+
+//==============================================================================
+DecodedTrack::DecodedTrack(const URL& trackURL, double trackSampleRate, int trackChannels, int64 length,
+                           Storage storageToUse)
+    : url(trackURL),
+      sampleRate(trackSampleRate),
+      lengthInSamples(length),
+      numChannels(jlimit(1, 2, trackChannels)),
+      storage(storageToUse),
+      buffer(storage == Storage::float32 ? numChannels : 0, storage == Storage::float32 ? (int) length : 0),
+      compact(storage == Storage::int16 ? (size_t) (numChannels * length) : 0),
+      peaks(new WaveformPeaks(length)),
+      numChunks((int) ((length + chunkSize - 1) / chunkSize)),
+      chunkDecoded(new std::atomic<bool>[(size_t) numChunks]),
+      chunkScale(storage == Storage::int16 ? (size_t) numChunks : 0)
+{
+    for (int i = 0; i < numChunks; ++i)
+    {
+        chunkDecoded[i] = false;
+    }
+}
+
+double DecodedTrack::getLengthInSeconds() const
+{
+    return sampleRate > 0 ? lengthInSamples / sampleRate : 0.0;
+}
+
+size_t DecodedTrack::getMemoryUsage() const
+{
+    const size_t bytesPerSample = storage == Storage::int16 ? sizeof(int16) : sizeof(float);
+    return (size_t) numChannels * (size_t) lengthInSamples * bytesPerSample;
+}
+
+bool DecodedTrack::waitUntilDecoded(int timeoutMs)
+{
+    return decodedEvent.wait(timeoutMs);
+}
+
+bool DecodedTrack::isSampleDecoded(int64 sample) const
+{
+    return sample >= 0 && sample < lengthInSamples && isChunkDecoded((int) (sample / chunkSize));
+}
+
+void DecodedTrack::requestDecodeAt(int64 sample)
+{
+    if (sample >= 0 && sample < lengthInSamples)
+    {
+        requestedChunk = (int) (sample / chunkSize);
+    }
+}
+
+void DecodedTrack::read(AudioBuffer<float>& dest, int destStart, int64 startSample, int numSamples) const
+{
+    jassert(startSample >= 0);
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        const int64 position = startSample + done;
+        const int chunk = (int) (position / chunkSize);
+        const int numThisTime = (int) jmin((int64) (numSamples - done), (int64) (chunk + 1) * chunkSize - position);
+        const bool available = isSampleDecoded(position);
+
+        for (int channel = 0; channel < dest.getNumChannels(); ++channel)
+        {
+            if (available)
+            {
+                const int sourceChannel = jmin(channel, numChannels - 1);
+                const int numToCopy = (int) jmin((int64) numThisTime, lengthInSamples - position);
+                if (storage == Storage::int16)
+                {
+                    convertToFloat(compact + sourceChannel * lengthInSamples + position,
+                                   dest.getWritePointer(channel, destStart + done), numToCopy, chunkScale[chunk]);
+                }
+                else
+                {
+                    dest.copyFrom(channel, destStart + done, buffer, sourceChannel, (int) position, numToCopy);
+                }
+                dest.clear(channel, destStart + done + numToCopy, numThisTime - numToCopy);
+            }
+            else
+            {
+                dest.clear(channel, destStart + done, numThisTime);
+            }
+        }
+
+        // playback has got ahead of the decoder, most likely a seek
+        if (!available && position < lengthInSamples && requestedChunk.load() != chunk)
+        {
+            requestedChunk = chunk;
+        }
+
+        done += numThisTime;
+    }
+}
+
+void DecodedTrack::storeCompact(const AudioBuffer<float>& source, int64 trackStart, int numSamples)
+{
+    // a hot master goes over full scale, so a chunk that does is scaled down to fit
+    // instead of clipped. Anything at or below full scale keeps all 16 bits
+    float peak = 1.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        peak = jmax(peak, source.getMagnitude(jmin(channel, source.getNumChannels() - 1), 0, numSamples));
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        convertToInt16(source.getReadPointer(jmin(channel, source.getNumChannels() - 1)),
+                       compact + channel * lengthInSamples + trackStart, numSamples, toInt16 / peak);
+    }
+
+    // published with the chunk's flag
+    chunkScale[(int) (trackStart / chunkSize)] = peak * fromInt16;
+}
+
+void DecodedTrack::markChunkDecoded(int chunk)
+{
+    chunkDecoded[chunk] = true;
+
+    // the waveform is fed from the start, so only move on over an unbroken run
+    int64 decoded = numDecoded.load();
+    while (decoded < lengthInSamples && isChunkDecoded((int) (decoded / chunkSize)))
+    {
+        decoded = jmin(lengthInSamples, (decoded / chunkSize + 1) * chunkSize);
+    }
+    numDecoded = decoded;
+}
+
+//==============================================================================
+class TrackDecoder::DecodeJob : public ThreadPoolJob
+{
+public:
+    DecodeJob(DecodedTrack::Ptr trackToDecode,
+              std::unique_ptr<AudioFormatReader> readerToUse,
+              std::unique_ptr<SeekIndex> indexToUse,
+              AudioFormat* mp3FormatToUse,
+              RangeCache::Ptr cacheToUse)
+        : ThreadPoolJob("Track decode"),
+          track(trackToDecode),
+          reader(std::move(readerToUse)),
+          index(std::move(indexToUse)),
+          mp3Format(mp3FormatToUse),
+          cache(cacheToUse),
+          analyser(track->getSampleRate())
+    {
+    }
+
+    // one chunk, or one seek window, per turn. The job then goes to the back of
+    // the pool's queue, so a track that was opened later, or a seek on one, is
+    // never stuck behind whole tracks decoding in the background
+    JobStatus runJob() override
+    {
+        if (shouldExit())
+        {
+            return finish();
+        }
+
+        // playback wants something further on, that goes first
+        const int requested = track->requestedChunk.exchange(-1);
+        if (requested >= 0 && !track->isChunkDecoded(requested))
+        {
+            if (!isSourceCached(requested, seekWindowChunks))
+            {
+                // still wanted once the bytes are in, unless playback has moved on meanwhile
+                int none = -1;
+                track->requestedChunk.compare_exchange_strong(none, requested);
+                return waitForSource();
+            }
+
+            decodeFrom(requested);
+            return jobNeedsRunningAgain;
+        }
+
+        while (nextChunk < track->numChunks && track->isChunkDecoded(nextChunk))
+        {
+            ++nextChunk;
+        }
+        if (nextChunk >= track->numChunks)
+        {
+            return finish();
+        }
+
+        if (!isSourceCached(nextChunk, 1))
+        {
+            return waitForSource();
+        }
+
+        decodeChunk(*reader, nextChunk, 0);
+        return jobNeedsRunningAgain;
+    }
+
+private:
+    // a remote track is only read once the cache has the bytes, so a pool thread
+    // never sits waiting on the network. Where those bytes are is worked out from
+    // how far into the track the chunks are, with a cache chunk either side to spare
+    bool isSourceCached(int firstChunk, int numChunks)
+    {
+        if (cache == nullptr || cache->hasFailed())
+        {
+            return true;
+        }
+
+        const int64 totalBytes = cache->getTotalLength();
+        const double bytesPerSample = (double) totalBytes / (double) track->lengthInSamples;
+        const int64 startSample = (int64) firstChunk * DecodedTrack::chunkSize;
+        const int64 endSample = jmin(track->lengthInSamples, (int64) (firstChunk + numChunks) * DecodedTrack::chunkSize);
+
+        const int64 startByte = jmax((int64) 0, (int64) (startSample * bytesPerSample) - RangeCache::chunkSize);
+        const int64 endByte = jmin(totalBytes, (int64) (endSample * bytesPerSample) + RangeCache::chunkSize);
+        return cache->isCached(startByte, endByte - startByte);
+    }
+
+    JobStatus waitForSource()
+    {
+        cache->waitForChunks(remoteWaitMs);
+        return jobNeedsRunningAgain;
+    }
+
+    JobStatus finish()
+    {
+        // done with the file, the track lives on in memory
+        reader.reset();
+        cache = nullptr;
+        track->finished = true;
+        track->decodedEvent.signal();
+        return jobHasFinished;
+    }
+
+    // source's first sample is sourceStart samples into the track
+    void decodeChunk(AudioFormatReader& source, int chunk, int64 sourceStart)
+    {
+        const int64 start = (int64) chunk * DecodedTrack::chunkSize;
+        const int numSamples = (int) jmin((int64) DecodedTrack::chunkSize, track->lengthInSamples - start);
+        const bool stereo = track->numChannels > 1;
+
+        if (track->storage == DecodedTrack::Storage::int16)
+        {
+            // decoded a chunk at a time as floats, then packed down
+            scratch.setSize(track->numChannels, DecodedTrack::chunkSize, false, false, true);
+            source.read(&scratch, 0, numSamples, start - sourceStart, true, stereo);
+            analyser.process(scratch, 0, start, numSamples, *track->peaks);
+            track->storeCompact(scratch, start, numSamples);
+        }
+        else
+        {
+            source.read(&track->buffer, (int) start, numSamples, start - sourceStart, true, stereo);
+            analyser.process(track->buffer, (int) start, start, numSamples, *track->peaks);
+        }
+        track->markChunkDecoded(chunk);
+    }
+
+    void decodeFrom(int firstChunk)
+    {
+        std::unique_ptr<AudioFormatReader> seekReader;
+        int64 sourceStart = 0;
+
+        if (index != nullptr)
+        {
+            // open the file again right at the frame, instead of the MP3 reader
+            // scanning its way there frame header by frame header
+            const int frame = jmax(0, index->getFrameForSample((int64) firstChunk * DecodedTrack::chunkSize) - prerollFrames);
+            auto* stream = new SubregionStream(new FileInputStream(track->url.getLocalFile()),
+                                               index->getFrameOffset(frame), -1, true);
+            seekReader.reset(mp3Format->createReaderFor(stream, true));
+            sourceStart = index->getFrameStartSample(frame);
+            if (seekReader != nullptr)
+            {
+                seekReader->lengthInSamples = index->getLengthInSamples() - sourceStart;
+            }
+        }
+
+        // anything else seeks quickly enough on its own
+        AudioFormatReader& source = seekReader != nullptr ? *seekReader : *reader;
+        if (seekReader == nullptr)
+        {
+            sourceStart = 0;
+        }
+
+        const int lastChunk = jmin(track->numChunks, firstChunk + seekWindowChunks);
+        for (int chunk = firstChunk; chunk < lastChunk && !track->isChunkDecoded(chunk) && !shouldExit(); ++chunk)
+        {
+            decodeChunk(source, chunk, sourceStart);
+        }
+    }
+
+    DecodedTrack::Ptr track;
+    std::unique_ptr<AudioFormatReader> reader;
+    std::unique_ptr<SeekIndex> index;
+    AudioFormat* mp3Format;
+    RangeCache::Ptr cache;
+    WaveformPeaks::Analyser analyser;
+    AudioBuffer<float> scratch;
+    int nextChunk = 0;
+};
+
+//==============================================================================
+class TrackDecoder::ConnectJob : public ThreadPoolJob
+{
+public:
+    ConnectJob(TrackDecoder& decoderToUse, const URL& urlToOpen)
+        : ThreadPoolJob("Track connect"),
+          decoder(decoderToUse),
+          weakDecoder(&decoderToUse),
+          url(urlToOpen)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // connecting and the first buffer can take seconds, nothing else waits on it
+        DecodedTrack::Ptr track;
+        if (RangeCache::Ptr cache = RangeCache::open(url, remoteOpenTimeoutMs))
+        {
+            track = decoder.createTrack(url, cache->createInputStream(), cache);
+        }
+
+        WeakReference<TrackDecoder> owner(weakDecoder);
+        const URL opened(url);
+        MessageManager::callAsync([owner, opened, track]
+        {
+            if (auto* d = owner.get())
+            {
+                d->remoteTrackOpened(opened, track);
+            }
+        });
+        return jobHasFinished;
+    }
+
+private:
+    TrackDecoder& decoder;
+
+    // made on the message thread, the job only copies it
+    WeakReference<TrackDecoder> weakDecoder;
+    URL url;
+};
+
+//==============================================================================
+TrackDecoder::TrackDecoder(AudioFormatManager& formatManagerToUse)
+    : formatManager(formatManagerToUse)
+{
+}
+
+TrackDecoder::~TrackDecoder()
+{
+    connectPool.removeAllJobs(true, remoteOpenTimeoutMs);
+    pool.removeAllJobs(true, 5000);
+}
+
+DecodedTrack::Ptr TrackDecoder::findOpenTrack(const URL& url)
+{
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        if (tracks[i]->getURL().toString(false) == url.toString(false))
+        {
+            // most recently used goes to the end
+            DecodedTrack::Ptr track = tracks[i];
+            tracks.remove(i);
+            tracks.add(track);
+            return track;
+        }
+    }
+    return nullptr;
+}
+
+DecodedTrack::Ptr TrackDecoder::open(const URL& url)
+{
+    {
+        const ScopedLock sl(lock);
+        if (DecodedTrack::Ptr track = findOpenTrack(url))
+        {
+            return track;
+        }
+    }
+
+    if (!url.isLocalFile())
+    {
+        openAsync(url, nullptr);
+        return nullptr;
+    }
+    return createTrack(url, url.createInputStream(false), nullptr);
+}
+
+void TrackDecoder::openAsync(const URL& url, std::function<void(DecodedTrack::Ptr)> onOpened)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    bool isOpen = url.isLocalFile();
+    if (!isOpen)
+    {
+        const ScopedLock sl(lock);
+        isOpen = findOpenTrack(url) != nullptr;
+    }
+    if (isOpen)
+    {
+        DecodedTrack::Ptr track = open(url);
+        if (onOpened != nullptr)
+        {
+            onOpened(track);
+        }
+        return;
+    }
+
+    // a remote file is read through a cache on disk that fills in the background,
+    // so the decoder never waits on the network for more than the part it needs
+    for (auto& pending : pendingOpens)
+    {
+        if (pending.url.toString(false) == url.toString(false))
+        {
+            if (onOpened != nullptr)
+            {
+                pending.callbacks.push_back(std::move(onOpened));
+            }
+            return;
+        }
+    }
+
+    PendingOpen pending{ url, {} };
+    if (onOpened != nullptr)
+    {
+        pending.callbacks.push_back(std::move(onOpened));
+    }
+    pendingOpens.push_back(std::move(pending));
+    connectPool.addJob(new ConnectJob(*this, url), true);
+}
+
+void TrackDecoder::remoteTrackOpened(const URL& url, DecodedTrack::Ptr track)
+{
+    for (auto it = pendingOpens.begin(); it != pendingOpens.end(); ++it)
+    {
+        if (it->url.toString(false) == url.toString(false))
+        {
+            auto callbacks = std::move(it->callbacks);
+            pendingOpens.erase(it);
+
+            for (auto& callback : callbacks)
+            {
+                callback(track);
+            }
+            return;
+        }
+    }
+}
+
+DecodedTrack::Ptr TrackDecoder::createTrack(const URL& url, std::unique_ptr<InputStream> stream,
+                                            RangeCache::Ptr cache)
+{
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(std::move(stream)));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+    {
+        RealtimeLog::write(RealtimeLog::warning, "TrackDecoder::open could not read %s", url.toString(false).toRawUTF8());
+        return nullptr;
+    }
+
+    // an MP3 reader only estimates the length, the index knows it. The track is
+    // sized from it, so the first load of an MP3 builds it now: a walk over the
+    // frame headers, much quicker than the decode that follows
+    std::unique_ptr<SeekIndex> index;
+    AudioFormat* mp3Format = nullptr;
+    if (url.isLocalFile() && SeekIndex::canIndex(url.getLocalFile()))
+    {
+        index = SeekIndex::getFor(url.getLocalFile());
+        mp3Format = formatManager.findFormatForFileExtension("mp3");
+    }
+    const int64 length = index != nullptr ? index->getLengthInSamples() : reader->lengthInSamples;
+
+    // AudioFormatReader::read stops at the reader's own length, which is the estimate
+    reader->lengthInSamples = length;
+
+    const ScopedLock sl(lock);
+
+    // someone else may have opened it while the header was being read
+    if (DecodedTrack::Ptr track = findOpenTrack(url))
+    {
+        return track;
+    }
+
+    const auto storage = compactStorage.load() ? DecodedTrack::Storage::int16 : DecodedTrack::Storage::float32;
+    DecodedTrack::Ptr track = new DecodedTrack(url, reader->sampleRate, (int) reader->numChannels, length, storage);
+    tracks.add(track);
+    purgeUnusedTracks();
+
+    ++numFilesDecoded;
+
+    // a remote track is decoded alongside the connects, local ones never queue behind it
+    ThreadPool& decodePool = cache != nullptr ? connectPool : pool;
+    decodePool.addJob(new DecodeJob(track, std::move(reader), std::move(index), mp3Format, cache), true);
+    return track;
+}
+
+DecodedTrack::Ptr TrackDecoder::getOpenTrack(const URL& url)
+{
+    const ScopedLock sl(lock);
+    for (DecodedTrack* track : tracks)
+    {
+        if (track->getURL().toString(false) == url.toString(false))
+        {
+            return track;
+        }
+    }
+    return nullptr;
+}
+
+bool TrackDecoder::getInfo(const URL& url, TrackInfo& info)
+{
+    {
+        const ScopedLock sl(lock);
+        for (DecodedTrack* track : tracks)
+        {
+            if (track->getURL().toString(false) == url.toString(false))
+            {
+                info.lengthInSeconds = track->getLengthInSeconds();
+                info.sampleRate = track->getSampleRate();
+                info.numChannels = track->getNumChannels();
+                return true;
+            }
+        }
+    }
+
+    // an MP3 that has been loaded before has its exact length in the index
+    if (url.isLocalFile())
+    {
+        if (auto index = SeekIndex::getCachedFor(url.getLocalFile()))
+        {
+            info.lengthInSeconds = index->getLengthInSamples() / index->getSampleRate();
+            info.sampleRate = index->getSampleRate();
+            info.numChannels = index->getNumChannels();
+            return true;
+        }
+    }
+
+    // not open, the header is enough
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(url.createInputStream(false)));
+    if (reader == nullptr || reader->sampleRate <= 0)
+    {
+        return false;
+    }
+
+    info.lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+    info.sampleRate = reader->sampleRate;
+    info.numChannels = (int) reader->numChannels;
+    return true;
+}
+
+void TrackDecoder::setCompactStorage(bool shouldBeCompact)
+{
+    compactStorage = shouldBeCompact;
+}
+
+bool TrackDecoder::isCompactStorage() const
+{
+    return compactStorage.load();
+}
+
+void TrackDecoder::purgeUnusedTracks()
+{
+    // the same memory holds twice as many 16 bit tracks
+    const int maxUnused = compactStorage.load() ? maxUnusedTracks * 2 : maxUnusedTracks;
+
+    // the array's own reference is the only one left on an unused track
+    int numUnused = 0;
+    for (DecodedTrack* track : tracks)
+    {
+        if (track->getReferenceCount() == 1)
+        {
+            ++numUnused;
+        }
+    }
+
+    for (int i = 0; i < tracks.size() && numUnused > maxUnused;)
+    {
+        if (tracks[i]->getReferenceCount() == 1)
+        {
+            tracks.remove(i);
+            --numUnused;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    TrackDecoder.h
+    Created: 19 Oct 2026 4:40:07pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SeekIndex.h"
+#include "RangeCache.h"
+#include "WaveformPeaks.h"
+
+//==============================================================================
+/*
+    A track decoded into memory. It is filled from the start on the decoder's
+    background threads, and whatever has been decoded so far can be read while
+    the rest is still on its way. Reading a part that isn't there yet asks the
+    decoder to jump ahead to it.
+
+    Samples are kept as floats, or as 16 bit integers for half the memory,
+    which are turned back into floats as they are read. Each chunk of 16 bit
+    samples has its own scale, so peaks over full scale survive.
+*/
+class DecodedTrack : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<DecodedTrack>;
+
+    enum class Storage
+    {
+        float32,
+        int16
+    };
+
+    const URL& getURL() const { return url; }
+    double getSampleRate() const { return sampleRate; }
+    int64 getLengthInSamples() const { return lengthInSamples; }
+    double getLengthInSeconds() const;
+    int getNumChannels() const { return numChannels; }
+    Storage getStorage() const { return storage; }
+
+    // bytes taken by the audio
+    size_t getMemoryUsage() const;
+
+    // samples from the start up to here can be read
+    int64 getNumSamplesDecoded() const { return numDecoded.load(); }
+    bool isFullyDecoded() const { return finished.load(); }
+
+    // whether this one sample can be read yet, which may be after a gap
+    bool isSampleDecoded(int64 sample) const;
+
+    // decode from here next, e.g. because playback just jumped there. Lock-free
+    void requestDecodeAt(int64 sample);
+
+    // the track is decoded in chunks of this many samples
+    static constexpr int chunkSize = 65536;
+
+    // blocks until the whole track is in memory, false if it timed out
+    bool waitUntilDecoded(int timeoutMs);
+
+    // copy part of the track into dest, anything not decoded yet comes back silent
+    // and is asked for. Safe to call from the audio thread
+    void read(AudioBuffer<float>& dest, int destStart, int64 startSample, int numSamples) const;
+
+    // a single sample, for readers that interpolate. Only valid where
+    // isSampleDecoded() is true
+    float getSample(int channel, int64 index) const
+    {
+        return storage == Storage::int16
+                   ? (float) compact[channel * lengthInSamples + index] * chunkScale[(int) (index / chunkSize)]
+                   : buffer.getReadPointer(channel)[index];
+    }
+
+    // the coloured overview, worked out as the track is decoded. Outlives the
+    // track for anyone who only needs the picture
+    WaveformPeaks::Ptr getPeaks() const { return peaks; }
+
+private:
+    friend class TrackDecoder;
+
+    DecodedTrack(const URL& trackURL, double trackSampleRate, int numChannels, int64 length, Storage storageToUse);
+
+    bool isChunkDecoded(int chunk) const { return chunkDecoded[chunk].load(); }
+
+    // decoder thread only
+    void markChunkDecoded(int chunk);
+
+    // decoder thread, for int16 storage: numSamples of source from its start
+    // go in at trackStart
+    void storeCompact(const AudioBuffer<float>& source, int64 trackStart, int numSamples);
+
+    static constexpr float toInt16 = 32767.0f;
+    static constexpr float fromInt16 = 1.0f / 32767.0f;
+
+    URL url;
+    double sampleRate;
+    int64 lengthInSamples;
+    int numChannels;
+    Storage storage;
+
+    // one or the other, by storage. The int16 channels follow each other
+    AudioBuffer<float> buffer;
+    HeapBlock<int16> compact;
+    WaveformPeaks::Ptr peaks;
+
+    int numChunks;
+    std::unique_ptr<std::atomic<bool>[]> chunkDecoded;
+
+    // int16 storage: what each chunk's samples are multiplied by to get floats back
+    HeapBlock<float> chunkScale;
+    mutable std::atomic<int> requestedChunk{ -1 };
+    std::atomic<int64> numDecoded{ 0 };
+    std::atomic<bool> finished{ false };
+    WaitableEvent decodedEvent{ true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrack)
+};
+
+//==============================================================================
+// what the playlist needs to know about a file without playing it
+struct TrackInfo
+{
+    double lengthInSeconds = 0;
+    double sampleRate = 0;
+    int numChannels = 0;
+};
+
+//==============================================================================
+/*
+    Opens tracks for the whole app. Each file is read and decoded once, and the
+    same DecodedTrack is handed to everything that asks for it: the deck plays
+    from it, the waveform shows the peaks worked out while decoding it and the
+    playlist takes the length from it.
+
+    MP3s get a SeekIndex the first time they are loaded, which gives their
+    exact length and lets the decoder start at any frame straight away.
+    Remote URLs are streamed through a RangeCache.
+*/
+class TrackDecoder
+{
+public:
+    TrackDecoder(AudioFormatManager& formatManagerToUse);
+    ~TrackDecoder();
+
+    // reads the header straight away and decodes the rest in the background.
+    // Returns the track that is already open if there is one, nullptr if the
+    // file can't be read. A remote URL that isn't open yet comes back nullptr
+    // too, it starts connecting and openAsync says when it is in
+    DecodedTrack::Ptr open(const URL& url);
+
+    // the same without ever waiting on the network. A remote track connects and
+    // buffers its first few hundred kB on a background thread, and onOpened is
+    // called on the message thread once it is in (nullptr if it can't be read).
+    // Anything else calls straight back. Message thread only
+    void openAsync(const URL& url, std::function<void(DecodedTrack::Ptr)> onOpened);
+
+    // the track if it is open already. Never opens or reads anything
+    DecodedTrack::Ptr getOpenTrack(const URL& url);
+
+    // the length and format of a file, from the open track or the seek index if
+    // there is one, or the file's header otherwise
+    bool getInfo(const URL& url, TrackInfo& info);
+
+    AudioFormatManager& getFormatManager() { return formatManager; }
+
+    // keep tracks opened from now on as 16 bit, so twice as many fit in memory
+    // and twice as many unused ones are held on to for quick reloads
+    void setCompactStorage(bool shouldBeCompact);
+    bool isCompactStorage() const;
+
+    // how many times a file has been opened for decoding, for the benchmarks
+    int getNumFilesDecoded() const { return numFilesDecoded.load(); }
+
+private:
+    class DecodeJob;
+    class ConnectJob;
+
+    // with the lock held: the open track for this URL, moved to the most recently used end
+    DecodedTrack::Ptr findOpenTrack(const URL& url);
+
+    // reads the header from stream and starts decoding. Takes the lock only to add
+    // the track. cache is the one a remote stream reads through, nullptr for a local file
+    DecodedTrack::Ptr createTrack(const URL& url, std::unique_ptr<InputStream> stream, RangeCache::Ptr cache);
+
+    // message thread, once a ConnectJob is done
+    void remoteTrackOpened(const URL& url, DecodedTrack::Ptr track);
+
+    // forget the oldest tracks nobody is using, keeping a couple for quick reloads
+    void purgeUnusedTracks();
+
+    AudioFormatManager& formatManager;
+    // jobs take turns a chunk at a time, so a newly opened track starts decoding straight away
+    ThreadPool pool{ 2 };
+
+    // remote tracks connect and decode here, never on the message thread or
+    // holding up a local decode
+    ThreadPool connectPool{ 2 };
+
+    // message thread: remote tracks still connecting, and who wants each one
+    struct PendingOpen
+    {
+        URL url;
+        std::vector<std::function<void(DecodedTrack::Ptr)>> callbacks;
+    };
+    std::vector<PendingOpen> pendingOpens;
+
+    CriticalSection lock;
+    ReferenceCountedArray<DecodedTrack> tracks;
+    std::atomic<int> numFilesDecoded{ 0 };
+    std::atomic<bool> compactStorage{ false };
+
+    static constexpr int maxUnusedTracks = 2;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(TrackDecoder)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackDecoder)
+};
@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+
+    TrackOverviews.cpp
+    Created: 20 Oct 2026 12:46:31am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "TrackOverviews.h"
+
+namespace
+{
+    // how much is decoded between checks that the row is still on screen
+    const int readChunkSize = 65536;
+}
+
+//==============================================================================
+TrackOverviews::TrackOverviews(TrackDecoder& decoderToUse)
+    : Thread("Track overviews"),
+      decoder(decoderToUse)
+{
+    // behind decoding and the GUI
+   #if JUCE_MAJOR_VERSION >= 7
+    startThread(Thread::Priority::background);
+   #else
+    startThread(1);
+   #endif
+}
+
+TrackOverviews::~TrackOverviews()
+{
+    cancelPendingUpdate();
+    stopThread(4000);
+}
+
+const TrackOverviews::Overview* TrackOverviews::getOverview(const URL& url)
+{
+    const String key = url.toString(false);
+
+    if (overviews.contains(key))
+    {
+        Entry& entry = overviews.getReference(key);
+        entry.lastUsed = ++useCounter;
+        return &entry.overview;
+    }
+
+    {
+        const ScopedLock sl(lock);
+        if (wanted.contains(key))
+        {
+            return nullptr;
+        }
+        for (const auto& result : finished)
+        {
+            if (result.first == key)
+            {
+                return nullptr;
+            }
+        }
+        wanted.add(key);
+    }
+    notify();
+    return nullptr;
+}
+
+void TrackOverviews::keepOnly(const StringArray& urls)
+{
+    const ScopedLock sl(lock);
+    for (int i = wanted.size(); --i >= 0;)
+    {
+        if (!urls.contains(wanted[i]))
+        {
+            wanted.remove(i);
+        }
+    }
+}
+
+void TrackOverviews::draw(Graphics& g, const Overview& overview, Rectangle<float> area)
+{
+    if (overview.isEmpty())
+    {
+        return;
+    }
+
+    const float columnWidth = area.getWidth() / overview.size();
+    const float centre = area.getCentreY();
+    const float halfHeight = area.getHeight() * 0.5f;
+
+    for (int i = 0; i < overview.size(); ++i)
+    {
+        const WaveformPeaks::Block& block = overview.getReference(i);
+        const float top = centre - jlimit(0.0f, 1.0f, block.maximum) * halfHeight;
+        const float bottom = centre - jlimit(-1.0f, 0.0f, block.minimum) * halfHeight;
+
+        g.setColour(WaveformPeaks::getColour(block.low, block.mid, block.high));
+        g.fillRect(area.getX() + i * columnWidth, top, jmax(1.0f, columnWidth), jmax(1.0f, bottom - top));
+    }
+}
+
+//==============================================================================
+void TrackOverviews::run()
+{
+    while (!threadShouldExit())
+    {
+        String key;
+        {
+            // oldest request first, it stays queued while it's being worked on
+            const ScopedLock sl(lock);
+            key = wanted[0];
+        }
+
+        if (key.isEmpty())
+        {
+            wait(-1);
+            continue;
+        }
+
+        Overview overview;
+        const bool finishedIt = generate(key, overview);
+
+        {
+            const ScopedLock sl(lock);
+            wanted.removeString(key);
+            if (finishedIt)
+            {
+                finished.add({ key, overview });
+            }
+        }
+
+        if (finishedIt)
+        {
+            triggerAsyncUpdate();
+        }
+    }
+}
+
+bool TrackOverviews::generate(const String& key, Overview& result)
+{
+    // on a deck or in the decoder's cache, its peaks are being worked out already
+    if (DecodedTrack::Ptr track = decoder.getOpenTrack(URL(key)))
+    {
+        while (!track->waitUntilDecoded(50))
+        {
+            if (threadShouldExit() || !isWanted(key))
+            {
+                return false;
+            }
+        }
+        summarise(*track->getPeaks(), result);
+        return true;
+    }
+
+    // an unreadable file finishes with an empty overview, so it isn't asked for again
+    std::unique_ptr<AudioFormatReader> reader(decoder.getFormatManager().createReaderFor(URL(key).getLocalFile()));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+    {
+        return true;
+    }
+
+    const int64 length = reader->lengthInSamples;
+    WaveformPeaks peaks(length);
+    WaveformPeaks::Analyser analyser(reader->sampleRate);
+    AudioBuffer<float> buffer(jlimit(1, 2, (int) reader->numChannels), readChunkSize);
+
+    for (int64 position = 0; position < length; position += readChunkSize)
+    {
+        if (threadShouldExit() || !isWanted(key))
+        {
+            return false;
+        }
+
+        const int numSamples = (int) jmin((int64) readChunkSize, length - position);
+        reader->read(&buffer, 0, numSamples, position, true, buffer.getNumChannels() > 1);
+        analyser.process(buffer, 0, position, numSamples, peaks);
+    }
+
+    summarise(peaks, result);
+    return true;
+}
+
+void TrackOverviews::summarise(const WaveformPeaks& peaks, Overview& result)
+{
+    const int numBlocks = peaks.getNumBlocks();
+    result.ensureStorageAllocated(numColumns);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const int first = column * numBlocks / numColumns;
+        const int last = jmax(first + 1, (column + 1) * numBlocks / numColumns);
+
+        WaveformPeaks::Block summary{ 0.0f, 0.0f, 0, 0, 0 };
+        float low = 0, mid = 0, high = 0;
+        int count = 0;
+
+        for (int i = first; i < last && i < numBlocks; ++i)
+        {
+            const WaveformPeaks::Block& block = peaks.getBlock(i);
+            summary.minimum = jmin(summary.minimum, block.minimum);
+            summary.maximum = jmax(summary.maximum, block.maximum);
+            low += block.low;
+            mid += block.mid;
+            high += block.high;
+            ++count;
+        }
+
+        if (count > 0)
+        {
+            summary.low = (uint8) roundToInt(low / count);
+            summary.mid = (uint8) roundToInt(mid / count);
+            summary.high = (uint8) roundToInt(high / count);
+        }
+        result.add(summary);
+    }
+}
+
+bool TrackOverviews::isWanted(const String& key) const
+{
+    const ScopedLock sl(lock);
+    return wanted.contains(key);
+}
+
+void TrackOverviews::handleAsyncUpdate()
+{
+    Array<std::pair<String, Overview>> results;
+    {
+        const ScopedLock sl(lock);
+        results.swapWith(finished);
+    }
+
+    for (const auto& result : results)
+    {
+        overviews.set(result.first, { result.second, ++useCounter });
+    }
+
+    if (overviews.size() > maxOverviews)
+    {
+        purgeOverviews();
+    }
+
+    sendChangeMessage();
+}
+
+void TrackOverviews::purgeOverviews()
+{
+    Array<uint32> stamps;
+    for (HashMap<String, Entry>::Iterator it(overviews); it.next();)
+    {
+        stamps.add(it.getValue().lastUsed);
+    }
+    stamps.sort();
+    const uint32 cutoff = stamps[stamps.size() / 2];
+
+    StringArray oldest;
+    for (HashMap<String, Entry>::Iterator it(overviews); it.next();)
+    {
+        if (it.getValue().lastUsed < cutoff)
+        {
+            oldest.add(it.getKey());
+        }
+    }
+
+    for (const String& key : oldest)
+    {
+        overviews.remove(key);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    TrackOverviews.h
+    Created: 20 Oct 2026 12:46:31am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformPeaks.h"
+#include "TrackDecoder.h"
+
+//==============================================================================
+/*
+    Small coloured waveforms for the playlist rows. They are worked out on a
+    low priority thread, only for tracks that have been asked for, and a
+    request is dropped if its row scrolls away before it gets its turn.
+    A track the decoder already has open gives its own peaks instead of
+    being read again. Finished ones are kept for quick redraws, up to
+    maxOverviews of them.
+*/
+class TrackOverviews : public ChangeBroadcaster,
+                       private Thread,
+                       private AsyncUpdater
+{
+public:
+    using Overview = Array<WaveformPeaks::Block>;
+
+    TrackOverviews(TrackDecoder& decoderToUse);
+    ~TrackOverviews() override;
+
+    // the overview if it's ready, otherwise it is queued and nullptr comes back.
+    // Message thread
+    const Overview* getOverview(const URL& url);
+
+    // drop anything queued that isn't one of these, e.g. the rows on screen
+    void keepOnly(const StringArray& urls);
+
+    static void draw(Graphics& g, const Overview& overview, Rectangle<float> area);
+
+    static constexpr int numColumns = 96;
+    static constexpr int maxOverviews = 4000;
+
+private:
+    struct Entry
+    {
+        Overview overview;
+        uint32 lastUsed;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    // false if it was given up on because nobody wants it any more
+    bool generate(const String& key, Overview& result);
+    bool isWanted(const String& key) const;
+
+    // squeezed into numColumns
+    static void summarise(const WaveformPeaks& peaks, Overview& result);
+
+    // forget the least recently drawn half
+    void purgeOverviews();
+
+    TrackDecoder& decoder;
+
+    // guards wanted and finished. Both count as asked for, so a result on its
+    // way to the message thread isn't queued again
+    CriticalSection lock;
+    StringArray wanted;
+    Array<std::pair<String, Overview>> finished;
+
+    // message thread only
+    HashMap<String, Entry> overviews;
+    uint32 useCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackOverviews)
+};
@@ -0,0 +1,634 @@
+/*
+  ==============================================================================
+
+    VirtualAudioDevice.cpp
+    Created: 20 Oct 2026 10:02:37am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "VirtualAudioDevice.h"
+#include "RealtimeLog.h"
+
+namespace
+{
+    Array<var> toVarArray(const Array<double>& values)
+    {
+        Array<var> list;
+        for (double value : values)
+        {
+            list.add(value);
+        }
+        return list;
+    }
+}
+
+//==============================================================================
+var VirtualAudioDevice::Report::toJSON() const
+{
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("blocks", blocks);
+    object->setProperty("period_ms", periodMs);
+    object->setProperty("average_callback_ms", averageCallbackMs);
+    object->setProperty("worst_callback_ms", worstCallbackMs);
+    object->setProperty("missed_deadlines", missedDeadlines);
+    object->setProperty("clicks", clicks);
+    object->setProperty("silence_gaps", silenceGaps);
+    object->setProperty("missed_deadline_seconds", toVarArray(missedDeadlineSeconds));
+    object->setProperty("click_seconds", toVarArray(clickSeconds));
+    object->setProperty("silence_gap_seconds", toVarArray(silenceGapSeconds));
+    return var(object.get());
+}
+
+//==============================================================================
+VirtualAudioDevice::VirtualAudioDevice(const String& name, const Settings& settingsToUse)
+    : AudioIODevice(name, VirtualAudioDeviceType::typeName),
+      Thread("Virtual audio device"),
+      settings(settingsToUse),
+      sampleRate(settingsToUse.sampleRate),
+      bufferSize(settingsToUse.bufferSize)
+{
+}
+
+VirtualAudioDevice::~VirtualAudioDevice()
+{
+    close();
+}
+
+StringArray VirtualAudioDevice::getOutputChannelNames()
+{
+    StringArray names;
+    for (int channel = 0; channel < settings.numOutputChannels; ++channel)
+    {
+        names.add("Out " + String(channel + 1));
+    }
+    return names;
+}
+
+StringArray VirtualAudioDevice::getInputChannelNames()
+{
+    StringArray names;
+    for (int channel = 0; channel < settings.numInputChannels; ++channel)
+    {
+        names.add("In " + String(channel + 1));
+    }
+    return names;
+}
+
+Array<double> VirtualAudioDevice::getAvailableSampleRates()
+{
+    Array<double> rates{ 44100.0, 48000.0, 88200.0, 96000.0 };
+    rates.addIfNotAlreadyThere(settings.sampleRate);
+    rates.sort();
+    return rates;
+}
+
+Array<int> VirtualAudioDevice::getAvailableBufferSizes()
+{
+    Array<int> sizes{ 32, 64, 128, 256, 512, 1024, 2048 };
+    sizes.addIfNotAlreadyThere(settings.bufferSize);
+    sizes.sort();
+    return sizes;
+}
+
+int VirtualAudioDevice::getDefaultBufferSize()
+{
+    return settings.bufferSize;
+}
+
+String VirtualAudioDevice::open(const BigInteger& inputChannels, const BigInteger& outputChannels,
+                                double newSampleRate, int bufferSizeSamples)
+{
+    close();
+
+    sampleRate = newSampleRate > 0 ? newSampleRate : settings.sampleRate;
+    bufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : settings.bufferSize;
+
+    // whichever of the asked for channels the device has
+    activeInputs = inputChannels;
+    activeInputs.setRange(settings.numInputChannels, jmax(0, activeInputs.getHighestBit() + 1 - settings.numInputChannels), false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange(settings.numOutputChannels, jmax(0, activeOutputs.getHighestBit() + 1 - settings.numOutputChannels), false);
+
+    inputs.setSize(jmax(1, activeInputs.countNumberOfSetBits()), bufferSize);
+    outputs.setSize(jmax(1, activeOutputs.countNumberOfSetBits()), bufferSize);
+    recording.setSize(jmin(2, outputs.getNumChannels()), (int) (settings.maxRecordSeconds * sampleRate));
+    recording.clear();
+
+    numRecorded = 0;
+    samplesPlayed = 0;
+    hostTimeNs = 0;
+    inputPhase = 0;
+    random.setSeed((int64) settings.seed);
+    silentRun = 0;
+    heardSound = false;
+    lastClick = -1;
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        previous[channel] = beforePrevious[channel] = 0.0f;
+    }
+
+    {
+        const ScopedLock sl(reportLock);
+        report = Report();
+        report.periodMs = bufferSize * 1000.0 / sampleRate;
+        totalCallbackMs = 0;
+    }
+
+    opened = true;
+    lastError.clear();
+    return {};
+}
+
+void VirtualAudioDevice::close()
+{
+    if (!opened)
+    {
+        return;
+    }
+
+    stop();
+    opened = false;
+    writeFiles();
+}
+
+bool VirtualAudioDevice::isOpen()
+{
+    return opened;
+}
+
+void VirtualAudioDevice::start(AudioIODeviceCallback* newCallback)
+{
+    if (!opened || newCallback == nullptr)
+    {
+        return;
+    }
+
+    stop();
+    newCallback->audioDeviceAboutToStart(this);
+    {
+        const ScopedLock sl(callbackLock);
+        callback = newCallback;
+    }
+
+    finished.reset();
+    playing = true;
+   #if JUCE_MAJOR_VERSION >= 7
+    startThread(Thread::Priority::highest);
+   #else
+    startThread(10);
+   #endif
+}
+
+void VirtualAudioDevice::stop()
+{
+    stopThread(5000);
+    playing = false;
+
+    AudioIODeviceCallback* oldCallback = nullptr;
+    {
+        const ScopedLock sl(callbackLock);
+        std::swap(oldCallback, callback);
+    }
+    if (oldCallback != nullptr)
+    {
+        oldCallback->audioDeviceStopped();
+    }
+}
+
+bool VirtualAudioDevice::isPlaying()
+{
+    return playing.load();
+}
+
+String VirtualAudioDevice::getLastError()
+{
+    return lastError;
+}
+
+int VirtualAudioDevice::getCurrentBufferSizeSamples()
+{
+    return bufferSize;
+}
+
+double VirtualAudioDevice::getCurrentSampleRate()
+{
+    return sampleRate;
+}
+
+int VirtualAudioDevice::getCurrentBitDepth()
+{
+    return 32;
+}
+
+BigInteger VirtualAudioDevice::getActiveOutputChannels() const
+{
+    return activeOutputs;
+}
+
+BigInteger VirtualAudioDevice::getActiveInputChannels() const
+{
+    return activeInputs;
+}
+
+int VirtualAudioDevice::getOutputLatencyInSamples()
+{
+    return bufferSize;
+}
+
+int VirtualAudioDevice::getInputLatencyInSamples()
+{
+    return bufferSize;
+}
+
+int VirtualAudioDevice::getXRunCount() const noexcept
+{
+    const ScopedLock sl(reportLock);
+    return report.missedDeadlines;
+}
+
+bool VirtualAudioDevice::waitUntilFinished(int timeoutMs)
+{
+    return finished.wait(timeoutMs);
+}
+
+VirtualAudioDevice::Report VirtualAudioDevice::getReport() const
+{
+    const ScopedLock sl(reportLock);
+    return report;
+}
+
+//==============================================================================
+void VirtualAudioDevice::run()
+{
+    const double periodMs = bufferSize * 1000.0 / sampleRate;
+    const double startMs = Time::getMillisecondCounterHiRes();
+
+    for (int64 block = 0; !threadShouldExit(); ++block)
+    {
+        if (settings.numBlocks > 0 && block >= settings.numBlocks)
+        {
+            break;
+        }
+
+        if (settings.realtime)
+        {
+            // sleep to the next period, then spin the last millisecond
+            const double due = startMs + (double) block * periodMs;
+            for (double now = Time::getMillisecondCounterHiRes(); now < due; now = Time::getMillisecondCounterHiRes())
+            {
+                if (due - now > 1.5)
+                {
+                    Thread::sleep((int) (due - now - 1.0));
+                }
+            }
+        }
+
+        renderBlock(block);
+    }
+
+    playing = false;
+    finished.signal();
+}
+
+void VirtualAudioDevice::renderBlock(int64 block)
+{
+    const double periodMs = bufferSize * 1000.0 / sampleRate;
+
+    // how late this one is woken, and how much of its time something else takes
+    const double lateMs = settings.jitterMs > 0 ? random.nextDouble() * settings.jitterMs : 0.0;
+    const bool spike = settings.spikeInterval > 0 && block > 0 && block % settings.spikeInterval == 0;
+    const double stolenMs = (spike ? settings.spikeLoad : settings.cpuLoad) * periodMs;
+
+    if (settings.realtime && lateMs > 0)
+    {
+        spin(lateMs);
+    }
+
+    // the inputs, a sine on every channel if asked for
+    if (settings.inputFrequency > 0)
+    {
+        const double delta = MathConstants<double>::twoPi * settings.inputFrequency / sampleRate;
+        for (int i = 0; i < bufferSize; ++i)
+        {
+            const float value = 0.5f * (float) std::sin(inputPhase + delta * i);
+            for (int channel = 0; channel < inputs.getNumChannels(); ++channel)
+            {
+                inputs.setSample(channel, i, value);
+            }
+        }
+        inputPhase = std::fmod(inputPhase + delta * bufferSize, MathConstants<double>::twoPi);
+    }
+    else
+    {
+        inputs.clear();
+    }
+    outputs.clear();
+
+    // offline the stolen time is only counted against the deadline below
+    if (settings.realtime)
+    {
+        spin(stolenMs);
+    }
+    const double callbackStart = Time::getMillisecondCounterHiRes();
+    {
+        const ScopedLock sl(callbackLock);
+        if (callback != nullptr)
+        {
+            const float* inputPointers[32] = {};
+            float* outputPointers[32] = {};
+            const int numInputs = jmin(32, activeInputs.countNumberOfSetBits());
+            const int numOutputs = jmin(32, activeOutputs.countNumberOfSetBits());
+            for (int channel = 0; channel < numInputs; ++channel)
+            {
+                inputPointers[channel] = inputs.getReadPointer(channel);
+            }
+            for (int channel = 0; channel < numOutputs; ++channel)
+            {
+                outputPointers[channel] = outputs.getWritePointer(channel);
+            }
+
+           #if JUCE_MAJOR_VERSION >= 7
+            // the simulated clock, where this block starts in the output
+            hostTimeNs = (uint64_t) ((double) samplesPlayed * 1.0e9 / sampleRate);
+            AudioIODeviceCallbackContext context;
+            context.hostTimeNs = &hostTimeNs;
+            callback->audioDeviceIOCallbackWithContext(inputPointers, numInputs, outputPointers, numOutputs,
+                                                       bufferSize, context);
+           #else
+            callback->audioDeviceIOCallback(inputPointers, numInputs, outputPointers, numOutputs, bufferSize);
+           #endif
+        }
+    }
+    const double callbackMs = Time::getMillisecondCounterHiRes() - callbackStart;
+
+    // the hardware ran dry for however long it was kept waiting
+    const double lateByMs = lateMs + stolenMs + callbackMs - periodMs;
+    const int silence = lateByMs > 0 ? jmin(bufferSize, (int) std::ceil(lateByMs * sampleRate / 1000.0)) : 0;
+
+    {
+        const ScopedLock sl(reportLock);
+        ++report.blocks;
+        totalCallbackMs += callbackMs;
+        report.averageCallbackMs = totalCallbackMs / (double) report.blocks;
+        report.worstCallbackMs = jmax(report.worstCallbackMs, callbackMs);
+        if (silence > 0)
+        {
+            ++report.missedDeadlines;
+            if (report.missedDeadlineSeconds.size() < maxGlitchTimes)
+            {
+                report.missedDeadlineSeconds.add(samplesPlayed / sampleRate);
+            }
+        }
+    }
+
+    if (silence > 0)
+    {
+        record(silence, true);
+    }
+    analyse(bufferSize, silence);
+    record(bufferSize, false);
+
+    samplesPlayed += silence + bufferSize;
+}
+
+void VirtualAudioDevice::analyse(int numSamples, int silenceBefore)
+{
+    const int numChannels = jmin(2, outputs.getNumChannels());
+    const int refractory = (int) (0.01 * sampleRate);
+    const int64 gapSamples = (int64) (settings.silenceGapMs * sampleRate / 1000.0);
+    int numClicks = 0, numGaps = 0;
+    Array<double> clickTimes, gapTimes;
+
+    // an underrun is heard as silence before the block
+    for (int i = -silenceBefore; i < numSamples; ++i)
+    {
+        const int64 time = samplesPlayed + silenceBefore + i;
+        float loudest = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float sample = i < 0 ? 0.0f : outputs.getSample(channel, i);
+            const float curvature = sample - 2.0f * previous[channel] + beforePrevious[channel];
+            if (heardSound && std::abs(curvature) > settings.clickThreshold && time - lastClick > refractory)
+            {
+                lastClick = time;
+                ++numClicks;
+                clickTimes.add(time / sampleRate);
+            }
+            beforePrevious[channel] = previous[channel];
+            previous[channel] = sample;
+            loudest = jmax(loudest, std::abs(sample));
+        }
+
+        if (loudest < settings.silenceLevel)
+        {
+            ++silentRun;
+        }
+        else
+        {
+            if (heardSound && silentRun >= gapSamples)
+            {
+                ++numGaps;
+                gapTimes.add((time - silentRun) / sampleRate);
+            }
+            heardSound = true;
+            silentRun = 0;
+        }
+    }
+
+    if (numClicks > 0 || numGaps > 0)
+    {
+        const ScopedLock sl(reportLock);
+        report.clicks += numClicks;
+        report.silenceGaps += numGaps;
+        for (int i = 0; i < clickTimes.size() && report.clickSeconds.size() < maxGlitchTimes; ++i)
+        {
+            report.clickSeconds.add(clickTimes[i]);
+        }
+        for (int i = 0; i < gapTimes.size() && report.silenceGapSeconds.size() < maxGlitchTimes; ++i)
+        {
+            report.silenceGapSeconds.add(gapTimes[i]);
+        }
+    }
+}
+
+void VirtualAudioDevice::record(int numSamples, bool silent)
+{
+    const int numToKeep = jmin(numSamples, recording.getNumSamples() - numRecorded);
+    if (numToKeep <= 0)
+    {
+        return;
+    }
+
+    for (int channel = 0; channel < recording.getNumChannels(); ++channel)
+    {
+        if (silent)
+        {
+            recording.clear(channel, numRecorded, numToKeep);
+        }
+        else
+        {
+            recording.copyFrom(channel, numRecorded, outputs, channel, 0, numToKeep);
+        }
+    }
+    numRecorded += numToKeep;
+}
+
+void VirtualAudioDevice::spin(double ms) const
+{
+    if (ms <= 0)
+    {
+        return;
+    }
+
+    // busy, like another process holding the core, rather than asleep
+    const int64 end = Time::getHighResolutionTicks() + Time::secondsToHighResolutionTicks(ms / 1000.0);
+    while (Time::getHighResolutionTicks() < end)
+    {
+    }
+}
+
+void VirtualAudioDevice::writeFiles() const
+{
+    if (settings.recordingFile != File() && numRecorded > 0)
+    {
+        settings.recordingFile.deleteFile();
+        WavAudioFormat wav;
+        auto* stream = new FileOutputStream(settings.recordingFile);
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(stream, sampleRate, (unsigned int) recording.getNumChannels(),
+                                                                      24, {}, 0));
+        if (writer != nullptr)
+        {
+            writer->writeFromAudioSampleBuffer(recording, 0, numRecorded);
+        }
+        else
+        {
+            delete stream;
+        }
+    }
+
+    const Report finalReport = getReport();
+    if (settings.reportFile != File())
+    {
+        settings.reportFile.replaceWithText(JSON::toString(finalReport.toJSON()));
+    }
+
+    // two lines, one would be cut at RealtimeLog::maxLength
+    RealtimeLog::write(RealtimeLog::info, "VirtualAudioDevice::writeFiles %lld blocks of %.2f ms, callback avg %.3f ms, worst %.3f ms",
+                       (long long) finalReport.blocks, finalReport.periodMs,
+                       finalReport.averageCallbackMs, finalReport.worstCallbackMs);
+    RealtimeLog::write(RealtimeLog::info, "VirtualAudioDevice::writeFiles %d missed deadlines, %d clicks, %d silence gaps",
+                       finalReport.missedDeadlines, finalReport.clicks, finalReport.silenceGaps);
+}
+
+//==============================================================================
+const char* const VirtualAudioDeviceType::typeName = "Virtual";
+const char* const VirtualAudioDeviceType::deviceName = "Virtual device";
+
+VirtualAudioDeviceType::VirtualAudioDeviceType(const VirtualAudioDevice::Settings& settingsToUse)
+    : AudioIODeviceType(typeName),
+      settings(settingsToUse)
+{
+}
+
+StringArray VirtualAudioDeviceType::getDeviceNames(bool) const
+{
+    return StringArray(String(deviceName));
+}
+
+int VirtualAudioDeviceType::getDefaultDeviceIndex(bool) const
+{
+    return 0;
+}
+
+int VirtualAudioDeviceType::getIndexOfDevice(AudioIODevice* device, bool) const
+{
+    return dynamic_cast<VirtualAudioDevice*>(device) != nullptr ? 0 : -1;
+}
+
+AudioIODevice* VirtualAudioDeviceType::createDevice(const String& outputDeviceName, const String& inputDeviceName)
+{
+    if (outputDeviceName == deviceName || inputDeviceName == deviceName
+        || (outputDeviceName.isEmpty() && inputDeviceName.isEmpty()))
+    {
+        return new VirtualAudioDevice(deviceName, settings);
+    }
+    return nullptr;
+}
+
+bool VirtualAudioDeviceType::parseCommandLine(const StringArray& args, VirtualAudioDevice::Settings& settings)
+{
+    if (!args.contains("--virtual-audio"))
+    {
+        return false;
+    }
+
+    auto valueAfter = [&args](const String& option, int offset = 1) -> String
+    {
+        const int index = args.indexOf(option);
+        return index >= 0 ? args[index + offset] : String();
+    };
+
+    if (args.contains("--buffer"))
+    {
+        settings.bufferSize = jmax(16, valueAfter("--buffer").getIntValue());
+    }
+    if (args.contains("--rate"))
+    {
+        settings.sampleRate = jmax(8000.0, valueAfter("--rate").getDoubleValue());
+    }
+    if (args.contains("--outputs"))
+    {
+        settings.numOutputChannels = jlimit(1, 32, valueAfter("--outputs").getIntValue());
+    }
+    if (args.contains("--jitter"))
+    {
+        settings.jitterMs = jmax(0.0, valueAfter("--jitter").getDoubleValue());
+    }
+    if (args.contains("--load"))
+    {
+        settings.cpuLoad = jlimit(0.0, 2.0, valueAfter("--load").getDoubleValue());
+    }
+    if (args.contains("--spike"))
+    {
+        settings.spikeInterval = jmax(0, valueAfter("--spike").getIntValue());
+        settings.spikeLoad = jlimit(0.0, 2.0, valueAfter("--spike", 2).getDoubleValue());
+    }
+    if (args.contains("--sine"))
+    {
+        settings.inputFrequency = jmax(0.0, valueAfter("--sine").getDoubleValue());
+    }
+    if (args.contains("--blocks"))
+    {
+        settings.numBlocks = jmax((int64) 0, valueAfter("--blocks").getLargeIntValue());
+    }
+    if (args.contains("--seed"))
+    {
+        settings.seed = (uint32) valueAfter("--seed").getLargeIntValue();
+    }
+    if (args.contains("--record"))
+    {
+        settings.recordingFile = File::getCurrentWorkingDirectory().getChildFile(valueAfter("--record"));
+    }
+    if (args.contains("--report"))
+    {
+        settings.reportFile = File::getCurrentWorkingDirectory().getChildFile(valueAfter("--report"));
+    }
+
+    // in the app the device is paced like hardware unless asked otherwise
+    settings.realtime = !args.contains("--offline");
+    return true;
+}
+
+std::unique_ptr<XmlElement> VirtualAudioDeviceType::createDeviceSetup(const VirtualAudioDevice::Settings& settings)
+{
+    auto xml = std::make_unique<XmlElement>("DEVICESETUP");
+    xml->setAttribute("deviceType", typeName);
+    xml->setAttribute("audioOutputDeviceName", deviceName);
+    xml->setAttribute("audioInputDeviceName", deviceName);
+    xml->setAttribute("audioDeviceRate", settings.sampleRate);
+    xml->setAttribute("audioDeviceBufferSize", settings.bufferSize);
+    return xml;
+}
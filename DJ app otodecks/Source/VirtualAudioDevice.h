@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    VirtualAudioDevice.h
+    Created: 20 Oct 2026 10:02:37am
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A sound card that isn't there, for reproducing glitches without hardware.
+
+    Callbacks are driven on a simulated clock, either paced like a real device
+    or back to back as fast as the machine can go. Each one has a period's
+    worth of time to finish, less some random lateness in waking up (jitter)
+    and less any CPU time stolen before it (load). A callback that takes
+    longer than that has missed its deadline, and the gap is written into the
+    recording as silence, the way the hardware would have played it.
+
+    Everything played is recorded and checked for clicks (sudden jumps in the
+    waveform) and gaps of silence in the middle of the sound. The jitter comes
+    from a seeded random generator, so a run can be repeated exactly.
+*/
+class VirtualAudioDevice : public AudioIODevice,
+                           private Thread
+{
+public:
+    struct Settings
+    {
+        double sampleRate = 44100.0;
+        int bufferSize = 512;
+        int numInputChannels = 2;
+        int numOutputChannels = 2;
+
+        // up to this much later than the period boundary each callback starts
+        double jitterMs = 0;
+
+        // the share of every period taken by something else before the
+        // callback, and a bigger share every spikeInterval blocks
+        double cpuLoad = 0;
+        int spikeInterval = 0;
+        double spikeLoad = 0;
+
+        // paced to the wall clock like hardware, or back to back
+        bool realtime = false;
+
+        // stops by itself after this many blocks, 0 to run until stopped
+        int64 numBlocks = 0;
+
+        // a sine on every input, 0 for silence
+        double inputFrequency = 0;
+
+        uint32 seed = 1;
+
+        // the output is kept in memory for up to this long, and written to
+        // recordingFile as a WAV when the device closes if one is given. The
+        // report goes to reportFile as JSON
+        double maxRecordSeconds = 60.0;
+        File recordingFile;
+        File reportFile;
+
+        // a change in slope bigger than this between two samples is a click
+        float clickThreshold = 0.1f;
+
+        // silence at least this long, after sound and before more, is a gap
+        double silenceGapMs = 10.0;
+        float silenceLevel = 0.0001f;
+    };
+
+    struct Report
+    {
+        int64 blocks = 0;
+        double periodMs = 0;
+        double averageCallbackMs = 0;
+        double worstCallbackMs = 0;
+        int missedDeadlines = 0;
+        int clicks = 0;
+        int silenceGaps = 0;
+
+        // when the first few glitches of each kind were, in seconds of output
+        Array<double> missedDeadlineSeconds;
+        Array<double> clickSeconds;
+        Array<double> silenceGapSeconds;
+
+        bool isClean() const { return missedDeadlines == 0 && clicks == 0 && silenceGaps == 0; }
+        var toJSON() const;
+    };
+
+    VirtualAudioDevice(const String& deviceName, const Settings& settingsToUse);
+    ~VirtualAudioDevice() override;
+
+    // implement AudioIODevice
+    StringArray getOutputChannelNames() override;
+    StringArray getInputChannelNames() override;
+    Array<double> getAvailableSampleRates() override;
+    Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override;
+    String open(const BigInteger& inputChannels, const BigInteger& outputChannels,
+                double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override;
+    void start(AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override;
+    String getLastError() override;
+    int getCurrentBufferSizeSamples() override;
+    double getCurrentSampleRate() override;
+    int getCurrentBitDepth() override;
+    BigInteger getActiveOutputChannels() const override;
+    BigInteger getActiveInputChannels() const override;
+    int getOutputLatencyInSamples() override;
+    int getInputLatencyInSamples() override;
+    int getXRunCount() const noexcept override;
+
+    // once numBlocks have been played, false if it timed out
+    bool waitUntilFinished(int timeoutMs);
+
+    // so far. Any thread
+    Report getReport() const;
+
+    // what was played, up to maxRecordSeconds. Only while stopped
+    const AudioBuffer<float>& getRecording() const { return recording; }
+    int getNumSamplesRecorded() const { return numRecorded; }
+
+private:
+    /** implement Thread, the device's clock */
+    void run() override;
+
+    void renderBlock(int64 block);
+    void analyse(int numSamples, int silenceBefore);
+    void record(int numSamples, bool silent);
+    void spin(double ms) const;
+    void writeFiles() const;
+
+    Settings settings;
+    double sampleRate;
+    int bufferSize;
+    BigInteger activeInputs, activeOutputs;
+    bool opened = false;
+    String lastError;
+
+    CriticalSection callbackLock;
+    AudioIODeviceCallback* callback = nullptr;
+    std::atomic<bool> playing{ false };
+    WaitableEvent finished{ true };
+
+    // device thread only
+    AudioBuffer<float> inputs, outputs;
+    Random random;
+    double inputPhase = 0;
+    int64 samplesPlayed = 0;
+    uint64_t hostTimeNs = 0;
+
+    AudioBuffer<float> recording;
+    int numRecorded = 0;
+
+    // click and gap detection, carried across blocks
+    float previous[2] = {}, beforePrevious[2] = {};
+    int64 lastClick = -1;
+    int64 silentRun = 0;
+    bool heardSound = false;
+
+    mutable CriticalSection reportLock;
+    Report report;
+    double totalCallbackMs = 0;
+
+    static constexpr int maxGlitchTimes = 32;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioDevice)
+};
+
+//==============================================================================
+/*
+    Puts a VirtualAudioDevice in the AudioDeviceManager's list, under its own
+    type, so it can stand in for the sound card.
+*/
+class VirtualAudioDeviceType : public AudioIODeviceType
+{
+public:
+    static const char* const typeName;
+    static const char* const deviceName;
+
+    VirtualAudioDeviceType(const VirtualAudioDevice::Settings& settingsToUse);
+
+    // implement AudioIODeviceType
+    void scanForDevices() override {}
+    StringArray getDeviceNames(bool wantInputNames) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    AudioIODevice* createDevice(const String& outputDeviceName, const String& inputDeviceName) override;
+
+    // --virtual-audio, with optional --buffer N, --rate HZ, --outputs N,
+    // --jitter MS, --load 0.3, --spike EVERY SHARE, --sine HZ, --offline,
+    // --blocks N, --seed N, --record FILE and --report FILE. False if it isn't there
+    static bool parseCommandLine(const StringArray& args, VirtualAudioDevice::Settings& settings);
+
+    // saved device state that makes AudioDeviceManager::initialise pick the virtual device
+    static std::unique_ptr<XmlElement> createDeviceSetup(const VirtualAudioDevice::Settings& settings);
+
+private:
+    VirtualAudioDevice::Settings settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioDeviceType)
+};
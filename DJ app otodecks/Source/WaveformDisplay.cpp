@@ -10,17 +10,15 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "WaveformDisplay.h"
+#include "RealtimeLog.h"
 
 //==============================================================================
-WaveformDisplay::WaveformDisplay(AudioFormatManager & 	formatManagerToUse,
-                                 AudioThumbnailCache & 	cacheToUse) :
-                                 audioThumb(1000, formatManagerToUse, cacheToUse), 
+WaveformDisplay::WaveformDisplay(TrackDecoder & 	decoderToUse) :
+                                 decoder(decoderToUse),
                                  fileLoaded(false), 
                                  position(0)
                           
 {
-
-  audioThumb.addChangeListener(this);
 }
 
 WaveformDisplay::~WaveformDisplay()
@@ -38,13 +36,11 @@ void WaveformDisplay::paint (Graphics& g)
     g.setColour (Colours::orange);
     if(fileLoaded)
     {
-      audioThumb.drawChannel(g, 
-        getLocalBounds(), 
-        0, 
-        audioThumb.getTotalLength(), 
-        0, 
-        1.0f
-      );
+      if (waveformImage.isNull() || waveformImage.getWidth() != getWidth() || waveformImage.getHeight() != getHeight())
+      {
+        renderWaveform();
+      }
+      g.drawImageAt(waveformImage, 0, 0);
       g.setColour(Colours::orangered);
       g.drawRect(position * getWidth(), 0, getWidth() / 20, getHeight());
     }
@@ -66,25 +62,112 @@ void WaveformDisplay::resized()
 
 void WaveformDisplay::loadURL(URL audioURL)
 {
-  audioThumb.clear();
-  fileLoaded  = audioThumb.setSource(new URLInputSource(audioURL));
+  // the deck has normally opened this already, so the peaks come from its decode.
+  // A remote track may still be connecting, it is shown once it is in
+  const int load = ++loadsRequested;
+  Component::SafePointer<WaveformDisplay> display(this);
+  decoder.openAsync(audioURL, [display, load](DecodedTrack::Ptr track)
+  {
+    if (display != nullptr && load == display->loadsRequested)
+    {
+      display->showTrack(track);
+    }
+  });
+}
+
+void WaveformDisplay::showTrack(DecodedTrack::Ptr track)
+{
+  peaks = track != nullptr ? track->getPeaks() : nullptr;
+  blocksDrawn = 0;
+  waveformImage = Image();
+
+  fileLoaded = peaks != nullptr;
   if (fileLoaded)
   {
-    std::cout << "wfd: loaded! " << std::endl;
-    repaint();
+    RealtimeLog::write(RealtimeLog::debug, "wfd: loaded!");
+    startTimerHz(20);
   }
   else {
-    std::cout << "wfd: not loaded! " << std::endl;
+    RealtimeLog::write(RealtimeLog::debug, "wfd: not loaded!");
+    stopTimer();
   }
-
+  repaint();
 }
 
-void WaveformDisplay::changeListenerCallback (ChangeBroadcaster *source)
+void WaveformDisplay::timerCallback()
 {
-    std::cout << "wfd: change received! " << std::endl;
+  if (peaks == nullptr)
+  {
+    stopTimer();
+    return;
+  }
 
+  // only redrawn when the decoder has got further
+  const int ready = peaks->getNumBlocksReady();
+  if (ready != blocksDrawn)
+  {
+    renderWaveform();
     repaint();
+  }
+
+  if (peaks->isComplete())
+  {
+    stopTimer();
+  }
+}
 
+void WaveformDisplay::renderWaveform()
+{
+  const int width = jmax(1, getWidth());
+  const int height = jmax(1, getHeight());
+  waveformImage = Image(Image::ARGB, width, height, true);
+
+  if (peaks == nullptr)
+  {
+    return;
+  }
+
+  blocksDrawn = peaks->getNumBlocksReady();
+
+  Graphics g(waveformImage);
+  const int numBlocks = peaks->getNumBlocks();
+  const float centre = height * 0.5f;
+
+  for (int x = 0; x < width; ++x)
+  {
+    const int first = (int) ((int64) x * numBlocks / width);
+    const int last = jmax(first + 1, (int) ((int64) (x + 1) * numBlocks / width));
+
+    float minimum = 0, maximum = 0;
+    float low = 0, mid = 0, high = 0;
+    int numReady = 0;
+
+    for (int i = first; i < last && i < numBlocks; ++i)
+    {
+      if (!peaks->isBlockReady(i))
+      {
+        continue;
+      }
+      const WaveformPeaks::Block& block = peaks->getBlock(i);
+      minimum = jmin(minimum, block.minimum);
+      maximum = jmax(maximum, block.maximum);
+      low += block.low;
+      mid += block.mid;
+      high += block.high;
+      ++numReady;
+    }
+
+    if (numReady == 0)
+    {
+      continue;
+    }
+
+    g.setColour(WaveformPeaks::getColour(low, mid, high));
+
+    const float top = centre - jlimit(0.0f, 1.0f, maximum) * centre;
+    const float bottom = centre - jlimit(-1.0f, 0.0f, minimum) * centre;
+    g.fillRect((float) x, top, 1.0f, jmax(1.0f, bottom - top));
+  }
 }
 
 void WaveformDisplay::setPositionRelative(double pos)
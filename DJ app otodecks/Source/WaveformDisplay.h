@@ -11,30 +11,48 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "TrackDecoder.h"
 
 //==============================================================================
 /*
+    The track overview, coloured by how much low (red), mid (green) and high
+    (blue) energy each part has.
 */
 class WaveformDisplay    : public Component, 
-                           public ChangeListener
+                           private Timer
 {
 public:
-    WaveformDisplay( AudioFormatManager & 	formatManagerToUse,
-                    AudioThumbnailCache & 	cacheToUse );
+    WaveformDisplay( TrackDecoder & 	decoderToUse );
     ~WaveformDisplay();
 
     void paint (Graphics&) override;
     void resized() override;
 
-    void changeListenerCallback (ChangeBroadcaster *source) override;
-
     void loadURL(URL audioURL);
 
     // set the relative position of the playhead
     void setPositionRelative(double pos);
 
 private:
-    AudioThumbnail audioThumb;
+    /** implement Timer, picks up peaks as the decoder works them out */
+    void timerCallback() override;
+
+    // draws the peaks into the cached image, one column per pixel
+    void renderWaveform();
+
+    // once the decoder has the track, nullptr if it couldn't be read
+    void showTrack(DecodedTrack::Ptr track);
+
+    TrackDecoder& decoder;
+    WaveformPeaks::Ptr peaks;
+    int blocksDrawn = 0;
+
+    // a remote track that is still connecting is dropped if another is loaded meanwhile
+    int loadsRequested = 0;
+
+    // redrawn only when the peaks or the size change, not for every playhead move
+    Image waveformImage;
+
     bool fileLoaded; 
     double position;
     
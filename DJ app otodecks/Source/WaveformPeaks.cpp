@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    WaveformPeaks.cpp
+    Created: 19 Oct 2026 11:52:08pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#include "WaveformPeaks.h"
+
+namespace
+{
+    // band edges in Hz, roughly kick and bass / vocals and snare / hats and air
+    const double lowBandTop = 200.0;
+    const double midBandTop = 2500.0;
+}
+
+//==============================================================================
+WaveformPeaks::WaveformPeaks(int64 lengthInSamples)
+    : numBlocks((int) ((lengthInSamples + samplesPerBlock - 1) / samplesPerBlock)),
+      blocks((size_t) numBlocks, true),
+      ready(new std::atomic<bool>[(size_t) numBlocks])
+{
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        ready[i] = false;
+    }
+}
+
+//==============================================================================
+WaveformPeaks::Analyser::Analyser(double sampleRate)
+    : window((size_t) fftSize),
+      mono((size_t) fftSize),
+      fftData((size_t) fftSize * 2)
+{
+    dsp::WindowingFunction<float>::fillWindowingTables(window, (size_t) fftSize,
+                                                       dsp::WindowingFunction<float>::hann, false);
+
+    const double binWidth = sampleRate / fftSize;
+    lowEnd = jlimit(1, fftSize / 2, roundToInt(lowBandTop / binWidth));
+    midEnd = jlimit(lowEnd + 1, fftSize / 2, roundToInt(midBandTop / binWidth));
+}
+
+Colour WaveformPeaks::getColour(float low, float mid, float high)
+{
+    const float brightest = jmax(low, mid, high, 1.0f);
+    return Colour::fromFloatRGBA(low / brightest, mid / brightest, high / brightest, 1.0f);
+}
+
+//==============================================================================
+void WaveformPeaks::Analyser::process(const AudioBuffer<float>& source, int sourceStart, int64 trackStart,
+                                      int numSamples, WaveformPeaks& peaks)
+{
+    jassert(trackStart % samplesPerBlock == 0);
+
+    const int numChannels = source.getNumChannels();
+
+    for (int offset = 0; offset < numSamples; offset += samplesPerBlock)
+    {
+        const int blockIndex = (int) ((trackStart + offset) / samplesPerBlock);
+        if (blockIndex >= peaks.numBlocks)
+        {
+            break;
+        }
+
+        const int num = jmin(samplesPerBlock, numSamples - offset);
+        const int blockStart = sourceStart + offset;
+
+        // mono mix, padded with silence at the end of the track
+        FloatVectorOperations::copy(mono, source.getReadPointer(0, blockStart), num);
+        if (numChannels > 1)
+        {
+            FloatVectorOperations::add(mono, source.getReadPointer(1, blockStart), num);
+            FloatVectorOperations::multiply(mono, 0.5f, num);
+        }
+        FloatVectorOperations::clear(mono + num, fftSize - num);
+
+        Block& block = peaks.blocks[blockIndex];
+        const auto range = FloatVectorOperations::findMinAndMax(mono, num);
+        block.minimum = range.getStart();
+        block.maximum = range.getEnd();
+
+        FloatVectorOperations::multiply(fftData, mono, window, fftSize);
+        FloatVectorOperations::clear(fftData + fftSize, fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftData);
+
+        // energy per band. The sums are plain loops over contiguous bins, which
+        // the compiler vectorises
+        float bands[3] = { 0, 0, 0 };
+        for (int bin = 1; bin < lowEnd; ++bin)
+        {
+            bands[0] += fftData[bin] * fftData[bin];
+        }
+        for (int bin = lowEnd; bin < midEnd; ++bin)
+        {
+            bands[1] += fftData[bin] * fftData[bin];
+        }
+        for (int bin = midEnd; bin < fftSize / 2; ++bin)
+        {
+            bands[2] += fftData[bin] * fftData[bin];
+        }
+
+        // as levels relative to the loudest band, so the colour says what
+        // the block is made of and the height says how loud it is
+        for (float& band : bands)
+        {
+            band = std::sqrt(band);
+        }
+        const float loudest = jmax(bands[0], bands[1], bands[2]);
+        const float scale = loudest > 0 ? 255.0f / loudest : 0.0f;
+
+        block.low = (uint8) roundToInt(bands[0] * scale);
+        block.mid = (uint8) roundToInt(bands[1] * scale);
+        block.high = (uint8) roundToInt(bands[2] * scale);
+
+        if (!peaks.ready[blockIndex].exchange(true))
+        {
+            ++peaks.numReady;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    WaveformPeaks.h
+    Created: 19 Oct 2026 11:52:08pm
+    Author:  kavya
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The overview of a track: for every block of samples, the peaks and how
+    much of its energy is in the lows, mids and highs, for colouring the
+    waveform. Filled in by the decoder as each part of the track is decoded,
+    and read by the waveform display.
+*/
+class WaveformPeaks : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<WaveformPeaks>;
+
+    struct Block
+    {
+        float minimum;
+        float maximum;
+
+        // level of each band relative to the loudest one, 0-255
+        uint8 low, mid, high;
+    };
+
+    WaveformPeaks(int64 lengthInSamples);
+
+    int getNumBlocks() const { return numBlocks; }
+    int getNumBlocksReady() const { return numReady.load(); }
+    bool isComplete() const { return getNumBlocksReady() >= numBlocks; }
+
+    bool isBlockReady(int block) const { return ready[block].load(); }
+    const Block& getBlock(int block) const { return blocks[block]; }
+
+    // red for lows, green for mids, blue for highs, with the loudest at full brightness
+    static Colour getColour(float low, float mid, float high);
+
+    // small enough to show kicks, big enough for a useful low band
+    static constexpr int samplesPerBlock = 1024;
+
+    //==============================================================================
+    /*
+        Works out the blocks for a stretch of audio with an FFT per block. One
+        per decoding thread, it keeps its own buffers.
+    */
+    class Analyser
+    {
+    public:
+        Analyser(double sampleRate);
+
+        // numSamples of source from sourceStart, which are trackStart samples into
+        // the track. trackStart has to be on a block boundary
+        void process(const AudioBuffer<float>& source, int sourceStart, int64 trackStart, int numSamples,
+                     WaveformPeaks& peaks);
+
+    private:
+        static constexpr int fftOrder = 10;
+        static constexpr int fftSize = 1 << fftOrder;
+
+        dsp::FFT fft{ fftOrder };
+        HeapBlock<float> window, mono, fftData;
+
+        // last bin of the low and mid bands
+        int lowEnd, midEnd;
+    };
+
+private:
+    int numBlocks;
+    HeapBlock<Block> blocks;
+    std::unique_ptr<std::atomic<bool>[]> ready;
+    std::atomic<int> numReady{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPeaks)
+};